@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+# Decodes a binary trace written by 'log.trace.dump' into text.
+#
+# Usage:
+# trace_decode.py trace.bin [-e event]...
+#
+# The dump is in the byte order of the machine that wrote it, decode
+# it on the same kind of machine.
+
+import argparse
+import datetime
+import struct
+import sys
+
+MAGIC = b"RTTRACE\0"
+HEADER = struct.Struct("=8sIIIIQQ")
+
+ARG_NAMES = {
+    "rpc_read": ("fd", "size", "type"),
+    "rpc_write": ("fd", "size"),
+    "execute": ("status", "usec"),
+    "download_resume": ("hash", "flags"),
+    "download_pause": ("hash", "flags"),
+    "download_hash": ("hash", "checked"),
+    "download_finished": ("hash",),
+    "stall": ("usec", "task_usec"),
+}
+
+
+def read_names(data, offset, count):
+    names = []
+
+    for _ in range(count):
+        end = data.index(b"\0", offset)
+        names.append(data[offset:end].decode())
+        offset = end + 1
+
+    return names, offset
+
+
+def format_arg(key, value):
+    if key == "hash":
+        return "%s=%s" % (key, struct.pack("=q", value).hex().upper())
+
+    return "%s=%i" % (key, value)
+
+
+def decode(data, only):
+    magic, version, record_size, max_args, event_count, count, position = (
+        HEADER.unpack_from(data, 0))
+
+    if magic != MAGIC:
+        sys.exit("not an rtorrent trace dump")
+    if version != 1:
+        sys.exit("unsupported trace version %i" % version)
+
+    names, offset = read_names(data, HEADER.size, event_count)
+    record = struct.Struct("=QII%iq" % max_args)
+
+    if record.size != record_size:
+        sys.exit("unexpected record size %i" % record_size)
+
+    print("# %i records, %i written in total" % (count, position))
+
+    for i in range(count):
+        fields = record.unpack_from(data, offset + i * record_size)
+        usec, event, thread, args = fields[0], fields[1], fields[2], fields[3:]
+
+        name = names[event] if event < len(names) else "unknown_%i" % event
+
+        if only and name not in only:
+            continue
+
+        keys = ARG_NAMES.get(name, ())
+        text = [format_arg(k, v) for k, v in zip(keys, args)]
+        text += ["%i" % v for v in args[len(keys):] if v != 0]
+
+        stamp = datetime.datetime.fromtimestamp(usec / 1000000.0)
+        print("%s.%06i t%i %s %s" % (stamp.strftime("%Y-%m-%d %H:%M:%S"),
+                                     usec % 1000000, thread, name,
+                                     " ".join(text)))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode an rtorrent trace dump.")
+    parser.add_argument("file")
+    parser.add_argument("-e", "--event", action="append", default=[],
+                        help="only print these events")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as f:
+        decode(f.read(), set(args.event))
+
+
+if __name__ == "__main__":
+    main()
@@ -43,6 +43,8 @@ namespace torrent {
 class directory_events;
 }
 
+class ThreadQueue;
+
 class Control {
 public:
   Control();
@@ -104,6 +106,12 @@ public:
     return m_directory_events;
   }
 
+  // Closures queued here by other threads are called from the main
+  // thread's poll, holding the global lock.
+  ThreadQueue* main_queue() {
+    return m_mainQueue;
+  }
+
   uint64_t tick() const {
     return m_tick;
   }
@@ -136,6 +144,7 @@ private:
   rpc::CommandScheduler*     m_commandScheduler;
   rpc::object_storage*       m_objectStorage;
   torrent::directory_events* m_directory_events;
+  ThreadQueue*               m_mainQueue;
 
   uint64_t m_tick{ 0 };
 
@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#ifndef RTORRENT_CORE_ADDRESS_TRIE_H
+#define RTORRENT_CORE_ADDRESS_TRIE_H
+
+#include <algorithm>
+#include <cinttypes>
+#include <vector>
+
+struct sockaddr;
+
+namespace core {
+
+// A 128 bit address, with IPv4 addresses mapped into ::ffff:0:0/96 so
+// that both families share a single key space.
+struct AddressKey {
+  static constexpr unsigned int bits      = 128;
+  static constexpr unsigned int ipv4_bits = 96;
+
+  uint64_t high{ 0 };
+  uint64_t low{ 0 };
+
+  static AddressKey from_ipv4(uint32_t addr);
+  static AddressKey from_ipv6(const uint8_t* addr);
+
+  // Returns false for address families other than IPv4 and IPv6.
+  static bool from_sockaddr(const sockaddr* sa, AddressKey* key);
+
+  bool is_ipv4() const {
+    return high == 0 && (low >> 32) == 0xffff;
+  }
+
+  bool bit(unsigned int index) const {
+    return index < 64 ? (high >> (63 - index)) & 1 : (low >> (127 - index)) & 1;
+  }
+
+  // Clear, or set, all but the first 'length' bits.
+  AddressKey masked(unsigned int length) const;
+  AddressKey filled(unsigned int length) const;
+
+  // Number of leading bits shared with the other key.
+  unsigned int common_length(const AddressKey& other) const;
+
+  bool operator==(const AddressKey& other) const {
+    return high == other.high && low == other.low;
+  }
+  bool operator!=(const AddressKey& other) const {
+    return !(*this == other);
+  }
+  bool operator<(const AddressKey& other) const {
+    return high < other.high || (high == other.high && low < other.low);
+  }
+};
+
+// Split the inclusive range [first, last] into the smallest set of
+// prefixes covering it, calling slot(prefix, length) for each.
+template<typename Slot>
+void
+address_range_to_prefixes(AddressKey first, const AddressKey& last, Slot slot);
+
+// Longest prefix match over a path compressed binary trie. Lookups
+// visit at most one node per address bit, independent of the number of
+// prefixes stored.
+//
+// Unlike RangeMap, overlapping prefixes don't overwrite each other;
+// the most specific prefix containing the address wins, and inserting
+// the same prefix again replaces its value.
+template<typename T>
+class AddressTrie {
+public:
+  using value_type = T;
+
+  bool empty() const {
+    return m_size == 0;
+  }
+  // Number of prefixes stored.
+  size_t size() const {
+    return m_size;
+  }
+  size_t node_count() const {
+    return m_nodes.size();
+  }
+
+  void clear() {
+    m_nodes.clear();
+    m_size = 0;
+  }
+
+  void insert(const AddressKey& prefix, unsigned int length, const T& value);
+  void insert_range(const AddressKey& first,
+                    const AddressKey& last,
+                    const T&          value);
+
+  // Returns nullptr if no prefix contains the address.
+  const T* find(const AddressKey& addr) const;
+
+  T get(const AddressKey& addr, const T& def) const {
+    const T* value = find(addr);
+    return value != nullptr ? *value : def;
+  }
+
+private:
+  static constexpr uint32_t node_none = ~uint32_t();
+
+  struct node_type {
+    AddressKey   prefix;
+    unsigned int length;
+    bool         has_value;
+    T            value;
+    uint32_t     child[2];
+  };
+
+  uint32_t new_node(const AddressKey& prefix, unsigned int length);
+
+  // Index 0 is the root once anything is inserted. Nodes are never
+  // removed, so indices stay valid as the vector grows.
+  std::vector<node_type> m_nodes;
+  size_t                 m_size{ 0 };
+};
+
+template<typename T>
+uint32_t
+AddressTrie<T>::new_node(const AddressKey& prefix, unsigned int length) {
+  m_nodes.push_back(node_type{
+    prefix.masked(length), length, false, T(), { node_none, node_none } });
+  return m_nodes.size() - 1;
+}
+
+template<typename T>
+void
+AddressTrie<T>::insert(const AddressKey& prefix,
+                       unsigned int      length,
+                       const T&          value) {
+  length = std::min(length, AddressKey::bits);
+
+  if (m_nodes.empty())
+    new_node(AddressKey(), 0);
+
+  // The root has length zero and always matches, so every other node
+  // we visit has a parent.
+  uint32_t parent = node_none;
+  uint32_t index  = 0;
+
+  while (index != node_none) {
+    unsigned int nodeLength = m_nodes[index].length;
+    unsigned int common     = std::min(
+      std::min(length, nodeLength),
+      prefix.common_length(m_nodes[index].prefix));
+
+    if (common < nodeLength) {
+      // The new prefix diverges from this node, so insert either the
+      // new prefix itself or a branch node in between.
+      uint32_t split = new_node(prefix, common);
+
+      m_nodes[split].child[m_nodes[index].prefix.bit(common)] = index;
+      m_nodes[parent].child[prefix.bit(m_nodes[parent].length)] = split;
+
+      if (common == length) {
+        index = split;
+        break;
+      }
+
+      parent = split;
+      index  = node_none;
+      break;
+    }
+
+    if (length == nodeLength)
+      break;
+
+    parent = index;
+    index  = m_nodes[index].child[prefix.bit(nodeLength)];
+  }
+
+  if (index == node_none) {
+    index = new_node(prefix, length);
+    m_nodes[parent].child[prefix.bit(m_nodes[parent].length)] = index;
+  }
+
+  m_size += !m_nodes[index].has_value;
+  m_nodes[index].has_value = true;
+  m_nodes[index].value     = value;
+}
+
+template<typename T>
+void
+AddressTrie<T>::insert_range(const AddressKey& first,
+                             const AddressKey& last,
+                             const T&          value) {
+  address_range_to_prefixes(
+    first, last, [this, &value](const AddressKey& prefix, unsigned int length) {
+      insert(prefix, length, value);
+    });
+}
+
+template<typename T>
+const T*
+AddressTrie<T>::find(const AddressKey& addr) const {
+  const T* result = nullptr;
+  uint32_t index  = m_nodes.empty() ? node_none : 0;
+
+  while (index != node_none) {
+    const node_type& node = m_nodes[index];
+
+    if (node.length != 0 && addr.masked(node.length) != node.prefix)
+      break;
+
+    if (node.has_value)
+      result = &node.value;
+
+    if (node.length == AddressKey::bits)
+      break;
+
+    index = node.child[addr.bit(node.length)];
+  }
+
+  return result;
+}
+
+template<typename Slot>
+void
+address_range_to_prefixes(AddressKey first, const AddressKey& last, Slot slot) {
+  while (!(last < first)) {
+    // Host bits available from the alignment of 'first'.
+    unsigned int align = 0;
+
+    while (align < AddressKey::bits &&
+           !first.bit(AddressKey::bits - 1 - align))
+      align++;
+
+    // Shrink the block until it doesn't extend past 'last'.
+    unsigned int hostBits = align;
+
+    while (hostBits > 0 && last < first.filled(AddressKey::bits - hostBits))
+      hostBits--;
+
+    slot(first, AddressKey::bits - hostBits);
+
+    // Advance past the block, stopping on wrap around.
+    AddressKey end = first.filled(AddressKey::bits - hostBits);
+
+    if (end.high == ~uint64_t() && end.low == ~uint64_t())
+      return;
+
+    first.low  = end.low + 1;
+    first.high = end.high + (first.low == 0);
+  }
+}
+
+}
+
+#endif
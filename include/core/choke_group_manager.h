@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Registry of the choke groups.
+//
+// Groups are looked up by name through a hash index and keep the list
+// of downloads assigned to them, so per group aggregates only visit
+// the group's own members rather than every download.
+
+#ifndef RTORRENT_CORE_CHOKE_GROUP_MANAGER_H
+#define RTORRENT_CORE_CHOKE_GROUP_MANAGER_H
+
+#include <cinttypes>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace torrent {
+class choke_group;
+}
+
+namespace core {
+
+class Download;
+
+class ChokeGroupManager {
+public:
+  using member_set = std::unordered_set<Download*>;
+
+  struct group_stats {
+    uint64_t up_rate{ 0 };
+    uint64_t down_rate{ 0 };
+    uint32_t up_unchoked{ 0 };
+    uint32_t down_unchoked{ 0 };
+    uint32_t peers{ 0 };
+    uint32_t active{ 0 };
+  };
+
+  using slot_group     = std::function<uint32_t(Download*)>;
+  using slot_set_group = std::function<void(Download*, uint32_t)>;
+  using slot_stats     = std::function<void(Download*, group_stats&)>;
+
+  ChokeGroupManager();
+  ~ChokeGroupManager();
+  ChokeGroupManager(const ChokeGroupManager&) = delete;
+  void operator=(const ChokeGroupManager&) = delete;
+
+  size_t size() const {
+    return m_groups.size();
+  }
+
+  // Returns -1 if there's no group with that name.
+  int64_t index_of(const std::string& name) const;
+
+  torrent::choke_group* at(uint32_t index);
+  const member_set&     members(uint32_t index) const;
+
+  // Adds a group with the default leech heuristics, throwing on empty
+  // or duplicate names.
+  torrent::choke_group* insert(const std::string& name);
+  void                  clear();
+
+  // Members of an erased group are moved to the default group at
+  // index 0, which can't be erased, and later groups shift down.
+  void erase_group(uint32_t index);
+  void rename_group(uint32_t index, const std::string& name);
+
+  // Downloads are added to their current group when inserted into
+  // the download list, and removed when erased.
+  void insert(Download* download);
+  void erase(Download* download);
+  void set_group(Download* download, uint32_t index);
+
+  group_stats stats(uint32_t index) const;
+
+  // Default to the group index and statistics of the download.
+  void set_slot_group(slot_group s) {
+    m_slotGroup = std::move(s);
+  }
+  void set_slot_set_group(slot_set_group s) {
+    m_slotSetGroup = std::move(s);
+  }
+  void set_slot_stats(slot_stats s) {
+    m_slotStats = std::move(s);
+  }
+
+private:
+  struct group_entry {
+    torrent::choke_group* group;
+    member_set            members;
+  };
+
+  group_entry& entry_at(uint32_t index);
+
+  std::vector<group_entry>                  m_groups;
+  std::unordered_map<std::string, uint32_t> m_index;
+
+  slot_group     m_slotGroup;
+  slot_set_group m_slotSetGroup;
+  slot_stats     m_slotStats;
+};
+
+}
+
+#endif
@@ -4,6 +4,7 @@
 #ifndef RTORRENT_CORE_CURL_GET_H
 #define RTORRENT_CORE_CURL_GET_H
 
+#include <functional>
 #include <iosfwd>
 #include <string>
 
@@ -19,10 +20,27 @@ class CurlGet final : public torrent::Http {
 public:
   friend class CurlStack;
 
-  CurlGet(CurlStack* s)
+  // Request classes used by CurlStack to share the available
+  // connections. Tracker requests are created as announces and
+  // reclassified as scrapes by CurlGet::start from the url.
+  static constexpr int class_announce = 0;
+  static constexpr int class_scrape   = 1;
+  static constexpr int class_metadata = 2;
+  static constexpr int class_user     = 3;
+  static constexpr int class_size     = 4;
+
+  static const char* class_name(int c);
+
+  // Receives the data instead of the output stream when set. Return
+  // false to abort the transfer.
+  using slot_write = std::function<bool(const char*, size_t)>;
+
+  CurlGet(CurlStack* s, int requestClass = class_user)
     : m_active(false)
     , m_handle(nullptr)
-    , m_stack(s) {}
+    , m_stack(s)
+    , m_baseClass(requestClass)
+    , m_requestClass(requestClass) {}
   ~CurlGet() override;
   CurlGet(const CurlGet&) = delete;
   void operator=(const CurlGet&) = delete;
@@ -53,7 +71,34 @@ public:
     return m_handle;
   }
 
+  // The class of the current request, which for announces depends on
+  // the url passed to the last start().
+  int request_class() const {
+    return m_requestClass;
+  }
+  int base_request_class() const {
+    return m_baseClass;
+  }
+  void set_request_class(int c) {
+    m_baseClass    = c;
+    m_requestClass = c;
+  }
+
+  const std::string& host() const {
+    return m_host;
+  }
+
+  const slot_write& write_slot() const {
+    return m_slot_write;
+  }
+  void set_write_slot(slot_write s) {
+    m_slot_write = s;
+  }
+
 private:
+  static std::string parse_host(const std::string& url);
+  static bool        is_scrape_url(const std::string& url);
+
   void receive_timeout();
 
   bool m_active;
@@ -63,6 +108,13 @@ private:
 
   CURL*      m_handle;
   CurlStack* m_stack;
+
+  int         m_baseClass;
+  int         m_requestClass;
+  std::string m_host;
+  slot_write  m_slot_write;
+  int64_t     m_timeQueued{ 0 };
+  int64_t     m_timeStarted{ 0 };
 };
 
 }
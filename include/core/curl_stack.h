@@ -4,16 +4,58 @@
 #ifndef RTORRENT_CORE_CURL_STACK_H
 #define RTORRENT_CORE_CURL_STACK_H
 
+#include <cinttypes>
 #include <deque>
+#include <functional>
+#include <map>
 #include <string>
 
 #include <torrent/utils/priority_queue_default.h>
 
+#include "core/curl_get.h"
+
 namespace core {
 
-class CurlGet;
 class CurlSocket;
 
+// Queued requests of one class, bucketed by host and ordered by the
+// oldest request of each host. Finding the oldest request to a host
+// below its limit only steps over the saturated hosts, not every
+// request queued to them.
+class CurlHostQueue {
+public:
+  using slot_available = std::function<bool(const std::string&)>;
+
+  bool empty() const {
+    return m_size == 0;
+  }
+  size_t size() const {
+    return m_size;
+  }
+
+  void push_back(CurlGet* get, const std::string& host);
+
+  // Returns false if the request isn't queued on that host.
+  bool erase(CurlGet* get, const std::string& host);
+
+  // Returns nullptr if no queued request has an available host.
+  CurlGet* front_available(const slot_available& available) const;
+
+private:
+  struct entry_type {
+    uint64_t sequence;
+    CurlGet* get;
+  };
+
+  using host_map  = std::map<std::string, std::deque<entry_type>>;
+  using order_map = std::map<uint64_t, host_map::iterator>;
+
+  host_map  m_hosts;
+  order_map m_order;
+  uint64_t  m_sequence{ 0 };
+  size_t    m_size{ 0 };
+};
+
 // By using a deque instead of vector we allow for cheaper removal of
 // the oldest elements, those that will be first in the in the
 // deque.
@@ -21,6 +63,11 @@ class CurlSocket;
 // This should fit well with the use-case of a http stack, thus
 // we get most of the cache locality benefits of a vector with fast
 // removal of elements.
+//
+// Requests beyond max_active are queued per request class, and the
+// next request to start is picked by weighted round-robin between
+// the classes, skipping requests to hosts that already have
+// max_active_per_host requests in progress.
 
 class CurlStack : std::deque<CurlGet*> {
 public:
@@ -50,7 +97,16 @@ public:
   CurlStack(const CurlStack&) = delete;
   void operator=(const CurlStack&) = delete;
 
-  CurlGet*    new_object();
+  struct class_stats {
+    unsigned int weight;
+    unsigned int active;
+    uint64_t     pass;
+    uint64_t     completed;
+    int64_t      wait_usec;
+    int64_t      time_usec;
+  };
+
+  CurlGet*    new_object(int requestClass = CurlGet::class_user);
   CurlSocket* new_socket(int fd);
 
   unsigned int active() const {
@@ -59,9 +115,21 @@ public:
   unsigned int max_active() const {
     return m_maxActive;
   }
-  void set_max_active(unsigned int a) {
-    m_maxActive = a;
+  void set_max_active(unsigned int a);
+
+  // A value of zero disables the per-host limit.
+  unsigned int max_active_per_host() const {
+    return m_maxActivePerHost;
+  }
+  void set_max_active_per_host(unsigned int a);
+
+  unsigned int queued(int requestClass) const {
+    return m_queued[requestClass].size();
+  }
+  const class_stats& stats(int requestClass) const {
+    return m_stats[requestClass];
   }
+  void set_weight(int requestClass, unsigned int weight);
 
   const std::string& user_agent() const {
     return m_userAgent;
@@ -115,6 +183,28 @@ public:
     m_dns_timeout = timeout;
   }
 
+  // Keep connections open after a transfer so that later requests to
+  // the same host can skip the TCP and TLS handshakes.
+  bool keep_alive() const {
+    return m_keep_alive;
+  }
+  void set_keep_alive(bool s) {
+    m_keep_alive = s;
+  }
+
+  // Negotiate HTTP/2 over TLS and multiplex requests to the same host
+  // onto a single connection when the server supports it.
+  bool http2() const {
+    return m_http2;
+  }
+  void set_http2(bool s) {
+    m_http2 = s;
+  }
+
+  // The CURL_HTTP_VERSION_* used for new requests, HTTP/1.1 unless
+  // HTTP/2 is enabled and libcurl was built with it.
+  long http_version() const;
+
   static void global_init();
   static void global_cleanup();
 
@@ -129,14 +219,28 @@ protected:
   void remove_get(CurlGet* get);
 
 private:
+  using host_map = std::map<std::string, unsigned int>;
+
   void receive_timeout();
 
   bool process_done_handle();
 
+  bool     is_host_available(const std::string& host) const;
+  CurlGet* select_next();
+  void     activate(CurlGet* get);
+  void     activate_pending();
+
   void* m_handle;
+  void* m_shareHandle;
 
   unsigned int m_active{ 0 };
   unsigned int m_maxActive{ 32 };
+  unsigned int m_maxActivePerHost{ 8 };
+
+  CurlHostQueue m_queued[CurlGet::class_size];
+  class_stats   m_stats[CurlGet::class_size];
+  uint64_t      m_pass{ 0 };
+  host_map      m_hostActive;
 
   torrent::utils::priority_item m_taskTimeout;
 
@@ -149,6 +253,8 @@ private:
   bool m_ssl_verify_host{ true };
   bool m_ssl_verify_peer{ true };
   long m_dns_timeout{ 60 };
+  bool m_keep_alive{ true };
+  bool m_http2{ true };
 };
 
 }
@@ -135,6 +135,12 @@ public:
   uint32_t priority();
   void     set_priority(uint32_t p);
 
+  // Name of the priority, or nullptr if out of range.
+  const char* priority_str();
+
+  // Bytes uploaded per thousand bytes done, zero while hash checking.
+  int64_t ratio();
+
   uint32_t resume_flags() {
     return m_resumeFlags;
   }
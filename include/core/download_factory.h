@@ -16,6 +16,10 @@
 
 #include "core/http_queue.h"
 
+namespace utils {
+class BencodeDecoder;
+}
+
 namespace core {
 
 class Manager;
@@ -81,6 +85,7 @@ public:
 private:
   void receive_load();
   void receive_loaded();
+  void receive_decoded();
   void receive_commit();
   void receive_success();
   void receive_failed(const std::string& msg);
@@ -90,8 +95,9 @@ private:
   void initialize_rtorrent(Download* download, torrent::Object* rtorrent);
 
   Manager*         m_manager;
-  std::iostream*   m_stream{ nullptr };
-  torrent::Object* m_object{ nullptr };
+  std::iostream*         m_stream{ nullptr };
+  torrent::Object*       m_object{ nullptr };
+  utils::BencodeDecoder* m_decoder{ nullptr };
 
   bool m_commited{ false };
   bool m_loaded{ false };
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Decides which downloads in the hashing view get hash checked, and
+// how many are allowed to check concurrently.
+//
+// Downloads with valid resume data are quick checked right away so
+// they can start seeding without waiting for a slot. The remaining
+// downloads are checked in the order of partially completed first,
+// then smallest first, bounded by a global limit (CPU) and a limit on
+// the number of concurrent checks reading from the same device (I/O).
+
+#ifndef RTORRENT_CORE_HASH_SCHEDULER_H
+#define RTORRENT_CORE_HASH_SCHEDULER_H
+
+#include <cinttypes>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace core {
+
+class Download;
+class DownloadList;
+class View;
+
+class HashScheduler {
+public:
+  using device_type = dev_t;
+  using device_map  = std::map<device_type, uint32_t>;
+
+  struct candidate_type {
+    Download*   download;
+    device_type device;
+    bool        partial;
+    uint64_t    size;
+  };
+
+  using candidate_list = std::vector<candidate_type>;
+  using slot_start     = std::function<bool(const candidate_type&)>;
+
+  HashScheduler(DownloadList* downloadList)
+    : m_downloadList(downloadList) {}
+
+  HashScheduler(const HashScheduler&) = delete;
+  void operator=(const HashScheduler&) = delete;
+
+  // A value of zero uses the number of hardware threads.
+  uint32_t max_active() const;
+  void     set_max_active(uint32_t v) {
+    m_maxActive = v;
+  }
+
+  // A value of zero disables the per-device limit.
+  uint32_t max_per_device() const {
+    return m_maxPerDevice;
+  }
+  void set_max_per_device(uint32_t v) {
+    m_maxPerDevice = v;
+  }
+
+  uint32_t size_active() const {
+    return m_active.size();
+  }
+  uint32_t size_waiting() const {
+    return m_waiting;
+  }
+
+  uint64_t checked() const {
+    return m_checked;
+  }
+  uint64_t bytes_checked() const {
+    return m_bytesChecked;
+  }
+
+  // Bytes left to hash for the active and waiting downloads, as of
+  // the last update.
+  uint64_t bytes_left() const;
+
+  void update(View* view);
+  void erase(Download* download);
+
+  // The device a download is on is cached until its directory
+  // changes.
+  void invalidate_device(Download* download) {
+    m_devices.erase(download);
+  }
+
+  // Orders the candidates and calls 'start' for each that fits within
+  // the limits, with 'active' holding the number of checks running on
+  // each device. Returns those left waiting, in order. Candidates that
+  // fail to start are dropped without taking a slot.
+  static candidate_list start_waiting(candidate_list    candidates,
+                                      device_map*       active,
+                                      uint32_t          maxActive,
+                                      uint32_t          maxPerDevice,
+                                      const slot_start& start);
+
+  static bool compare_priority(const candidate_type& a,
+                               const candidate_type& b);
+
+private:
+  struct active_entry {
+    device_type device;
+    uint64_t    size;
+  };
+
+  using active_map = std::map<Download*, active_entry>;
+  using cache_map  = std::map<Download*, device_type>;
+
+  static device_type find_device(const std::string& path);
+
+  device_type device_of(Download* download);
+
+  void                 insert_active(Download* download);
+  active_map::iterator erase_active(active_map::iterator itr);
+
+  void reap_finished();
+  bool start_check(Download* download);
+
+  DownloadList* m_downloadList;
+
+  uint32_t m_maxActive{ 0 };
+  uint32_t m_maxPerDevice{ 1 };
+
+  active_map m_active;
+  device_map m_deviceActive;
+  cache_map  m_devices;
+  uint32_t   m_waiting{ 0 };
+  uint64_t   m_waitingBytes{ 0 };
+
+  uint64_t m_checked{ 0 };
+  uint64_t m_bytesChecked{ 0 };
+};
+
+}
+
+#endif
@@ -16,6 +16,7 @@ class HttpQueue : private std::list<CurlGet*> {
 public:
   using base_type       = std::list<CurlGet*>;
   using slot_factory    = std::function<CurlGet*()>;
+  using slot_write      = std::function<bool(const char*, size_t)>;
   using slot_curl_get   = std::function<void(CurlGet*)>;
   using signal_curl_get = std::list<slot_curl_get>;
 
@@ -42,6 +43,7 @@ public:
   // Consider adding a flag to indicate whetever HttpQueue should
   // delete the stream.
   iterator insert(const std::string& url, std::iostream* s);
+  iterator insert(const std::string& url, slot_write s);
   void     erase(iterator itr);
 
   void clear();
@@ -58,6 +60,8 @@ public:
   }
 
 private:
+  iterator insert_get(CurlGet* h);
+
   slot_factory    m_slot_factory;
   signal_curl_get m_signal_insert;
   signal_curl_get m_signal_erase;
@@ -9,9 +9,16 @@
 #include <torrent/object.h>
 #include <torrent/utils/log_buffer.h>
 
+#include "core/address_trie.h"
+#include "core/choke_group_manager.h"
 #include "core/download_list.h"
+#include "core/hash_scheduler.h"
 #include "core/poll_manager.h"
-#include "core/range_map.h"
+#include "core/queue_manager.h"
+#include "core/scrape_batcher.h"
+#include "core/search_index.h"
+#include "core/throttle_shaper.h"
+#include "core/tick_profiler.h"
 
 namespace torrent {
 class Bencode;
@@ -63,6 +70,28 @@ public:
   }
   void set_hashing_view(View* v);
 
+  HashScheduler* hash_scheduler() {
+    return m_hashScheduler;
+  }
+  QueueManager* queue_manager() {
+    return m_queueManager;
+  }
+  ScrapeBatcher* scrape_batcher() {
+    return m_scrapeBatcher;
+  }
+  ThrottleShaper* throttle_shaper() {
+    return m_throttleShaper;
+  }
+  ChokeGroupManager* choke_group_manager() {
+    return m_chokeGroupManager;
+  }
+  TickProfiler* tick_profiler() {
+    return m_tickProfiler;
+  }
+  SearchIndex* search_index() {
+    return m_searchIndex;
+  }
+
   torrent::log_buffer* log_important() {
     return m_log_important.get();
   }
@@ -79,12 +108,17 @@ public:
                                   bool                                rate,
                                   bool                                up);
 
-  // Use custom throttle for the given range of IP addresses.
-  void                  set_address_throttle(uint32_t              begin,
-                                             uint32_t              end,
+  // Use custom throttle for the given inclusive range of IPv4 or IPv6
+  // addresses.
+  void                  set_address_throttle(const AddressKey&     first,
+                                             const AddressKey&     last,
                                              torrent::ThrottlePair throttles);
   torrent::ThrottlePair get_address_throttle(const sockaddr* addr);
 
+  size_t address_throttle_size() const {
+    return m_addressThrottles.size();
+  }
+
   // Really should find a more descriptive name.
   void initialize_second();
   void cleanup();
@@ -136,7 +170,7 @@ public:
                                               const std::string& metafile);
 
 private:
-  using AddressThrottleMap = RangeMap<uint32_t, torrent::ThrottlePair>;
+  using AddressThrottleMap = AddressTrie<torrent::ThrottlePair>;
 
   void create_http(const std::string& uri);
   void create_final(std::istream* s);
@@ -152,7 +186,14 @@ private:
   HttpQueue*       m_httpQueue;
   CurlStack*       m_httpStack;
 
-  View* m_hashingView{ nullptr };
+  View*              m_hashingView{ nullptr };
+  HashScheduler*     m_hashScheduler;
+  QueueManager*      m_queueManager;
+  ScrapeBatcher*     m_scrapeBatcher;
+  ThrottleShaper*    m_throttleShaper;
+  ChokeGroupManager* m_chokeGroupManager;
+  TickProfiler*      m_tickProfiler;
+  SearchIndex*       m_searchIndex;
 
   ThrottleMap        m_throttles;
   AddressThrottleMap m_addressThrottles;
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Decides which downloads in the 'started' view are allowed to be
+// active.
+//
+// Queued downloads are kept in two ordered queues, one for downloads
+// and one for seeds, sorted by priority and then by the order they
+// were queued. Slots are limited in total, per class and per tracker
+// host, and are handed out as downloads are added or removed instead
+// of rescanning the view. The tracker host of a download is looked up
+// when it is inserted.
+
+#ifndef RTORRENT_CORE_QUEUE_MANAGER_H
+#define RTORRENT_CORE_QUEUE_MANAGER_H
+
+#include <cinttypes>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace core {
+
+class Download;
+class DownloadList;
+
+// Queued downloads of one class in queue order, and bucketed by tracker
+// so that finding the first one not held back by its tracker only
+// looks at the head of each bucket.
+class TrackerQueue {
+public:
+  struct entry_type {
+    uint32_t  priority;
+    uint64_t  sequence;
+    Download* download;
+
+    bool operator<(const entry_type& other) const {
+      return priority != other.priority ? priority > other.priority
+                                        : sequence < other.sequence;
+    }
+  };
+
+  using order_type     = std::set<entry_type>;
+  using bucket_map     = std::map<std::string, order_type>;
+  using slot_available = std::function<bool(const std::string&)>;
+
+  bool empty() const {
+    return m_order.empty();
+  }
+  size_t size() const {
+    return m_order.size();
+  }
+
+  const entry_type& front() const {
+    return *m_order.begin();
+  }
+
+  void insert(const std::string& tracker, const entry_type& entry);
+  void erase(const std::string& tracker, const entry_type& entry);
+
+  // Positions are cached until the queue changes, as the download list
+  // asks for every visible row.
+  int64_t position(const entry_type& entry) const;
+
+  // The first entry in queue order whose tracker is available, or
+  // nullptr.
+  const entry_type* front_available(const slot_available& available) const;
+
+private:
+  using position_map = std::unordered_map<uint64_t, int64_t>;
+
+  order_type m_order;
+  bucket_map m_buckets;
+
+  mutable position_map m_positions;
+  mutable bool         m_positionsValid{ false };
+};
+
+class QueueManager {
+public:
+  // Limits are unlimited when negative.
+  static constexpr int64_t unlimited = -1;
+
+  enum reason_type {
+    reason_active,
+    reason_not_queued,
+    reason_slots,
+    reason_slots_downloading,
+    reason_slots_seeding,
+    reason_slots_tracker,
+    reason_queued
+  };
+
+  // What the queue needs to know about a download.
+  struct state_type {
+    bool     holds_slot;
+    bool     done;
+    uint32_t priority;
+  };
+
+  using slot_state    = std::function<state_type(Download*)>;
+  using slot_tracker  = std::function<std::string(Download*)>;
+  using slot_download = std::function<void(Download*)>;
+
+  static const char* reason_name(reason_type reason);
+
+  QueueManager(DownloadList* downloadList);
+
+  QueueManager(const QueueManager&) = delete;
+  void operator=(const QueueManager&) = delete;
+
+  int64_t max_active() const {
+    return m_maxActive;
+  }
+  int64_t max_downloading() const {
+    return m_maxDownloading;
+  }
+  int64_t max_seeding() const {
+    return m_maxSeeding;
+  }
+  int64_t max_per_tracker() const {
+    return m_maxPerTracker;
+  }
+
+  // Changing a limit starts or pauses downloads as needed.
+  void set_max_active(int64_t v);
+  void set_max_downloading(int64_t v);
+  void set_max_seeding(int64_t v);
+  void set_max_per_tracker(int64_t v);
+
+  uint32_t queued_downloading() const {
+    return m_queueDownloading.size();
+  }
+  uint32_t queued_seeding() const {
+    return m_queueSeeding.size();
+  }
+  uint32_t active_downloading() const {
+    return m_activeDownloading;
+  }
+  uint32_t active_seeding() const {
+    return m_activeSeeding;
+  }
+
+  uint64_t started() const {
+    return m_started;
+  }
+  uint64_t paused() const {
+    return m_paused;
+  }
+
+  // Called when a download enters or leaves the 'started' view. The
+  // caller is responsible for pausing erased downloads.
+  void insert(Download* download);
+  void erase(Download* download);
+
+  // Picks up downloads paused, resumed or finished behind our back,
+  // then fills or trims the slots.
+  void update();
+
+  // Requeues the download if its priority changed while queued.
+  void update_priority(Download* download);
+
+  // Position among the queued downloads of the same class, or -1.
+  int64_t     position(Download* download) const;
+  reason_type reason(Download* download) const;
+
+  // Default to reading the download and resuming or pausing it through
+  // the download list.
+  void set_slot_state(slot_state s) {
+    m_slotState = std::move(s);
+  }
+  void set_slot_tracker(slot_tracker s) {
+    m_slotTracker = std::move(s);
+  }
+  void set_slot_resume(slot_download s) {
+    m_slotResume = std::move(s);
+  }
+  void set_slot_pause(slot_download s) {
+    m_slotPause = std::move(s);
+  }
+
+private:
+  using queue_entry = TrackerQueue::entry_type;
+
+  struct queued_entry {
+    TrackerQueue* queue;
+    queue_entry   entry;
+    std::string   tracker;
+  };
+
+  struct active_entry {
+    bool        seeding;
+    std::string tracker;
+    uint64_t    sequence;
+  };
+
+  using queued_map  = std::unordered_map<Download*, queued_entry>;
+  using active_map  = std::unordered_map<Download*, active_entry>;
+  using tracker_map = std::map<std::string, uint32_t>;
+
+  static state_type  state_of(Download* download);
+  static std::string tracker_of(Download* download);
+
+  static bool is_full(int64_t limit, uint32_t used) {
+    return limit >= 0 && used >= (uint64_t)limit;
+  }
+  static bool is_over(int64_t limit, uint32_t used) {
+    return limit >= 0 && used > (uint64_t)limit;
+  }
+
+  void enqueue(Download*          download,
+               const state_type&  state,
+               uint64_t           sequence,
+               const std::string& tracker);
+  void dequeue(Download* download);
+
+  reason_type blocked_by(bool seeding, const std::string& tracker) const;
+  bool        is_tracker_full(const std::string& tracker) const;
+
+  void add_active(Download*          download,
+                  bool               seeding,
+                  uint64_t           sequence,
+                  const std::string& tracker);
+  void remove_active(active_map::iterator itr);
+
+  bool start_next(TrackerQueue* queue);
+  void fill();
+  void trim();
+
+  slot_state    m_slotState;
+  slot_tracker  m_slotTracker;
+  slot_download m_slotResume;
+  slot_download m_slotPause;
+
+  int64_t m_maxActive{ unlimited };
+  int64_t m_maxDownloading{ unlimited };
+  int64_t m_maxSeeding{ unlimited };
+  int64_t m_maxPerTracker{ unlimited };
+
+  TrackerQueue m_queueDownloading;
+  TrackerQueue m_queueSeeding;
+  queued_map   m_queued;
+
+  active_map  m_active;
+  tracker_map m_trackerActive;
+  uint32_t    m_activeDownloading{ 0 };
+  uint32_t    m_activeSeeding{ 0 };
+
+  uint64_t m_sequence{ 0 };
+  uint64_t m_started{ 0 };
+  uint64_t m_paused{ 0 };
+};
+
+}
+
+#endif
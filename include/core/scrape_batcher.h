@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Coalesces scrapes of downloads sharing a http tracker into requests
+// carrying multiple info hashes.
+//
+// Downloads are queued per scrape url and sent when either the batch
+// size is reached or the delay window since the first queued download
+// has passed. The results are stored in the download's "rtorrent"
+// section, as libtorrent's trackers only take results from their own
+// requests. Downloads the tracker didn't answer for, or whose primary
+// tracker can't be batched, fall back to the regular scrape the
+// default event.download.inserted handler sends.
+//
+// Batching is opt-in, by using d.tracker.send_scrape_batched in
+// event.download.inserted.
+
+#ifndef RTORRENT_CORE_SCRAPE_BATCHER_H
+#define RTORRENT_CORE_SCRAPE_BATCHER_H
+
+#include <cinttypes>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <torrent/hash_string.h>
+#include <torrent/utils/priority_queue_default.h>
+
+namespace torrent {
+class Object;
+class Tracker;
+}
+
+namespace core {
+
+class CurlGet;
+class CurlStack;
+class Download;
+class DownloadList;
+
+class ScrapeBatcher {
+public:
+  using hash_list = std::vector<torrent::HashString>;
+
+  using slot_send = std::function<void(const std::string&, hash_list&)>;
+  using slot_hash = std::function<void(const torrent::HashString&)>;
+  using slot_scraped =
+    std::function<void(const torrent::HashString&, const torrent::Object&)>;
+
+  // Same delay as the default d.tracker.send_scrape handler.
+  static constexpr uint32_t fallback_delay = 30;
+
+  ScrapeBatcher(DownloadList* downloadList, CurlStack* stack);
+  ~ScrapeBatcher();
+  ScrapeBatcher(const ScrapeBatcher&) = delete;
+  void operator=(const ScrapeBatcher&) = delete;
+
+  uint32_t batch_size() const {
+    return m_batchSize;
+  }
+  void set_batch_size(uint32_t v);
+
+  // Seconds to wait for more downloads after the first one is queued.
+  uint32_t delay() const {
+    return m_delay;
+  }
+  void set_delay(uint32_t v) {
+    m_delay = v;
+  }
+
+  uint32_t size_pending() const;
+  uint32_t size_active() const {
+    return m_active.size();
+  }
+
+  uint64_t requests() const {
+    return m_requests;
+  }
+  uint64_t scraped() const {
+    return m_scraped;
+  }
+  uint64_t fallbacks() const {
+    return m_fallbacks;
+  }
+
+  void insert(Download* download);
+
+  // Queues the hash on the scrape url, falling back right away if the
+  // url is empty.
+  void insert(const std::string& url, const torrent::HashString& hash);
+
+  // Sends all pending batches right away.
+  void flush();
+
+  // Closes active requests and drops pending ones.
+  void clear();
+
+  // Stores the statistics of the hashes found in the response's
+  // "files", and falls back for the rest.
+  void receive(const hash_list& hashes, const std::string& data);
+  void receive_failed(const hash_list& hashes, const std::string& msg);
+
+  static std::string scrape_url(const std::string& announceUrl);
+  static std::string request_url(const std::string& url,
+                                 const hash_list&   hashes);
+
+  // Default to sending the batch through the curl stack, and to
+  // updating or scraping the downloads of the download list.
+  void set_slot_send(slot_send s) {
+    m_slotSend = std::move(s);
+  }
+  void set_slot_scraped(slot_scraped s) {
+    m_slotScraped = std::move(s);
+  }
+  void set_slot_fallback(slot_hash s) {
+    m_slotFallback = std::move(s);
+  }
+
+private:
+  struct request_type {
+    CurlGet*    get;
+    std::string data;
+    hash_list   hashes;
+  };
+
+  using pending_map  = std::map<std::string, hash_list>;
+  using request_list = std::list<request_type>;
+
+  static torrent::Tracker* primary_tracker(Download* download);
+
+  void send(const std::string& url, hash_list& hashes);
+  void send_request(const std::string& url, hash_list& hashes);
+  void receive_done(request_list::iterator itr);
+  void receive_failed(request_list::iterator itr, const std::string& msg);
+  void finish(request_list::iterator itr);
+
+  void store(const torrent::HashString& hash, const torrent::Object& stats);
+  void fallback(const torrent::HashString& hash);
+
+  DownloadList* m_downloadList;
+  CurlStack*    m_stack;
+
+  uint32_t m_batchSize{ 50 };
+  uint32_t m_delay{ 10 };
+
+  pending_map  m_pending;
+  request_list m_active;
+
+  torrent::utils::priority_item m_taskFlush;
+
+  uint64_t m_requests{ 0 };
+  uint64_t m_scraped{ 0 };
+  uint64_t m_fallbacks{ 0 };
+
+  slot_send    m_slotSend;
+  slot_scraped m_slotScraped;
+  slot_hash    m_slotFallback;
+};
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Trigram indexes over the names and file paths of all downloads,
+// kept up to date as downloads are inserted and erased.
+//
+// Magnet downloads get their real name and files by being replaced
+// with a new download once the metadata arrives, so indexing on
+// insertion covers them too.
+//
+// View filters test downloads one at a time, so 'name_contains'
+// answers from the result of the last query until the query or the
+// set of downloads changes. The UI's temporary filter only uses it
+// for plain substrings, falling back to a regex match otherwise.
+
+#ifndef RTORRENT_CORE_SEARCH_INDEX_H
+#define RTORRENT_CORE_SEARCH_INDEX_H
+
+#include <cinttypes>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "utils/trigram_index.h"
+
+namespace core {
+
+class Download;
+
+class SearchIndex {
+public:
+  using download_list = std::vector<Download*>;
+
+  SearchIndex()                   = default;
+  SearchIndex(const SearchIndex&) = delete;
+  void operator=(const SearchIndex&) = delete;
+
+  size_t size() const {
+    return m_entries.size();
+  }
+  size_t name_trigrams() const {
+    return m_names.trigram_count();
+  }
+  size_t file_trigrams() const {
+    return m_files.trigram_count();
+  }
+
+  void insert(Download* download);
+  void insert(Download*                             download,
+              const std::string&                    name,
+              const utils::TrigramIndex::text_list& paths);
+  void erase(Download* download);
+
+  // Case-insensitive substring searches.
+  download_list search_names(const std::string& query) const;
+  download_list search_files(const std::string& query) const;
+
+  bool name_contains(Download* download, const std::string& query);
+
+  // Searches 'name_contains' ran instead of using the cached result.
+  uint64_t cache_misses() const {
+    return m_cacheMisses;
+  }
+
+  // Whether the pattern has no regex syntax, nor characters needing
+  // quotes in a command, so the index can answer it.
+  static bool is_plain(const std::string& pattern);
+
+  // The view filter for names matching a pattern typed in the UI.
+  static std::string filter_command(const std::string& pattern);
+
+private:
+  using id_type = utils::TrigramIndex::id_type;
+
+  struct entry_type {
+    id_type name;
+    id_type files;
+  };
+
+  static download_list to_downloads(const std::vector<id_type>& ids,
+                                    const download_list&        downloads);
+  static void          assign(download_list* downloads,
+                              id_type        id,
+                              Download*      download);
+
+  utils::TrigramIndex m_names;
+  utils::TrigramIndex m_files;
+
+  std::unordered_map<Download*, entry_type> m_entries;
+
+  // Indexed by the ids of the respective trigram index.
+  download_list m_nameDownloads;
+  download_list m_fileDownloads;
+
+  bool                          m_cacheValid{ false };
+  std::string                   m_cacheQuery;
+  std::unordered_set<Download*> m_cacheResult;
+  uint64_t                      m_cacheMisses{ 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Adaptive shaping on top of the named throttles.
+//
+// Classes form a tree below the global throttle, each backed by the
+// named throttle of the same name so downloads join a class through
+// 'd.throttle_name'. Once a second the measured rate of each class is
+// used to estimate its demand, and the capacity of every class is
+// split between its children: first their guaranteed rate, then by
+// weight up to their demand, and what idle classes leave unused is
+// handed to the busy ones up to their ceiling.
+//
+// Downloads attached to an interior class share it with its children
+// as if they were a child of weight one without a guaranteed rate,
+// and also get whatever the children leave unassigned.
+//
+// Leaves save up the part of their allotment they don't use in a token
+// bucket, which lets them burst above it later. Time of day profiles
+// replace the ceiling of a class, or the global max rate, and are
+// evaluated as part of the same update.
+
+#ifndef RTORRENT_CORE_THROTTLE_SHAPER_H
+#define RTORRENT_CORE_THROTTLE_SHAPER_H
+
+#include <cinttypes>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <torrent/connection_manager.h>
+#include <torrent/utils/priority_queue_default.h>
+
+namespace core {
+
+class ThrottleShaper {
+public:
+  using throttle_map = std::map<std::string, torrent::ThrottlePair>;
+
+  enum direction_type { direction_up, direction_down, direction_size };
+
+  // Rates are in bytes per second, with 'unlimited' used for classes
+  // without a ceiling.
+  static constexpr uint64_t unlimited = ~uint64_t();
+
+  struct profile_entry {
+    // Seconds since local midnight.
+    uint32_t start;
+    uint64_t rate;
+  };
+
+  struct shape_type {
+    uint64_t min{ 0 };
+    uint64_t max{ unlimited };
+    uint64_t burst{ 0 };
+
+    // Sorted by start time, the last entry remains active until the
+    // first entry of the next day.
+    std::vector<profile_entry> profile;
+
+    uint64_t rate{ 0 };
+    uint64_t demand{ 0 };
+    uint64_t allotted{ 0 };
+    uint64_t tokens{ 0 };
+  };
+
+  struct class_type {
+    std::string              name;
+    class_type*              parent{ nullptr };
+    std::vector<class_type*> children;
+    uint32_t                 weight{ 1 };
+    shape_type               shape[direction_size];
+
+    // Downloads attached directly to an interior class, only the
+    // rate, demand and allotted fields are used.
+    shape_type own[direction_size];
+  };
+
+  // What one child is entitled to when splitting a class's capacity.
+  struct share_type {
+    uint32_t weight;
+    uint64_t min;
+    uint64_t demand;
+    uint64_t ceiling;
+  };
+
+  // Splits 'capacity' between the shares; guaranteed rates first,
+  // scaled down evenly if they don't fit, then by weight up to demand
+  // and finally up to the ceilings. Returns what is left unassigned,
+  // which is 'unlimited' if the capacity was.
+  static uint64_t split(uint64_t                       capacity,
+                        const std::vector<share_type>& shares,
+                        std::vector<uint64_t>*         allotted);
+
+  ThrottleShaper(throttle_map* throttles);
+  ~ThrottleShaper();
+  ThrottleShaper(const ThrottleShaper&) = delete;
+  void operator=(const ThrottleShaper&) = delete;
+
+  bool is_active() const {
+    return m_taskUpdate.is_queued();
+  }
+  size_t size() const {
+    return m_classes.size();
+  }
+
+  // The root class, named "global", stands for the global throttle
+  // and is also returned for the empty name.
+  class_type* find(const std::string& name);
+  class_type* root() {
+    return &m_root;
+  }
+
+  std::vector<std::string> names() const;
+
+  // Inserts a class below 'parent', creating the named throttle if
+  // needed. Inserting an existing class moves it to the new parent.
+  class_type* insert(const std::string& name, const std::string& parent);
+
+  // Options are 'weight' and '{up,down}.{min,max,burst}', along with
+  // '{up,down}.{rate,allotted,tokens}' which can only be read.
+  void    set_option(const std::string& name,
+                     const std::string& option,
+                     uint64_t           value);
+  int64_t option(const std::string& name, const std::string& option);
+
+  // A rate of zero lifts the ceiling for the rest of the period.
+  void insert_profile(const std::string& name,
+                      direction_type     direction,
+                      uint32_t           start,
+                      uint64_t           rate);
+  void clear_profile(const std::string& name);
+
+  void update();
+
+private:
+  static constexpr size_t entry_none = ~size_t();
+
+  using class_map = std::map<std::string, std::unique_ptr<class_type>>;
+
+  static const profile_entry* active_profile(const shape_type& shape,
+                                             uint32_t          now);
+
+  static uint64_t ceiling(const shape_type& shape, uint32_t now);
+  static uint64_t estimate_demand(const shape_type& shape, uint64_t limit);
+
+  shape_type* find_shape(const std::string& name,
+                         const std::string& option,
+                         std::string*       field);
+
+  torrent::Throttle* throttle(class_type* node, direction_type direction);
+
+  void update_profile_global(direction_type direction, uint32_t now);
+  void update_demand(class_type* node, direction_type direction, uint32_t now);
+  void update_allotment(class_type*    node,
+                        direction_type direction,
+                        uint64_t       capacity,
+                        uint32_t       now);
+  void update_throttle(class_type* node, direction_type direction);
+  void update_own_throttle(class_type* node, direction_type direction);
+
+  void schedule();
+
+  throttle_map* m_throttles;
+
+  class_type m_root;
+  class_map  m_classes;
+
+  // Index of the global profile entry last applied, so manual changes
+  // to the global rate stick until the next entry starts.
+  size_t m_globalEntry[direction_size]{ entry_none, entry_none };
+
+  torrent::utils::priority_item m_taskUpdate;
+};
+
+}
+
+#endif
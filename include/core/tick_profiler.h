@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Timing of the main loop and the scheduled tasks it runs.
+//
+// The main thread alternates between doing work with the global lock
+// held, which is 'client_perform' running the due tasks until the
+// next timeout is asked for, and polling, which includes dispatching
+// socket events. Each scheduled task is timed and accounted to the
+// type of its slot, which for lambdas names the function that set it
+// up, e.g. "core::Manager::Manager()::{lambda()#2}".
+//
+// An iteration that holds the loop for longer than the stall
+// threshold is logged with the task that took the longest, and a poll
+// returning that much later than its timeout is logged as a stall in
+// socket event handling.
+
+#ifndef RTORRENT_CORE_TICK_PROFILER_H
+#define RTORRENT_CORE_TICK_PROFILER_H
+
+#include <cinttypes>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+#include <torrent/object.h>
+#include <torrent/utils/priority_queue_default.h>
+
+#include "utils/latency_histogram.h"
+
+namespace core {
+
+class TickProfiler {
+public:
+  using histogram_type = utils::LatencyHistogram;
+
+  struct task_stats {
+    std::string    name;
+    histogram_type histogram;
+  };
+
+  static constexpr uint64_t default_stall_threshold = 500000;
+
+  uint64_t stall_threshold() const {
+    return m_stallThreshold;
+  }
+  void set_stall_threshold(uint64_t usec) {
+    m_stallThreshold = usec;
+  }
+
+  // Called first thing in 'client_perform' and when returning the poll
+  // timeout.
+  void tick_begin();
+  void tick_end(uint64_t timeout);
+
+  // Same as priority_queue_perform, timing each task.
+  void perform(torrent::utils::priority_queue_default* queue,
+               torrent::utils::timer                   time);
+
+  void reset();
+
+  // Map of task name to histogram.
+  torrent::Object tasks_object() const;
+
+  // Histograms of the time spent working in each iteration, and
+  // polling in between.
+  torrent::Object ticks_object() const;
+
+  static std::string task_name(const std::type_info& type);
+
+private:
+  task_stats& stats_for(const std::type_info& type);
+
+  uint64_t m_stallThreshold{ default_stall_threshold };
+
+  uint64_t m_tickStart{ 0 };
+  uint64_t m_pollStart{ 0 };
+  uint64_t m_pollTimeout{ 0 };
+
+  // The longest task of the current iteration.
+  const task_stats* m_longestTask{ nullptr };
+  uint64_t          m_longestUsec{ 0 };
+
+  histogram_type m_work;
+  histogram_type m_poll;
+
+  std::unordered_map<const std::type_info*, task_stats> m_tasks;
+};
+
+}
+
+#endif
@@ -182,6 +182,8 @@ public:
   }
 
 private:
+  friend class ViewManager;
+
   void push_back(Download* d) {
     base_type::push_back(d);
   }
@@ -216,8 +218,7 @@ private:
 
   torrent::utils::timer m_lastChanged;
 
-  signal_void                   m_signal_changed;
-  torrent::utils::priority_item m_delayChanged;
+  signal_void m_signal_changed;
 };
 
 }
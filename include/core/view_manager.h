@@ -5,6 +5,9 @@
 #define RTORRENT_CORE_VIEW_MANAGER_H
 
 #include <string>
+#include <vector>
+
+#include <torrent/utils/priority_queue_default.h>
 #include <torrent/utils/unordered_vector.h>
 
 #include "core/view.h"
@@ -31,9 +34,8 @@ public:
   using base_type::empty;
   using base_type::size;
 
-  ~ViewManager() {
-    clear();
-  }
+  ViewManager();
+  ~ViewManager();
 
   // Ffff... Just throwing together an interface, need to think some
   // more on this.
@@ -78,6 +80,18 @@ public:
   void set_event_removed(const std::string& name, const torrent::Object& cmd) {
     (*find_throw(name))->set_event_removed(cmd);
   }
+
+  // Views changed during a main loop iteration have their signals
+  // emitted together by a single task, however many times each was
+  // changed, so windows are marked dirty once per view and iteration.
+  void mark_changed(View* view);
+  void unmark_changed(View* view);
+
+private:
+  void receive_changed();
+
+  std::vector<View*>            m_changed;
+  torrent::utils::priority_item m_taskChanged;
 };
 
 }
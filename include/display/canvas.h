@@ -4,10 +4,13 @@
 #ifndef RTORRENT_DISPLAY_CANVAS_H
 #define RTORRENT_DISPLAY_CANVAS_H
 
+#include <cstdarg>
+#include <cstdio>
 #include <string>
 #include <vector>
 
 #include "display/attributes.h"
+#include "display/cell_grid.h"
 
 namespace display {
 
@@ -24,8 +27,10 @@ public:
   Canvas(const Canvas&) = delete;
   void operator=(const Canvas&) = delete;
 
+  // Passes what changed in the grid to the window.
   void refresh() {
     if (m_isInitialized) {
+      m_grid.flush(m_window);
       wnoutrefresh(m_window);
     }
   }
@@ -48,6 +53,7 @@ public:
   void resize(int w, int h) {
     if (m_isInitialized) {
       wresize(m_window, h, w);
+      m_grid.resize(w, h);
     }
   }
   void resize(int x, int y, int w, int h);
@@ -64,24 +70,10 @@ public:
   }
 
   unsigned int get_x() {
-    int                  x = 1;
-    [[maybe_unused]] int y;
-
-    if (m_isInitialized) {
-      getyx(m_window, y, x);
-    }
-
-    return x;
+    return m_isInitialized ? m_grid.cursor_x() : 1;
   }
   unsigned int get_y() {
-    [[maybe_unused]] int x;
-    int                  y = 1;
-
-    if (m_isInitialized) {
-      getyx(m_window, y, x);
-    }
-
-    return y;
+    return m_isInitialized ? m_grid.cursor_y() : 1;
   }
 
   unsigned int width() {
@@ -107,7 +99,7 @@ public:
 
   void move(unsigned int x, unsigned int y) {
     if (m_isInitialized) {
-      wmove(m_window, y, x);
+      m_grid.move(x, y);
     }
   }
 
@@ -124,9 +116,23 @@ public:
     }
   }
 
+  // Marks the whole window as changed for the next refresh, without
+  // forcing the terminal to repaint it like redraw() does.
+  void touch() {
+    if (m_isInitialized) {
+      touchwin(m_window);
+    }
+  }
+
   void erase() {
     if (m_isInitialized) {
-      werase(m_window);
+      m_grid.erase();
+    }
+  }
+  void erase_line(unsigned int y) {
+    if (m_isInitialized) {
+      m_grid.move(0, y);
+      m_grid.clear_to_eol();
     }
   }
   static void erase_std() {
@@ -142,11 +148,7 @@ public:
                     chtype tl,
                     chtype tr,
                     chtype bl,
-                    chtype br) {
-    if (m_isInitialized) {
-      wborder(m_window, ls, rs, ts, bs, tl, tr, bl, br);
-    }
-  }
+                    chtype br);
 
   // The format string is non-const, but that will not be a problem
   // since the string shall always be a C string choosen at
@@ -163,12 +165,13 @@ public:
 
   void print_char(const chtype ch) {
     if (m_isInitialized) {
-      waddch(m_window, ch);
+      m_grid.write_char(ch);
     }
   }
   void print_char(unsigned int x, unsigned int y, const chtype ch) {
     if (m_isInitialized) {
-      mvwaddch(m_window, y, x, ch);
+      m_grid.move(x, y);
+      m_grid.write_char(ch);
     }
   }
 
@@ -178,13 +181,13 @@ public:
                 int          attr,
                 int          color) {
     if (m_isInitialized) {
-      mvwchgat(m_window, y, x, n, attr, color, NULL);
+      m_grid.change_attributes(x, y, n, attr, color);
     }
   }
 
   void set_default_attributes(int attr) {
     if (m_isInitialized) {
-      (void)wattrset(m_window, attr);
+      m_grid.set_attributes(attr & ~A_COLOR, PAIR_NUMBER(attr));
     }
   }
 
@@ -192,6 +195,11 @@ public:
   static void initialize();
   static void cleanup();
 
+  // Draws to 'output' on a terminal of the given size instead of the
+  // controlling terminal, e.g. to /dev/null when measuring how long
+  // rendering takes.
+  static void initialize_headless(FILE* output, int width, int height);
+
   static int get_screen_width() {
     int                  x = 0;
     [[maybe_unused]] int y;
@@ -226,31 +234,14 @@ public:
   }
 
 private:
-  static bool m_isInitialized;
+  static bool    m_isInitialized;
+  static SCREEN* m_screen;
 
-  WINDOW* m_window;
-};
-
-inline void
-Canvas::print(const char* str, ...) {
-  if (m_isInitialized) {
-    va_list arglist;
-    va_start(arglist, str);
-    vw_printw(m_window, const_cast<char*>(str), arglist);
-    va_end(arglist);
-  }
-}
+  void print_format(const char* str, va_list arglist);
 
-inline void
-Canvas::print(unsigned int x, unsigned int y, const char* str, ...) {
-  if (m_isInitialized) {
-    va_list arglist;
-    va_start(arglist, str);
-    wmove(m_window, y, x);
-    vw_printw(m_window, const_cast<char*>(str), arglist);
-    va_end(arglist);
-  }
-}
+  WINDOW*  m_window;
+  CellGrid m_grid;
+};
 
 }
 
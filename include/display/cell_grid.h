@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Character and attribute grid that a Canvas draws into.
+//
+// Windows redraw everything they show, yet most of it is the same as
+// the last time. Drawing into a plain array of cells is cheap, and
+// 'flush' compares it with the cells last passed to the curses window,
+// so only runs of changed cells reach curses.
+//
+// Text is multibyte in the current locale. A double width character
+// takes two cells, the second one having no glyph of its own, and
+// combining characters are kept with the cell before them. Control
+// characters are shown as '^X' and tabs advance to the next multiple
+// of eight columns. Text wraps at the right edge, a double width
+// character that doesn't fit in the last column starts the next line,
+// and what doesn't fit below the last line is dropped.
+
+#ifndef RTORRENT_DISPLAY_CELL_GRID_H
+#define RTORRENT_DISPLAY_CELL_GRID_H
+
+#include <cinttypes>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "display/attributes.h"
+
+namespace display {
+
+class CellGrid {
+public:
+  struct cell_type {
+    static constexpr unsigned int max_glyph = 12;
+
+    // Zero length for the second half of a double width character.
+    char    glyph[max_glyph];
+    uint8_t length;
+    attr_t  attr;
+    short   color;
+
+    bool operator==(const cell_type& c) const {
+      return length == c.length && attr == c.attr && color == c.color &&
+             std::memcmp(glyph, c.glyph, length) == 0;
+    }
+    bool operator!=(const cell_type& c) const {
+      return !(*this == c);
+    }
+  };
+
+  unsigned int width() const {
+    return m_width;
+  }
+  unsigned int height() const {
+    return m_height;
+  }
+
+  unsigned int cursor_x() const {
+    return m_x;
+  }
+  unsigned int cursor_y() const {
+    return m_y;
+  }
+
+  const cell_type& cell(unsigned int x, unsigned int y) const {
+    return m_cells[y * m_width + x];
+  }
+
+  // Keeps the cells that still fit, the next flush writes all cells.
+  void resize(unsigned int width, unsigned int height);
+  void invalidate();
+
+  // Ignored if outside the grid, like wmove.
+  void move(unsigned int x, unsigned int y);
+
+  // Used for text written after this, as with wattr_set.
+  void set_attributes(attr_t attr, short color) {
+    m_attr  = attr;
+    m_color = color;
+  }
+  attr_t attributes() const {
+    return m_attr;
+  }
+  short color() const {
+    return m_color;
+  }
+
+  void write(const char* first, const char* last);
+  void write_char(chtype ch);
+
+  // Like wchgat, changes the attributes of 'n' cells from x, or to the
+  // end of the line if negative, and moves the cursor to the start.
+  void change_attributes(unsigned int x,
+                         unsigned int y,
+                         int          n,
+                         attr_t       attr,
+                         short        color);
+
+  void erase();
+  void clear_to_eol();
+
+  // Passes the cells that changed since the last flush to the window,
+  // returning the number of cells written.
+  unsigned int flush(WINDOW* window);
+
+private:
+  cell_type* row(unsigned int y) {
+    return m_cells.data() + y * m_width;
+  }
+
+  static cell_type blank_cell();
+
+  void put_glyph(const char* glyph, unsigned int length, unsigned int width);
+  void append_combining(const char* glyph, unsigned int length);
+  void set_cell(unsigned int x, unsigned int y, const cell_type& cell);
+  void newline();
+
+  unsigned int m_width{ 0 };
+  unsigned int m_height{ 0 };
+
+  unsigned int m_x{ 0 };
+  unsigned int m_y{ 0 };
+  attr_t       m_attr{ A_NORMAL };
+  short        m_color{ 0 };
+
+  std::vector<cell_type> m_cells;
+  std::vector<cell_type> m_front;
+  std::vector<bool>      m_dirty;
+
+  std::string m_buffer;
+};
+
+}
+
+#endif
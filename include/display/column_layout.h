@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Download list layouts compiled to a list of columns.
+//
+// A column layout is given as a comma separated list of column names,
+// and compiled once into the fixed-width print functions of those
+// columns. Rendering a row is then a loop over the columns that reads
+// straight from the download, without looking up any commands.
+//
+// The compact download list uses the layout in 'ui.torrent_list.columns',
+// the full layout is the fixed title, info and status lines.
+
+#ifndef RTORRENT_DISPLAY_COLUMN_LAYOUT_H
+#define RTORRENT_DISPLAY_COLUMN_LAYOUT_H
+
+#include <string>
+#include <vector>
+
+namespace core {
+class Download;
+}
+
+namespace display {
+
+class ColumnLayout {
+public:
+  using print_func = char* (*)(char* first, char* last, core::Download* d);
+
+  struct column_type {
+    const char* name;
+    const char* header;
+    print_func  print;
+  };
+
+  static constexpr const char* default_columns =
+    "name,status,downloaded,size,done,up_rate,down_rate,uploaded,eta,ratio,"
+    "misc";
+
+  // Throws input_error on unknown or missing column names.
+  explicit ColumnLayout(const std::string& spec);
+
+  const std::string& spec() const {
+    return m_spec;
+  }
+  size_t size() const {
+    return m_columns.size();
+  }
+
+  char* print_header(char* first, char* last) const;
+  char* print(char* first, char* last, core::Download* d) const;
+
+  // Comma separated names of all columns.
+  static std::string column_names();
+
+private:
+  std::string                     m_spec;
+  std::vector<const column_type*> m_columns;
+};
+
+// Set through the 'ui.torrent_list.layout' and 'ui.torrent_list.columns'
+// commands.
+struct DownloadListLayout {
+  std::string  name{ "full" };
+  ColumnLayout columns{ ColumnLayout::default_columns };
+};
+
+extern DownloadListLayout downloadListLayout;
+
+}
+
+#endif
@@ -13,13 +13,32 @@ namespace display {
 
 class Window;
 
+// Windows redraw themselves periodically, e.g. every second for the
+// clock and transfer rates. When there has been no input for an idle
+// period those redraws are delayed, doubling the delay for every
+// further idle period up to 'max_idle_delay' seconds, and input brings
+// all windows up to date again. Without a terminal, as when running
+// as a daemon, windows aren't scheduled at all.
 class Manager {
 public:
+  static constexpr uint32_t default_idle_period = 30;
+  static constexpr uint32_t max_idle_delay      = 16;
+
   Manager();
   ~Manager();
 
   void force_redraw();
 
+  // Seconds without input before slowing down, 0 to never slow down.
+  uint32_t idle_period() const {
+    return m_idlePeriod;
+  }
+  void set_idle_period(uint32_t seconds) {
+    m_idlePeriod = seconds;
+  }
+
+  void receive_activity();
+
   void schedule(Window* w, torrent::utils::timer t);
   void unschedule(Window* w);
 
@@ -34,8 +53,14 @@ public:
 private:
   void schedule_update(uint32_t minInterval);
 
+  torrent::utils::timer idle_delay() const;
+
   bool                  m_forceRedraw{ false };
+  bool                  m_redrawAll{ false };
+  bool                  m_idle{ false };
+  uint32_t              m_idlePeriod{ default_idle_period };
   torrent::utils::timer m_timeLastUpdate;
+  torrent::utils::timer m_timeLastActivity;
 
   torrent::utils::priority_queue_default m_scheduler;
   torrent::utils::priority_item          m_taskUpdate;
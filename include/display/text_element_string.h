@@ -212,12 +212,21 @@ public:
   }
 
 protected:
+  // The command is parsed on the first print rather than every time,
+  // with its '$command=' arguments turned into function objects.
+  void        compile();
+  static void compile_object(torrent::Object* object);
+
   int         m_flags;
   int         m_attributes;
   extent_type m_length;
 
   const char* m_command;
   const char* m_commandEnd;
+
+  bool            m_compiled{ false };
+  std::string     m_key;
+  torrent::Object m_args;
 };
 
 namespace helpers {
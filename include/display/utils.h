@@ -4,6 +4,7 @@
 #ifndef RTORRENT_DISPLAY_UTILS_H
 #define RTORRENT_DISPLAY_UTILS_H
 
+#include <cinttypes>
 #include <cstdio>
 #include <ctime>
 #include <string>
@@ -37,6 +38,16 @@ print_ddhhmm(char* first, char* last, time_t t);
 char*
 print_ddmmyyyy(char* first, char* last, time_t t);
 
+// Print straight from the download what the 'd.ratio', 'd.tied_to_file',
+// 'd.ignore_commands', 'd.priority_str' and 'd.throttle_name' commands
+// would return, as the download list does for every row.
+char*
+print_download_ratio(char* first, char* last, core::Download* d);
+char*
+print_download_flags(char* first, char* last, core::Download* d);
+char*
+print_download_misc(char* first, char* last, core::Download* d);
+
 char*
 print_download_title(char* first, char* last, core::Download* d);
 char*
@@ -44,10 +55,10 @@ print_download_info_full(char* first, char* last, core::Download* d);
 char*
 print_download_status(char* first, char* last, core::Download* d);
 
-char*
-print_download_column_compact(char* first, char* last);
-char*
-print_download_info_compact(char* first, char* last, core::Download* d);
+// Changes whenever anything shown by the download print functions
+// above might have changed, without going through the command map.
+uint64_t
+download_signature(core::Download* d);
 
 char*
 print_download_time_left(char* first, char* last, core::Download* d);
@@ -4,12 +4,22 @@
 #ifndef RTORRENT_DISPLAY_WINDOW_DOWNLOAD_LIST_H
 #define RTORRENT_DISPLAY_WINDOW_DOWNLOAD_LIST_H
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "core/download_list.h"
 #include "core/view.h"
 #include "display/window.h"
 
 namespace display {
 
+class ColumnLayout;
+
+// The rows of each visible download are kept along with a signature
+// of the download's state, and only rendered again once it changes.
+// Lines identical to those already in the window are not printed.
+
 class WindowDownloadList : public Window {
 public:
   using signal_void_itr = core::View::signal_void::iterator;
@@ -22,9 +32,36 @@ public:
   void set_view(core::View* l);
 
 private:
+  struct row_type {
+    uint64_t                 signature{ 0 };
+    std::vector<std::string> lines;
+  };
+
+  struct line_type {
+    std::string text;
+    int         attributes{ A_NORMAL };
+  };
+
+  using row_map = std::unordered_map<core::Download*, row_type>;
+
+  // Renders the full layout if 'columns' is null.
+  static void render_row(row_type*           row,
+                         core::Download*     download,
+                         const ColumnLayout* columns,
+                         char*               first,
+                         char*               last);
+
+  void print_line(unsigned int y, const std::string& text, int attributes);
+  void clear_lines(unsigned int y);
+
   core::View* m_view{ nullptr };
 
   signal_void_itr m_changed_itr;
+
+  std::string            m_layout;
+  unsigned int           m_width{ 0 };
+  row_map                m_rows;
+  std::vector<line_type> m_lines;
 };
 
 }
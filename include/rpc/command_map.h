@@ -12,6 +12,10 @@
 
 #include "rpc/command.h"
 
+namespace utils {
+class LatencyHistogram;
+}
+
 namespace rpc {
 
 struct command_map_comp {
@@ -41,6 +45,9 @@ struct command_map_data_type {
 
   const char* m_parm;
   const char* m_doc;
+
+  // Looked up in the profiler on the first call.
+  utils::LatencyHistogram* m_profile{ nullptr };
 };
 
 class CommandMap
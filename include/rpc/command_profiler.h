@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Call counts and latency histograms for commands and RPC requests.
+//
+// Every command called through CommandMap is timed, including the
+// commands it calls in turn, so a slow view column or event handler
+// shows up under its own name. RPC requests are further split into
+// the time spent queued for the main thread and the time it spent
+// calling their commands.
+//
+// Commands are always called with the global lock held, which also
+// guards their histograms. The RPC histograms have a mutex of their
+// own.
+
+#ifndef RTORRENT_RPC_COMMAND_PROFILER_H
+#define RTORRENT_RPC_COMMAND_PROFILER_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <torrent/object.h>
+
+#include "utils/latency_histogram.h"
+
+namespace rpc {
+
+class CommandProfiler {
+public:
+  using histogram_type = utils::LatencyHistogram;
+  using command_map    = std::map<std::string, histogram_type>;
+
+  bool is_enabled() const {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+  void set_enabled(bool state) {
+    m_enabled.store(state, std::memory_order_relaxed);
+  }
+
+  // The returned histogram stays valid for the lifetime of the
+  // profiler, 'reset' only clears the counters.
+  histogram_type* command(const char* key) {
+    return &m_commands[key];
+  }
+
+  // Time from a request having been read until its reply is ready.
+  void insert_rpc_request(uint64_t usec);
+
+  // Time a request spent queued for the main thread, and then being
+  // handled by it.
+  void insert_rpc_lock(uint64_t waitUsec, uint64_t holdUsec);
+
+  void reset();
+
+  // Map of command name to histogram, for commands called at least
+  // once, limited to the 'limit' most expensive by total time if not
+  // zero.
+  torrent::Object commands_object(uint32_t limit) const;
+  torrent::Object rpc_object() const;
+
+private:
+  std::atomic<bool> m_enabled{ true };
+
+  command_map m_commands;
+
+  mutable std::mutex m_rpcMutex;
+  histogram_type     m_rpcRequest;
+  histogram_type     m_rpcLockWait;
+  histogram_type     m_rpcLockHold;
+};
+
+}
+
+#endif
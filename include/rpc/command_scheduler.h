@@ -5,8 +5,13 @@
 #define RTORRENT_COMMAND_SCHEDULER_H
 
 #include <cstdint>
+#include <functional>
+#include <list>
 #include <string>
-#include <vector>
+#include <unordered_map>
+
+#include <torrent/utils/priority_queue_default.h>
+#include <torrent/utils/timer.h>
 
 namespace torrent {
 class Object;
@@ -16,17 +21,43 @@ namespace rpc {
 
 class CommandSchedulerItem;
 
-class CommandScheduler : public std::vector<CommandSchedulerItem*> {
+// Items are indexed by key and queued on a hierarchical timer wheel
+// with one second resolution, so that inserting, erasing and firing
+// an item doesn't depend on the number of items scheduled. Only the
+// wheel itself is queued in the task scheduler, for the next second
+// that has something to do. Items due in the same second are called in
+// the order they were enabled.
+class CommandScheduler {
 public:
-  using SlotString = std::function<void(const std::string&)>;
-  using Time       = std::pair<int, int>;
-  using base_type  = std::vector<CommandSchedulerItem*>;
+  using SlotString     = std::function<void(const std::string&)>;
+  using Time           = std::pair<int, int>;
+  using container_type = std::unordered_map<std::string, CommandSchedulerItem*>;
+  using iterator       = container_type::iterator;
+  using value_type     = CommandSchedulerItem*;
+
+  static constexpr unsigned int wheel_bits   = 6;
+  static constexpr unsigned int wheel_size   = 1 << wheel_bits;
+  static constexpr unsigned int wheel_mask   = wheel_size - 1;
+  static constexpr unsigned int wheel_levels = 4;
+
+  CommandScheduler();
+  ~CommandScheduler();
+  CommandScheduler(const CommandScheduler&) = delete;
+  void operator=(const CommandScheduler&) = delete;
 
-  using base_type::begin;
-  using base_type::end;
-  using base_type::value_type;
+  iterator begin() {
+    return m_items.begin();
+  }
+  iterator end() {
+    return m_items.end();
+  }
 
-  ~CommandScheduler();
+  size_t size() const {
+    return m_items.size();
+  }
+  size_t size_queued() const {
+    return m_queued;
+  }
 
   void set_slot_error_message(SlotString s) {
     m_slotErrorMessage = s;
@@ -34,7 +65,9 @@ public:
 
   // slot_error_message or something.
 
-  iterator find(const std::string& key);
+  iterator find(const std::string& key) {
+    return m_items.find(key);
+  }
 
   // If the key already exists then the old item is deleted. It is
   // safe to call erase on end().
@@ -44,6 +77,10 @@ public:
     erase(find(key));
   }
 
+  // The time is rounded down to whole seconds.
+  void enable(value_type item, torrent::utils::timer t);
+  void disable(value_type item);
+
   void parse(const std::string&     key,
              const std::string&     bufAbsolute,
              const std::string&     bufInterval,
@@ -55,8 +92,28 @@ public:
   static Time parse_time(const char* str);
 
 private:
+  using slot_type = std::list<value_type>;
+
   void call_item(value_type item);
 
+  void wheel_insert(value_type item);
+  bool wheel_cascade(unsigned int level);
+  void wheel_run();
+  void wheel_update_task();
+
+  container_type m_items;
+  value_type     m_calling{ nullptr };
+
+  // Every level covers wheel_size times the range of the one below,
+  // items further out than the top level are cascaded back into it.
+  slot_type m_wheel[wheel_levels][wheel_size];
+  uint64_t  m_wheelTime{ 0 };
+  uint64_t  m_sequence{ 0 };
+  size_t    m_queued{ 0 };
+
+  torrent::utils::priority_item m_task;
+  uint64_t                      m_taskTime{ 0 };
+
   SlotString m_slotErrorMessage = nullptr;
 };
 
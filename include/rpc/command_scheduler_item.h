@@ -4,7 +4,7 @@
 #ifndef RTORRENT_COMMAND_SCHEDULER_ITEM_H
 #define RTORRENT_COMMAND_SCHEDULER_ITEM_H
 
-#include <functional>
+#include <list>
 
 #include <torrent/object.h>
 
@@ -14,22 +14,18 @@ namespace rpc {
 
 class CommandSchedulerItem {
 public:
-  using slot_void = std::function<void()>;
+  friend class CommandScheduler;
 
   CommandSchedulerItem(const std::string& key)
     : m_key(key)
     , m_interval(0) {}
-  ~CommandSchedulerItem();
   CommandSchedulerItem(const CommandSchedulerItem&) = delete;
   void operator=(const CommandSchedulerItem&) = delete;
 
   bool is_queued() const {
-    return m_task.is_queued();
+    return m_slot != nullptr;
   }
 
-  void enable(torrent::utils::timer t);
-  void disable();
-
   const std::string& key() const {
     return m_key;
   }
@@ -50,20 +46,21 @@ public:
   }
   torrent::utils::timer next_time_scheduled() const;
 
-  slot_void& slot() {
-    return m_task.slot();
-  }
-
 private:
+  using slot_type = std::list<CommandSchedulerItem*>;
+
   std::string     m_key;
   torrent::Object m_command;
 
   uint32_t              m_interval;
   torrent::utils::timer m_timeScheduled;
 
-  torrent::utils::priority_item m_task;
-
-  // Flags for various things.
+  // Position in the scheduler's timer wheel, in seconds, and the order
+  // in which items due in the same second are called.
+  uint64_t            m_expires{ 0 };
+  uint64_t            m_sequence{ 0 };
+  slot_type*          m_slot{ nullptr };
+  slot_type::iterator m_slotItr;
 };
 
 }
@@ -6,6 +6,8 @@
 
 #include <torrent/object.h>
 
+#include "rpc/process_spawner.h"
+
 namespace rpc {
 
 class ExecFile {
@@ -23,6 +25,11 @@ public:
   }
   void set_log_fd(int fd) {
     m_logFd = fd;
+    m_spawner.set_log_fd(fd);
+  }
+
+  ProcessSpawner* spawner() {
+    return &m_spawner;
   }
 
   int execute(const char* file, char* const* argv, int flags);
@@ -30,8 +37,12 @@ public:
   torrent::Object execute_object(const torrent::Object& rawArgs, int flags);
 
 private:
-  int         m_logFd{ -1 };
-  std::string m_capture;
+  void read_capture(int* pipeFd);
+  void log_status(int status);
+
+  int            m_logFd{ -1 };
+  std::string    m_capture;
+  ProcessSpawner m_spawner;
 };
 
 }
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "rpc/command_map.h"
+#include "rpc/command_profiler.h"
 #include "rpc/exec_file.h"
 #include "rpc/rpc_manager.h"
 
@@ -18,9 +19,10 @@ class Download;
 namespace rpc {
 
 // Move to another file?
-extern CommandMap commands;
-extern RpcManager rpc;
-extern ExecFile   execFile;
+extern CommandMap      commands;
+extern RpcManager      rpc;
+extern ExecFile        execFile;
+extern CommandProfiler profiler;
 
 using parse_command_type = std::pair<torrent::Object, const char*>;
 
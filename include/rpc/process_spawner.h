@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Runs external commands through a small helper process.
+//
+// Forking the client itself duplicates the page tables of its whole
+// resident set, and the copy-on-write faults that follow stall the
+// main loop when many commands run in a row. The helper is forked
+// before anything else is set up, keeps no other descriptors open and
+// does the forking instead.
+//
+// Commands are sent over a SOCK_SEQPACKET socket pair, together with
+// the descriptors to use for their output and the client's current
+// working directory and umask, which the helper applies before exec.
+// Synchronous calls get their exit status back through a pipe of their
+// own, so concurrent callers don't need to share replies. Asynchronous
+// commands are limited in number, queue up beyond that, and report
+// back through the socket which is polled by the main thread. They run
+// in a session of their own with output to /dev/null, like the
+// detached processes previously forked for them.
+
+#ifndef RTORRENT_RPC_PROCESS_SPAWNER_H
+#define RTORRENT_RPC_PROCESS_SPAWNER_H
+
+#include <cinttypes>
+#include <deque>
+#include <map>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include <torrent/event.h>
+
+namespace rpc {
+
+class ProcessSpawner : public torrent::Event {
+public:
+  using argument_list = std::vector<std::string>;
+
+  struct stats_type {
+    uint64_t count{ 0 };
+    uint64_t failed{ 0 };
+    uint64_t total_usec{ 0 };
+    uint64_t max_usec{ 0 };
+  };
+
+  using stats_map = std::map<std::string, stats_type>;
+
+  static constexpr uint32_t max_request_size = 64 << 10;
+
+  ~ProcessSpawner() override;
+
+  const char* type_name() const override {
+    return "process_spawner";
+  }
+
+  bool is_open() const {
+    return m_fileDesc != -1;
+  }
+
+  // Forks the helper, must be called before any threads are started.
+  void open();
+
+  // The helper exits once its socket is closed, and is reaped without
+  // waiting for it.
+  void close();
+
+  // Registers with the main thread's poll for asynchronous replies.
+  void activate();
+  void deactivate();
+
+  void set_log_fd(int fd) {
+    m_logFd = fd;
+  }
+
+  // The umask can't be read without changing it, so the client tells
+  // the spawner when it sets a new one.
+  mode_t umask() const {
+    return m_umask;
+  }
+  void set_umask(mode_t mask) {
+    m_umask = mask;
+  }
+
+  uint32_t max_running() const {
+    return m_maxRunning;
+  }
+  void set_max_running(uint32_t v);
+
+  uint32_t size_running() const {
+    return m_running.size();
+  }
+  uint32_t size_queued() const {
+    return m_queue.size();
+  }
+
+  const stats_map& stats() const {
+    return m_stats;
+  }
+  void clear_stats() {
+    m_stats.clear();
+  }
+
+  // Starts the command with standard output going to 'captureFd' if
+  // not -1, returning the descriptor to pass to 'wait'. The caller
+  // should release the global lock while waiting, and 'record' the
+  // result once it holds it again.
+  int  spawn(char* const* argv, int captureFd);
+  bool wait(int replyFd, int* status, uint64_t* elapsedUsec);
+
+  // Queues the command, it is started as soon as fewer than
+  // 'max_running' commands are running.
+  void execute_async(argument_list args);
+
+  void record(const std::string& name, int status, uint64_t elapsedUsec);
+
+  void event_read() override;
+  void event_write() override;
+  void event_error() override;
+
+private:
+  uint64_t send(char* const* argv, int captureFd, int replyFd);
+  void     start_queued();
+
+  int      m_logFd{ -1 };
+  int      m_helperPid{ -1 };
+  mode_t   m_umask{ 022 };
+  uint64_t m_lastId{ 0 };
+  uint32_t m_maxRunning{ 16 };
+
+  std::map<uint64_t, std::string> m_running;
+  std::deque<argument_list>       m_queue;
+  stats_map                       m_stats;
+};
+
+}
+
+#endif
@@ -4,6 +4,8 @@
 #ifndef RTORRENT_RPC_SCGI_TASK_H
 #define RTORRENT_RPC_SCGI_TASK_H
 
+#include <cstdint>
+
 #include <torrent/event.h>
 
 namespace utils {
@@ -29,6 +31,12 @@ public:
     return m_type;
   }
 
+  // Incremented every time the task is opened, so that replies for
+  // an earlier connection can be told apart.
+  uint64_t generation() const {
+    return m_generation;
+  }
+
   bool is_open() const {
     return m_fileDesc != -1;
   }
@@ -55,6 +63,7 @@ private:
                              uint32_t    bufferSize = 0);
 
   ContentType m_type{ XML };
+  uint64_t    m_generation{ 0 };
 
   SCgi* m_parent;
 
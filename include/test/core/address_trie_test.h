@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/address_trie.h"
+
+class AddressTrieTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/choke_group_manager.h"
+
+class ChokeGroupManagerTest : public ::testing::Test {};
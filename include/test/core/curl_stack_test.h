@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/curl_stack.h"
+
+class CurlStackTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/hash_scheduler.h"
+
+class HashSchedulerTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/queue_manager.h"
+
+class QueueManagerTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/scrape_batcher.h"
+
+class ScrapeBatcherTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/search_index.h"
+
+class SearchIndexTest : public ::testing::Test {};
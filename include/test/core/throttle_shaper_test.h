@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "core/throttle_shaper.h"
+
+class ThrottleShaperTest : public ::testing::Test {};
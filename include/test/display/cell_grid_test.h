@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "display/cell_grid.h"
+
+class CellGridTest : public ::testing::Test {};
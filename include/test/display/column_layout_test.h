@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "display/column_layout.h"
+
+class ColumnLayoutTest : public ::testing::Test {};
@@ -0,0 +1,7 @@
+#include <gtest/gtest.h>
+
+class RenderBenchmarkTest : public ::testing::Test {
+public:
+  void SetUp() override;
+  void TearDown() override;
+};
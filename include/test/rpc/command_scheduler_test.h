@@ -0,0 +1,9 @@
+#include <gtest/gtest.h>
+
+#include "rpc/command_scheduler.h"
+
+class CommandSchedulerTest : public ::testing::Test {
+public:
+  void SetUp() override;
+  void TearDown() override;
+};
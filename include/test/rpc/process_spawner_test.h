@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "rpc/process_spawner.h"
+
+class ProcessSpawnerTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "ui/file_list_index.h"
+
+class FileListIndexTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "ui/peer_list_index.h"
+
+class PeerListIndexTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "utils/bencode_decoder.h"
+
+class BencodeDecoderTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "utils/latency_histogram.h"
+
+class LatencyHistogramTest : public ::testing::Test {};
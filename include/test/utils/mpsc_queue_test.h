@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "utils/mpsc_queue.h"
+
+class MpscQueueTest : public ::testing::Test {};
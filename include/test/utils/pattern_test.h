@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "utils/pattern.h"
+
+class PatternTest : public ::testing::Test {};
@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "utils/trace_ring.h"
+
+class TraceRingTest : public ::testing::Test {};
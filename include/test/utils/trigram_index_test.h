@@ -0,0 +1,5 @@
+#include <gtest/gtest.h>
+
+#include "utils/trigram_index.h"
+
+class TrigramIndexTest : public ::testing::Test {};
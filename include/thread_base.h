@@ -4,6 +4,7 @@
 #ifndef RTORRENT_UTILS_THREAD_BASE_H
 #define RTORRENT_UTILS_THREAD_BASE_H
 
+#include <functional>
 #include <sys/types.h>
 
 #include <torrent/utils/priority_queue_default.h>
@@ -13,12 +14,12 @@
 
 // Move this class to libtorrent.
 
-class thread_queue_hack;
+class ThreadQueue;
 
 class ThreadBase : public torrent::thread_base {
 public:
   using priority_queue   = torrent::utils::priority_queue_default;
-  using thread_base_func = void (*)(ThreadBase*);
+  using thread_base_func = std::function<void(ThreadBase*)>;
 
   ThreadBase();
   ~ThreadBase() override;
@@ -31,13 +32,17 @@ public:
   static void stop_thread(ThreadBase* thread);
 
   // ATM, only interaction with a thread's allowed by other threads is
-  // through the queue_item call.
+  // through the queue_item call. Items are called in order from the
+  // thread's own loop, throws internal_error if the queue is full.
 
   void queue_item(thread_base_func newFunc);
 
 protected:
   int64_t next_timeout_usec() override;
 
+  // Registers the queue's wakeup descriptor with the thread's poll,
+  // call once the poll has been created.
+  void attach_queue();
   void call_queued_items();
   void call_events() override;
 
@@ -49,9 +54,8 @@ protected:
 
   torrent::utils::priority_item m_taskShutdown;
 
-  // Temporary hack to pass messages to a thread. This really needs to
-  // be cleaned up and/or integrated into the priority queue itself.
-  thread_queue_hack* m_threadQueue;
+  // Bounded ring of closures passed to the thread by others.
+  ThreadQueue* m_threadQueue;
 };
 
 #endif
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
+
+#ifndef RTORRENT_THREAD_QUEUE_H
+#define RTORRENT_THREAD_QUEUE_H
+
+#include <atomic>
+#include <functional>
+
+#include <torrent/event.h>
+#include <torrent/utils/cacheline.h>
+
+#include "utils/mpsc_queue.h"
+
+namespace torrent {
+class Poll;
+}
+
+// Closures queued by other threads. The owning thread is woken up
+// through an eventfd, or a pipe where that isn't available, which is
+// only written to when the thread hasn't already been signaled since
+// it last emptied the queue.
+//
+// Worker threads own one through ThreadBase, the main thread's is
+// owned by Control and registered with libtorrent's main poll.
+class lt_cacheline_aligned ThreadQueue : public torrent::Event {
+public:
+  using value_type = std::function<void()>;
+
+  static constexpr unsigned int max_size = 256;
+
+  ThreadQueue();
+  ~ThreadQueue() override;
+
+  const char* type_name() const override {
+    return "thread_queue";
+  }
+
+  bool empty() const {
+    return m_queue.empty();
+  }
+
+  // Safe to call from any thread, attach and detach are only called by
+  // the owning thread.
+  bool is_attached() const {
+    return m_poll.load(std::memory_order_acquire) != nullptr;
+  }
+
+  void attach(torrent::Poll* poll);
+  void detach();
+
+  // Throws internal_error if the queue is full.
+  void push_back(value_type v);
+  void call_all();
+
+  void event_read() override;
+  void event_write() override {}
+  void event_error() override;
+
+private:
+  void clear_signal();
+
+  utils::MpscQueue<value_type> m_queue{ max_size };
+
+  std::atomic<torrent::Poll*> m_poll{ nullptr };
+  int                         m_writeFd{ -1 };
+  std::atomic<bool>           m_signaled{ false };
+};
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "core/download.h"
 #include "ui/element_base.h"
+#include "ui/file_list_index.h"
 
 namespace display {
 class WindowFileList;
@@ -42,6 +43,12 @@ public:
   iterator selected() const {
     return m_selected;
   }
+  uint32_t selected_row() const {
+    return m_selectedRow;
+  }
+  const FileListIndex& index() const {
+    return m_index;
+  }
   core::Download* download() const {
     return m_download;
   }
@@ -58,6 +65,7 @@ private:
   void receive_change_all();
   void receive_collapse();
 
+  void set_selected_row(uint32_t row);
   void update_itr();
 
   core::Download* m_download;
@@ -66,8 +74,11 @@ private:
   WFileList*   m_window;
   ElementText* m_elementInfo;
 
-  // Change to unsigned, please.
+  FileListIndex m_index;
+
+  // The iterator is kept for the info element's target.
   iterator m_selected;
+  uint32_t m_selectedRow{ 0 };
   bool     m_collapsed;
 };
 
@@ -8,6 +8,7 @@
 
 #include "core/download.h"
 #include "ui/element_base.h"
+#include "ui/peer_list_index.h"
 
 namespace ui {
 
@@ -15,8 +16,6 @@ class ElementText;
 
 class ElementPeerList : public ElementBase {
 public:
-  using PList = std::list<torrent::Peer*>;
-
   using signal_connection = torrent::ConnectionList::signal_peer_type::iterator;
 
   using Display = enum { DISPLAY_LIST, DISPLAY_INFO, DISPLAY_MAX_SIZE };
@@ -52,8 +51,7 @@ private:
 
   ElementText* m_elementInfo;
 
-  PList           m_list;
-  PList::iterator m_listItr;
+  PeerListIndex m_peers;
 
   signal_connection m_peer_connected;
   signal_connection m_peer_disconnected;
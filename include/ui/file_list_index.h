@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// The file list of a download flattened into the rows shown by the
+// file list window, in FileListIterator order: a row for entering
+// each directory, one for each file and one for leaving each
+// directory.
+//
+// Stepping over a collapsed directory with FileListIterator walks
+// every file below it, which for torrents with a huge directory makes
+// each key press and redraw visit all of its files. The index resolves
+// those steps once, when the file list is opened, so moving the
+// selection and drawing the visible rows only touch the rows involved.
+
+#ifndef RTORRENT_UI_FILE_LIST_INDEX_H
+#define RTORRENT_UI_FILE_LIST_INDEX_H
+
+#include <cinttypes>
+#include <torrent/data/file_list_iterator.h>
+#include <vector>
+
+namespace torrent {
+class FileList;
+}
+
+namespace ui {
+
+// The links only depend on how Iterator steps, so they can be checked
+// against other iterators than FileListIterator.
+template<typename Iterator>
+class basic_file_list_index {
+public:
+  using iterator = Iterator;
+
+  basic_file_list_index(iterator first, iterator last);
+
+  // Rows are numbered from zero, with 'size()' standing for the end.
+  uint32_t size() const {
+    return m_rows.size() - 1;
+  }
+  bool empty() const {
+    return size() == 0;
+  }
+
+  const iterator& at(uint32_t row) const {
+    return m_rows[row].itr;
+  }
+
+  // Same as FileListIterator's forward_current_depth and
+  // backward_current_depth, which skip over collapsed directories.
+  uint32_t forward(uint32_t row) const {
+    return m_rows[row].forward;
+  }
+  uint32_t backward(uint32_t row) const {
+    return m_rows[row].backward;
+  }
+
+  uint32_t next(uint32_t row, bool collapsed) const {
+    return collapsed ? forward(row) : row + 1;
+  }
+  uint32_t prev(uint32_t row, bool collapsed) const {
+    return collapsed ? backward(row) : row - 1;
+  }
+
+private:
+  struct row_type {
+    iterator itr;
+    uint32_t forward{ 0 };
+    uint32_t backward{ 0 };
+  };
+
+  std::vector<row_type> m_rows;
+};
+
+// The links are found by stepping a copy of each row's iterator and
+// looking for the result among the rows it skipped, so they can't
+// disagree with the iterator. Each directory is crossed once per
+// level above it, bounding the work by the number of rows times the
+// depth of the tree.
+template<typename Iterator>
+basic_file_list_index<Iterator>::basic_file_list_index(iterator first,
+                                                       iterator last) {
+  for (iterator itr = first; itr != last; ++itr)
+    m_rows.push_back(row_type{ itr });
+
+  m_rows.push_back(row_type{ last });
+
+  uint32_t end = size();
+
+  for (uint32_t row = 0; row != end; row++) {
+    iterator target = m_rows[row].itr;
+    target.forward_current_depth();
+
+    uint32_t found = row + 1;
+
+    while (found != end && m_rows[found].itr != target)
+      found++;
+
+    m_rows[row].forward = found;
+  }
+
+  m_rows[end].forward = end;
+
+  for (uint32_t row = 1; row <= end; row++) {
+    iterator target = m_rows[row].itr;
+    target.backward_current_depth();
+
+    uint32_t found = row - 1;
+
+    while (found != 0 && m_rows[found].itr != target)
+      found--;
+
+    m_rows[row].backward = found;
+  }
+}
+
+class FileListIndex : public basic_file_list_index<torrent::FileListIterator> {
+public:
+  explicit FileListIndex(torrent::FileList* fileList);
+};
+
+}
+
+#endif
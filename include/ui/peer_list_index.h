@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// The peers shown by the peer list window and the focused one.
+//
+// The position of each peer in the list is kept in a hash map, so
+// large swarms don't scan the list on every disconnect.
+
+#ifndef RTORRENT_UI_PEER_LIST_INDEX_H
+#define RTORRENT_UI_PEER_LIST_INDEX_H
+
+#include <list>
+#include <unordered_map>
+
+namespace torrent {
+class Peer;
+}
+
+namespace ui {
+
+class PeerListIndex {
+public:
+  using list_type = std::list<torrent::Peer*>;
+  using iterator  = list_type::iterator;
+
+  PeerListIndex() = default;
+  PeerListIndex(const PeerListIndex&) = delete;
+  void operator=(const PeerListIndex&) = delete;
+
+  size_t size() const {
+    return m_list.size();
+  }
+  bool has(torrent::Peer* peer) const {
+    return m_positions.find(peer) != m_positions.end();
+  }
+
+  // The window draws the list and focus directly.
+  list_type* list() {
+    return &m_list;
+  }
+  iterator* focus() {
+    return &m_focus;
+  }
+
+  // Returns nullptr if no peer is focused.
+  torrent::Peer* focused() const {
+    return m_focus != m_list.end() ? *m_focus : nullptr;
+  }
+
+  void insert(torrent::Peer* peer);
+
+  // Erasing the focused peer moves the focus to the next one. Throws
+  // internal_error if the peer isn't in the list.
+  void erase(torrent::Peer* peer);
+
+  // Cycles through the peers and the end of the list, which stands
+  // for no focus.
+  void next();
+  void prev();
+
+private:
+  list_type m_list;
+  iterator  m_focus{ m_list.end() };
+
+  std::unordered_map<torrent::Peer*, iterator> m_positions;
+};
+
+}
+
+#endif
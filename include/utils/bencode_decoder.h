@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Incremental bencode decoder that builds a torrent::Object as data
+// arrives, so that downloaded torrents don't need to be buffered in
+// full before parsing. Strings are appended directly to their final
+// location in the object tree.
+
+#ifndef RTORRENT_UTILS_BENCODE_DECODER_H
+#define RTORRENT_UTILS_BENCODE_DECODER_H
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+namespace torrent {
+class Object;
+}
+
+namespace utils {
+
+class BencodeDecoder {
+public:
+  static constexpr unsigned int max_depth = 1024;
+
+  // A max size of zero disables the size limit.
+  BencodeDecoder(uint64_t maxSize = 0);
+  ~BencodeDecoder();
+  BencodeDecoder(const BencodeDecoder&) = delete;
+  void operator=(const BencodeDecoder&) = delete;
+
+  bool is_done() const {
+    return m_state == state_done;
+  }
+  bool is_error() const {
+    return m_state == state_error;
+  }
+  const std::string& error() const {
+    return m_error;
+  }
+
+  uint64_t size() const {
+    return m_size;
+  }
+  uint64_t max_size() const {
+    return m_maxSize;
+  }
+
+  // Returns false if the input is malformed or exceeds the size
+  // limit, after which error() describes the problem. Any data
+  // following the root object is ignored.
+  bool write(const char* data, size_t length);
+
+  // Transfers ownership of the decoded object, which must be done.
+  torrent::Object* release();
+
+private:
+  enum state_type {
+    state_value,
+    state_integer,
+    state_string_length,
+    state_string,
+    state_key_length,
+    state_key,
+    state_done,
+    state_error
+  };
+
+  struct frame_type {
+    torrent::Object* object;
+    std::string      last_key;
+  };
+
+  bool set_error(const char* msg);
+
+  bool begin_value(char c);
+  bool begin_key(char c);
+  bool end_container();
+  void end_value();
+
+  bool read_length(char c);
+  bool read_integer(char c);
+
+  size_t read_string(const char* data, size_t length);
+  size_t read_key(const char* data, size_t length);
+
+  state_type  m_state{ state_value };
+  std::string m_error;
+
+  uint64_t m_size{ 0 };
+  uint64_t m_maxSize;
+
+  torrent::Object*        m_root;
+  torrent::Object*        m_target;
+  std::vector<frame_type> m_stack;
+
+  int64_t     m_integer{ 0 };
+  bool        m_negative{ false };
+  bool        m_hasDigits{ false };
+  uint64_t    m_length{ 0 };
+  std::string m_key;
+};
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Log-linear histogram of durations in microseconds.
+//
+// As in HDR histograms, each power of two is split into a fixed number
+// of linear sub-buckets, so percentiles are accurate to within 12.5%
+// of the value at any scale while the histogram stays a flat array of
+// a few hundred counters.
+
+#ifndef RTORRENT_UTILS_LATENCY_HISTOGRAM_H
+#define RTORRENT_UTILS_LATENCY_HISTOGRAM_H
+
+#include <cinttypes>
+
+#include <torrent/object.h>
+
+namespace utils {
+
+class LatencyHistogram {
+public:
+  static constexpr uint32_t sub_bits     = 3;
+  static constexpr uint32_t sub_count    = 1 << sub_bits;
+  static constexpr uint32_t max_exponent = 35;
+  static constexpr uint32_t size = (max_exponent - sub_bits + 2) * sub_count;
+
+  uint64_t count() const {
+    return m_count;
+  }
+  uint64_t sum() const {
+    return m_sum;
+  }
+  uint64_t max() const {
+    return m_max;
+  }
+  uint64_t mean() const {
+    return m_count != 0 ? m_sum / m_count : 0;
+  }
+
+  void insert(uint64_t value);
+  void clear();
+
+  // Upper bound of the bucket holding the given percentile, clamped to
+  // the largest value seen.
+  uint64_t percentile(double p) const;
+
+  // Map of count, sum, mean, max and the usual percentiles.
+  torrent::Object to_object() const;
+
+  static uint32_t bucket_index(uint64_t value);
+  static uint64_t bucket_upper(uint32_t index);
+
+private:
+  uint64_t m_count{ 0 };
+  uint64_t m_sum{ 0 };
+  uint64_t m_max{ 0 };
+  uint32_t m_buckets[size]{};
+};
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Bounded multiple producer, single consumer ring.
+//
+// Each cell carries a sequence number telling whether it is free for
+// the producer at a given position or holds a value for the consumer.
+// Producers claim a position with a single compare-and-swap on the
+// tail and never wait on each other; a full ring is reported to the
+// caller instead of spinning. Only one thread may call 'pop'.
+
+#ifndef RTORRENT_UTILS_MPSC_QUEUE_H
+#define RTORRENT_UTILS_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <torrent/utils/cacheline.h>
+
+namespace utils {
+
+template<typename T>
+class MpscQueue {
+public:
+  using value_type = T;
+
+  // The capacity is rounded up to a power of two.
+  explicit MpscQueue(size_t capacity);
+  MpscQueue(const MpscQueue&) = delete;
+  void operator=(const MpscQueue&) = delete;
+
+  size_t capacity() const {
+    return m_mask + 1;
+  }
+
+  // Approximate when called concurrently with 'push'.
+  bool empty() const;
+
+  // Returns false if the ring is full, leaving 'value' untouched.
+  bool push(value_type&& value);
+
+  // Consumer side only.
+  bool pop(value_type& value);
+
+private:
+  struct cell_type {
+    std::atomic<size_t> sequence;
+    value_type          value;
+  };
+
+  std::unique_ptr<cell_type[]> m_cells;
+  size_t                       m_mask;
+
+  std::atomic<size_t> lt_cacheline_aligned m_tail{ 0 };
+  size_t lt_cacheline_aligned              m_head{ 0 };
+};
+
+template<typename T>
+MpscQueue<T>::MpscQueue(size_t capacity) {
+  if (capacity < 2)
+    capacity = 2;
+
+  size_t size = 1;
+
+  while (size < capacity)
+    size <<= 1;
+
+  m_cells.reset(new cell_type[size]);
+  m_mask = size - 1;
+
+  for (size_t i = 0; i != size; i++)
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool
+MpscQueue<T>::empty() const {
+  const cell_type& cell = m_cells[m_head & m_mask];
+
+  return cell.sequence.load(std::memory_order_acquire) != m_head + 1;
+}
+
+template<typename T>
+bool
+MpscQueue<T>::push(value_type&& value) {
+  size_t     pos = m_tail.load(std::memory_order_relaxed);
+  cell_type* cell;
+
+  while (true) {
+    cell = &m_cells[pos & m_mask];
+
+    size_t   sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t diff     = (intptr_t)sequence - (intptr_t)pos;
+
+    if (diff == 0) {
+      if (m_tail.compare_exchange_weak(
+            pos, pos + 1, std::memory_order_relaxed))
+        break;
+
+    } else if (diff < 0) {
+      // The consumer hasn't released this cell yet.
+      return false;
+
+    } else {
+      pos = m_tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->value = std::move(value);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template<typename T>
+bool
+MpscQueue<T>::pop(value_type& value) {
+  cell_type& cell = m_cells[m_head & m_mask];
+
+  if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+    return false;
+
+  value      = std::move(cell.value);
+  cell.value = value_type();
+  cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+
+  m_head++;
+  return true;
+}
+
+}
+
+#endif
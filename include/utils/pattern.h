@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Compiled regular expressions for the 'match' command and filters.
+//
+// Matches have std::regex_match semantics, the whole text must match
+// the ECMAScript pattern. Plain literals optionally surrounded by
+// '.*', which is what the download list filter produces, are matched
+// with a string search. Other patterns are compiled to a Thompson NFA
+// and simulated in time linear in the length of the text, unlike the
+// backtracking std::regex. The few constructs the NFA doesn't cover,
+// such as back-references and assertions, fall back to std::regex.
+//
+// PatternCache keeps compiled patterns by their source string, so a
+// filter applied to every download compiles its pattern once.
+
+#ifndef RTORRENT_UTILS_PATTERN_H
+#define RTORRENT_UTILS_PATTERN_H
+
+#include <bitset>
+#include <cinttypes>
+#include <memory>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+class Pattern {
+public:
+  enum type_enum {
+    TYPE_INVALID,
+    TYPE_EXACT,
+    TYPE_PREFIX,
+    TYPE_SUFFIX,
+    TYPE_CONTAINS,
+    TYPE_NFA,
+    TYPE_REGEX
+  };
+
+  static constexpr uint32_t max_program_size = 1 << 14;
+
+  // Never throws, invalid patterns never match and keep the error.
+  explicit Pattern(const std::string& pattern);
+
+  type_enum type() const {
+    return m_type;
+  }
+  bool is_valid() const {
+    return m_type != TYPE_INVALID;
+  }
+  const std::string& error() const {
+    return m_error;
+  }
+
+  bool match(const std::string& text) const;
+
+private:
+  enum op_enum : uint8_t {
+    OP_CHAR,
+    OP_ANY,
+    OP_CLASS,
+    OP_SPLIT,
+    OP_JUMP,
+    OP_LINE_BEGIN,
+    OP_LINE_END,
+    OP_MATCH
+  };
+
+  struct instruction {
+    op_enum  op;
+    uint8_t  c;
+    uint32_t x;
+    uint32_t y;
+  };
+
+  using class_type = std::bitset<256>;
+
+  friend class PatternCompiler;
+
+  bool compile_literal(const std::string& pattern);
+  bool match_nfa(const std::string& text) const;
+
+  type_enum   m_type{ TYPE_INVALID };
+  std::string m_error;
+  std::string m_literal;
+
+  std::vector<instruction> m_program;
+  std::vector<class_type>  m_classes;
+
+  std::unique_ptr<std::regex> m_regex;
+};
+
+class PatternCache {
+public:
+  static constexpr size_t max_size = 256;
+
+  size_t size() const {
+    return m_patterns.size();
+  }
+  void clear() {
+    m_patterns.clear();
+  }
+
+  // Compiles the pattern on first use, setting 'compiled' if given.
+  // Starts over once full, as filters tend to reuse a handful of
+  // patterns.
+  const Pattern& find(const std::string& pattern, bool* compiled = nullptr);
+
+private:
+  std::unordered_map<std::string, std::unique_ptr<Pattern>> m_patterns;
+};
+
+// Only used with the global lock held.
+extern PatternCache patternCache;
+
+}
+
+#endif
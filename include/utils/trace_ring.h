@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Binary trace of hot path events.
+//
+// Records have a fixed layout of a timestamp, an event id, the id of
+// the writing thread and a few integer arguments, so tracing costs a
+// clock read and a handful of stores rather than formatting a message.
+// Writers on any thread claim a slot with a single fetch-and-add and
+// overwrite the oldest record once the ring has wrapped around.
+//
+// 'log.trace.dump' writes the ring to a file, starting with a header
+// holding the event names so doc/scripts/trace_decode.py can turn it
+// into text without knowing this build.
+
+#ifndef RTORRENT_UTILS_TRACE_RING_H
+#define RTORRENT_UTILS_TRACE_RING_H
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+#include <torrent/utils/cacheline.h>
+
+namespace utils {
+
+// Append only, the ids are part of the dump format.
+enum trace_event : uint32_t {
+  TRACE_NONE,
+  TRACE_RPC_READ,          // fd, body size, content type
+  TRACE_RPC_WRITE,         // fd, reply size
+  TRACE_EXECUTE,           // status, elapsed usec
+  TRACE_DOWNLOAD_RESUME,   // hash prefix, flags
+  TRACE_DOWNLOAD_PAUSE,    // hash prefix, flags
+  TRACE_DOWNLOAD_HASH,     // hash prefix, hash checked
+  TRACE_DOWNLOAD_FINISHED, // hash prefix
+  TRACE_STALL,             // stalled usec, longest task usec
+  TRACE_EVENT_MAX
+};
+
+const char* trace_event_name(uint32_t event);
+
+class TraceRing {
+public:
+  static constexpr uint32_t max_args = 5;
+  static constexpr uint32_t size     = 8192;
+  static constexpr uint32_t version  = 1;
+
+  struct record_type {
+    uint64_t time_usec;
+    uint32_t event;
+    uint32_t thread;
+    int64_t  args[max_args];
+  };
+
+  static_assert((size & (size - 1)) == 0, "size must be a power of two");
+
+  TraceRing() = default;
+  TraceRing(const TraceRing&) = delete;
+  void operator=(const TraceRing&) = delete;
+
+  bool is_enabled() const {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+  void set_enabled(bool state) {
+    m_enabled.store(state, std::memory_order_relaxed);
+  }
+
+  // Number of records written since startup, including those that
+  // have since been overwritten.
+  uint64_t position() const {
+    return m_position.load(std::memory_order_relaxed);
+  }
+
+  void push(uint32_t event,
+            int64_t  arg0 = 0,
+            int64_t  arg1 = 0,
+            int64_t  arg2 = 0,
+            int64_t  arg3 = 0,
+            int64_t  arg4 = 0);
+
+  // Copies the records that are complete, oldest first. Records being
+  // written concurrently are skipped.
+  std::vector<record_type> snapshot() const;
+
+  // Throws input_error on write failure.
+  void dump(FILE* file) const;
+
+private:
+  struct slot_type {
+    std::atomic<uint64_t> sequence{ 0 };
+    record_type           record;
+  };
+
+  std::atomic<bool> m_enabled{ true };
+
+  std::atomic<uint64_t> lt_cacheline_aligned m_position{ 0 };
+  slot_type lt_cacheline_aligned             m_slots[size];
+};
+
+extern TraceRing traceRing;
+
+inline void
+trace(uint32_t event,
+      int64_t  arg0 = 0,
+      int64_t  arg1 = 0,
+      int64_t  arg2 = 0,
+      int64_t  arg3 = 0,
+      int64_t  arg4 = 0) {
+  if (traceRing.is_enabled())
+    traceRing.push(event, arg0, arg1, arg2, arg3, arg4);
+}
+
+}
+
+#endif
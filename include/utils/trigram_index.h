@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+// Case-insensitive substring search over a set of documents, each a
+// list of strings such as a download's name or its file paths.
+//
+// Every distinct (lowercased) three byte sequence of a document maps
+// to a sorted posting list of document ids. A query is answered by
+// intersecting the posting lists of its trigrams, shortest first, and
+// checking the few remaining candidates with a plain string search.
+// Queries shorter than a trigram check every document.
+
+#ifndef RTORRENT_UTILS_TRIGRAM_INDEX_H
+#define RTORRENT_UTILS_TRIGRAM_INDEX_H
+
+#include <cinttypes>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+class TrigramIndex {
+public:
+  using id_type   = uint32_t;
+  using text_list = std::vector<std::string>;
+
+  size_t size() const {
+    return m_documents.size() - m_free.size();
+  }
+  size_t trigram_count() const {
+    return m_postings.size();
+  }
+
+  // Returns the id of the new document, ids of erased documents are
+  // reused.
+  id_type insert(const text_list& texts);
+  void    erase(id_type id);
+
+  // Ascending ids of the documents with a text containing 'query'.
+  std::vector<id_type> search(const std::string& query) const;
+
+private:
+  struct document_type {
+    text_list texts;
+    bool      used{ false };
+  };
+
+  using posting_list = std::vector<id_type>;
+
+  static std::string           lowercase(const std::string& text);
+  static std::vector<uint32_t> trigrams(const text_list& texts);
+
+  bool contains(const document_type& document, const std::string& query) const;
+
+  std::vector<document_type> m_documents;
+  std::vector<id_type>       m_free;
+
+  std::unordered_map<uint32_t, posting_list> m_postings;
+};
+
+}
+
+#endif
@@ -1,9 +1,9 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
 
+#include <algorithm>
 #include <cstdio>
 #include <functional>
-#include <regex>
 
 #include <torrent/connection_manager.h>
 #include <torrent/data/download_data.h>
@@ -34,6 +34,7 @@
 #include "command_helpers.h"
 #include "control.h"
 #include "globals.h"
+#include "utils/pattern.h"
 
 std::string
 retrieve_d_base_path(core::Download* download) {
@@ -203,29 +204,12 @@ apply_d_choke_heuristics(core::Download*    download,
 
 const char*
 retrieve_d_priority_str(core::Download* download) {
-  switch (download->priority()) {
-    case 0:
-      return "off";
-    case 1:
-      return "low";
-    case 2:
-      return "normal";
-    case 3:
-      return "high";
-    default:
-      throw torrent::input_error("Priority out of range.");
-  }
-}
+  const char* name = download->priority_str();
 
-torrent::Object
-retrieve_d_ratio(core::Download* download) {
-  if (download->is_hash_checking())
-    return int64_t();
-
-  int64_t bytesDone = download->download()->bytes_done();
-  int64_t upTotal   = download->info()->up_rate()->total();
+  if (name == nullptr)
+    throw torrent::input_error("Priority out of range.");
 
-  return bytesDone > 0 ? (1000 * upTotal) / bytesDone : 0;
+  return name;
 }
 
 torrent::Object
@@ -424,23 +408,26 @@ f_multicall(core::Download* download, const torrent::Object::list_type& args) {
   else
     use_regex = false;
 
+  std::vector<utils::Pattern> patterns;
+
+  for (const auto& source : regex_list) {
+    patterns.emplace_back(source);
+
+    if (!patterns.back().is_valid())
+      control->core()->push_log_std("regex_error: " +
+                                    patterns.back().error());
+  }
+
   for (torrent::FileList::const_iterator itr  = download->file_list()->begin(),
                                          last = download->file_list()->end();
        itr != last;
        itr++) {
-    if (use_regex &&
-        std::find_if(
-          regex_list.begin(), regex_list.end(), [itr](std::string pattern) {
-            bool isAMatch = false;
-            try {
-              std::regex re(pattern);
-              isAMatch = std::regex_match((*itr)->path()->as_string(), re);
-            } catch (const std::regex_error& e) {
-              control->core()->push_log_std("regex_error: " +
-                                            std::string(e.what()));
-            }
-            return isAMatch;
-          }) == regex_list.end())
+    if (use_regex && std::none_of(patterns.begin(),
+                                  patterns.end(),
+                                  [itr](const utils::Pattern& pattern) {
+                                    return pattern.match(
+                                      (*itr)->path()->as_string());
+                                  }))
       continue;
 
     torrent::Object::list_type& row =
@@ -819,6 +806,10 @@ initialize_command_download() {
   });
 
   CMD2_DL("d.name", CMD2_ON_INFO(name));
+  CMD2_DL_STRING("d.search.name", [](const auto& download, const auto& query) {
+    return (int64_t)control->core()->search_index()->name_contains(download,
+                                                                   query);
+  });
   CMD2_DL("d.creation_date", CMD2_ON_INFO(creation_date));
   CMD2_DL("d.load_date", CMD2_ON_INFO(load_date));
 
@@ -1157,7 +1148,7 @@ initialize_command_download() {
 
   CMD2_DL("d.bytes_done", CMD2_ON_DL(bytes_done));
   CMD2_DL("d.ratio", [](const auto& download, const auto&) {
-    return retrieve_d_ratio(download);
+    return download->ratio();
   });
   CMD2_DL("d.chunks_hashed", CMD2_ON_DL(chunks_hashed));
   CMD2_DL("d.free_diskspace", CMD2_ON_FL(free_diskspace));
@@ -1209,6 +1200,18 @@ initialize_command_download() {
                   [](const auto& download, const auto& v) {
                     return download->tracker_controller()->scrape_request(v);
                   });
+  CMD2_DL_V("d.tracker.send_scrape_batched",
+            [](const auto& download, const auto&) {
+              return control->core()->scrape_batcher()->insert(download);
+            });
+
+  CMD2_DL_VAR_VALUE("d.tracker.scrape_complete", "rtorrent", "scrape_complete");
+  CMD2_DL_VAR_VALUE(
+    "d.tracker.scrape_incomplete", "rtorrent", "scrape_incomplete");
+  CMD2_DL_VAR_VALUE(
+    "d.tracker.scrape_downloaded", "rtorrent", "scrape_downloaded");
+  CMD2_DL_VAR_VALUE(
+    "d.tracker.scrape_time_last", "rtorrent", "scrape_time_last");
 
   CMD2_DL("d.directory", CMD2_ON_FL(root_dir));
   CMD2_DL_STRING_V("d.directory.set",
@@ -1228,14 +1231,15 @@ initialize_command_download() {
     return retrieve_d_priority_str(download);
   });
   CMD2_DL_VALUE_V("d.priority.set", [](const auto& download, const auto& p) {
-    return download->set_priority(p);
+    download->set_priority(p);
+    return control->core()->queue_manager()->update_priority(download);
   });
 
   CMD2_DL("d.group", [](const auto& download, const auto&) {
     return cg_d_group(download);
   });
   CMD2_DL("d.group.name", [](const auto& download, const auto&) {
-    return cg_d_group(download);
+    return cg_d_group_name(download);
   });
   CMD2_DL_V("d.group.set", [](const auto& download, const auto& arg) {
     return cg_d_group_set(download, arg);
@@ -289,6 +289,27 @@ apply_download_list(const torrent::Object::list_type& args) {
   return result;
 }
 
+// Info hashes of the downloads whose name, or one of whose file paths,
+// contains the query, ignoring case.
+torrent::Object
+apply_search(const std::string& query, bool files) {
+  core::SearchIndex*               index = control->core()->search_index();
+  core::SearchIndex::download_list downloads =
+    files ? index->search_files(query) : index->search_names(query);
+
+  torrent::Object             result     = torrent::Object::create_list();
+  torrent::Object::list_type& resultList = result.as_list();
+
+  for (const auto& download : downloads) {
+    const torrent::HashString* hashString = &download->info()->hash();
+
+    resultList.push_back(
+      torrent::utils::transform_hex(hashString->begin(), hashString->end()));
+  }
+
+  return result;
+}
+
 torrent::Object
 d_multicall(const torrent::Object::list_type& args) {
   if (args.empty())
@@ -506,6 +527,12 @@ initialize_command_events() {
   CMD2_ANY_LIST("download_list", [](const auto&, const auto& args) {
     return apply_download_list(args);
   });
+  CMD2_ANY_STRING("d.search", [](const auto&, const auto& query) {
+    return apply_search(query, false);
+  });
+  CMD2_ANY_STRING("d.search.files", [](const auto&, const auto& query) {
+    return apply_search(query, true);
+  });
   CMD2_ANY_LIST("d.multicall2", [](const auto&, const auto& args) {
     return d_multicall(args);
   });
@@ -5,6 +5,7 @@
 #include <torrent/download/choke_queue.h>
 #include <torrent/download/resource_manager.h>
 #include <torrent/utils/option_strings.h>
+#include <torrent/utils/string_manip.h>
 
 #include "rpc/parse.h"
 #include "rpc/parse_commands.h"
@@ -14,8 +15,9 @@
 #include "control.h"
 #include "globals.h"
 
-// For cg_d_group.
+#include "core/choke_group_manager.h"
 #include "core/download.h"
+#include "core/manager.h"
 
 // A hack to allow testing of the new choke_group API without the
 // working parts present.
@@ -97,12 +99,12 @@ apply_cg_insert(const std::string& arg) {
   return torrent::Object();
 }
 
-//
-// The hacked version:
-//
 #else
 
-std::vector<torrent::choke_group*> cg_list_hack;
+core::ChokeGroupManager*
+cg_manager() {
+  return control->core()->choke_group_manager();
+}
 
 int64_t
 cg_get_index(const torrent::Object& raw_args) {
@@ -115,17 +117,12 @@ cg_get_index(const torrent::Object& raw_args) {
 
   if (arg.is_string()) {
     if (!rpc::parse_whole_value_nothrow(arg.as_string().c_str(), &index)) {
-      std::vector<torrent::choke_group*>::iterator itr =
-        std::find_if(cg_list_hack.begin(),
-                     cg_list_hack.end(),
-                     [arg](torrent::choke_group* c) {
-                       return arg.as_string() == c->name();
-                     });
-
-      if (itr == cg_list_hack.end())
+      index = cg_manager()->index_of(arg.as_string());
+
+      if (index < 0)
         throw torrent::input_error("Choke group not found.");
 
-      return std::distance(cg_list_hack.begin(), itr);
+      return index;
     }
 
   } else {
@@ -133,9 +130,9 @@ cg_get_index(const torrent::Object& raw_args) {
   }
 
   if (index < 0)
-    index = (int64_t)cg_list_hack.size() + index;
+    index = (int64_t)cg_manager()->size() + index;
 
-  if ((size_t)index >= cg_list_hack.size())
+  if (index < 0 || (size_t)index >= cg_manager()->size())
     throw torrent::input_error("Choke group not found.");
 
   return index;
@@ -143,32 +140,30 @@ cg_get_index(const torrent::Object& raw_args) {
 
 torrent::choke_group*
 cg_get_group(const torrent::Object& raw_args) {
-  int64_t index = cg_get_index(raw_args);
-
-  if ((size_t)index >= cg_list_hack.size())
-    throw torrent::input_error("Choke group not found.");
-
-  return cg_list_hack.at(index);
+  return cg_manager()->at(cg_get_index(raw_args));
 }
 
 int64_t
 cg_d_group(core::Download* download) {
   return download->group();
 }
+
+const std::string&
+cg_d_group_name(core::Download* download) {
+  return cg_manager()->at(download->group())->name();
+}
+
 void
 cg_d_group_set(core::Download* download, const torrent::Object& arg) {
-  download->set_group(cg_get_index(arg));
+  cg_manager()->set_group(download, cg_get_index(arg));
 }
 
 torrent::Object
 apply_cg_list() {
   torrent::Object::list_type result;
 
-  for (std::vector<torrent::choke_group*>::iterator itr  = cg_list_hack.begin(),
-                                                    last = cg_list_hack.end();
-       itr != last;
-       itr++)
-    result.push_back((*itr)->name());
+  for (size_t index = 0; index != cg_manager()->size(); index++)
+    result.push_back(cg_manager()->at(index)->name());
 
   return torrent::Object::from_list(result);
 }
@@ -181,35 +176,74 @@ apply_cg_insert(const std::string& arg) {
     throw torrent::input_error(
       "Cannot use a value string as choke group name.");
 
-  if (arg.empty() || std::find_if(cg_list_hack.begin(),
-                                  cg_list_hack.end(),
-                                  [arg](torrent::choke_group* cg) {
-                                    return arg == cg->name();
-                                  }) != cg_list_hack.end())
-    throw torrent::input_error("Duplicate name for choke group.");
+  cg_manager()->insert(arg);
+  return torrent::Object();
+}
 
-  cg_list_hack.push_back(new torrent::choke_group());
-  cg_list_hack.back()->set_name(arg);
+torrent::Object
+apply_cg_rename(const torrent::Object::list_type& args) {
+  if (args.size() != 2)
+    throw torrent::input_error("Incorrect number of arguments.");
 
-  cg_list_hack.back()->up_queue()->set_heuristics(
-    torrent::choke_queue::HEURISTICS_UPLOAD_LEECH);
-  cg_list_hack.back()->down_queue()->set_heuristics(
-    torrent::choke_queue::HEURISTICS_DOWNLOAD_LEECH);
+  const std::string& name = args.back().as_string();
+  int64_t            dummy;
 
+  if (rpc::parse_whole_value_nothrow(name.c_str(), &dummy))
+    throw torrent::input_error(
+      "Cannot use a value string as choke group name.");
+
+  cg_manager()->rename_group(cg_get_index(args.front()), name);
   return torrent::Object();
 }
 
 torrent::Object
 apply_cg_index_of(const std::string& arg) {
-  std::vector<torrent::choke_group*>::iterator itr =
-    std::find_if(cg_list_hack.begin(),
-                 cg_list_hack.end(),
-                 [arg](torrent::choke_group* cg) { return arg == cg->name(); });
+  int64_t index = cg_manager()->index_of(arg);
 
-  if (itr == cg_list_hack.end())
+  if (index < 0)
     throw torrent::input_error("Choke group not found.");
 
-  return std::distance(cg_list_hack.begin(), itr);
+  return index;
+}
+
+torrent::Object
+apply_cg_members(const torrent::Object& raw_args) {
+  torrent::Object::list_type result;
+
+  for (core::Download* download :
+       cg_manager()->members(cg_get_index(raw_args)))
+    result.push_back(
+      torrent::utils::transform_hex_str(download->info()->hash()));
+
+  return torrent::Object::from_list(result);
+}
+
+torrent::Object
+cg_stats_to_object(uint32_t index) {
+  core::ChokeGroupManager::group_stats stats = cg_manager()->stats(index);
+
+  torrent::Object result = torrent::Object::create_map();
+
+  result.insert_key("name", cg_manager()->at(index)->name());
+  result.insert_key("members", (int64_t)cg_manager()->members(index).size());
+  result.insert_key("up_rate", (int64_t)stats.up_rate);
+  result.insert_key("down_rate", (int64_t)stats.down_rate);
+  result.insert_key("up_unchoked", (int64_t)stats.up_unchoked);
+  result.insert_key("down_unchoked", (int64_t)stats.down_unchoked);
+  result.insert_key("peers", (int64_t)stats.peers);
+  result.insert_key("active", (int64_t)stats.active);
+
+  return result;
+}
+
+torrent::Object
+apply_cg_stats_all() {
+  torrent::Object::list_type result;
+
+  for (size_t index = 0; index != cg_manager()->size(); index++)
+    result.push_back(cg_stats_to_object(index));
+
+  return torrent::Object::from_list(result);
 }
 
 //
@@ -283,6 +317,12 @@ apply_cg_tracker_mode_set(const torrent::Object::list_type& args) {
 Adds a new group with default settings, use index '-1' to accessing it
 immediately afterwards.
 
+(choke_group.erase,<cg_index>)
+(choke_group.rename,<cg_index>,"group_name")
+
+Erasing a group moves its torrents to the 'default' group at index 0,
+which can't be erased, and shifts the index of the later groups down.
+
 (choke_group.index_of,"group_name") -> <group_index>
 
 Throws if the group name was not found.
@@ -291,6 +331,14 @@ Throws if the group name was not found.
 
 Number of torrents in this group.
 
+(choke_group.members,<cg_index>) -> List of info hashes.
+(choke_group.stats,<cg_index>) -> Map of group statistics.
+(choke_group.stats.all) -> List of statistics maps for every group.
+
+The statistics hold the group name, member count, aggregate up / down
+rate, number of active members, their connected peers and how many of
+those are unchoked for upload / download.
+
 (choke_group.tracker.mode,<cg_index>) -> "tracker_mode"
 (choke_group.tracker.mode.set,<cg_index>,"tracker_mode")
 
@@ -353,18 +401,54 @@ initialize_command_groups() {
   apply_cg_insert("default");
 
   CMD2_ANY("choke_group.size",
-           [](const auto&, const auto&) { return cg_list_hack.size(); });
+           [](const auto&, const auto&) { return cg_manager()->size(); });
   CMD2_ANY_STRING("choke_group.index_of", [](const auto&, const auto& arg) {
     return apply_cg_index_of(arg);
   });
+  CMD2_ANY_VOID("choke_group.erase", [](const auto&, const auto& raw_args) {
+    return cg_manager()->erase_group(cg_get_index(raw_args));
+  });
+  CMD2_ANY_LIST("choke_group.rename", [](const auto&, const auto& args) {
+    return apply_cg_rename(args);
+  });
+
+  // The groups aren't known to libtorrent yet, so sizes and rates are
+  // aggregated from the members tracked by the registry.
+  CMD2_ANY("choke_group.general.size", [](const auto&, const auto& raw_args) {
+    return cg_manager()->members(cg_get_index(raw_args)).size();
+  });
+  CMD2_ANY("choke_group.members", [](const auto&, const auto& raw_args) {
+    return apply_cg_members(raw_args);
+  });
+  CMD2_ANY("choke_group.stats", [](const auto&, const auto& raw_args) {
+    return cg_stats_to_object(cg_get_index(raw_args));
+  });
+  CMD2_ANY("choke_group.stats.all",
+           [](const auto&, const auto&) { return apply_cg_stats_all(); });
+
+  CMD2_ANY("choke_group.up.rate", [](const auto&, const auto& raw_args) {
+    return cg_manager()->stats(cg_get_index(raw_args)).up_rate;
+  });
+  CMD2_ANY("choke_group.down.rate", [](const auto&, const auto& raw_args) {
+    return cg_manager()->stats(cg_get_index(raw_args)).down_rate;
+  });
 #endif
 
+#if USE_CHOKE_GROUP
   // Commands specific for a group. Supports as the first argument the
   // name, the index or a negative index.
   CMD2_ANY("choke_group.general.size", [](const auto&, const auto& raw_args) {
     return cg_get_group(raw_args)->size();
   });
 
+  CMD2_ANY("choke_group.up.rate", [](const auto&, const auto& raw_args) {
+    return cg_get_group(raw_args)->up_rate();
+  });
+  CMD2_ANY("choke_group.down.rate", [](const auto&, const auto& raw_args) {
+    return cg_get_group(raw_args)->down_rate();
+  });
+#endif
+
   CMD2_ANY("choke_group.tracker.mode", [](const auto&, const auto& raw_args) {
     return torrent::option_as_string(torrent::OPTION_TRACKER_MODE,
                                      cg_get_group(raw_args)->tracker_mode());
@@ -374,13 +458,6 @@ initialize_command_groups() {
                   return apply_cg_tracker_mode_set(args);
                 });
 
-  CMD2_ANY("choke_group.up.rate", [](const auto&, const auto& raw_args) {
-    return cg_get_group(raw_args)->up_rate();
-  });
-  CMD2_ANY("choke_group.down.rate", [](const auto&, const auto& raw_args) {
-    return cg_get_group(raw_args)->down_rate();
-  });
-
   CMD2_ANY("choke_group.up.max.unlimited",
            [](const auto&, const auto& raw_args) {
              return cg_get_group(raw_args)->up_queue()->is_unlimited();
@@ -447,10 +524,6 @@ void
 cleanup_command_groups() {
 #if USE_CHOKE_GROUP
 #else
-  while (!cg_list_hack.empty()) {
-    auto cg = cg_list_hack.back();
-    delete cg;
-    cg_list_hack.pop_back();
-  }
+  cg_manager()->clear();
 #endif
 }
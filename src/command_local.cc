@@ -3,6 +3,7 @@
 
 #include "buildinfo.h"
 
+#include <algorithm>
 #include <fcntl.h>
 #include <functional>
 #include <stdio.h>
@@ -22,6 +23,7 @@
 #include "core/download_list.h"
 #include "core/download_store.h"
 #include "core/manager.h"
+#include "rpc/parse.h"
 #include "rpc/parse_commands.h"
 #include "rpc/scgi.h"
 #include "utils/file_status_cache.h"
@@ -201,10 +203,39 @@ cmd_file_append(const torrent::Object::list_type& args) {
   return torrent::Object();
 }
 
+// Per program counts and run times, in milliseconds, of the commands
+// executed since startup.
+torrent::Object
+retrieve_execute_stats() {
+  torrent::Object result = torrent::Object::create_map();
+
+  for (const auto& entry : rpc::execFile.spawner()->stats()) {
+    torrent::Object& stats = result.insert_key(entry.first,
+                                               torrent::Object::create_map());
+
+    stats.insert_key("count", (int64_t)entry.second.count);
+    stats.insert_key("failed", (int64_t)entry.second.failed);
+    stats.insert_key("total_ms", (int64_t)(entry.second.total_usec / 1000));
+    stats.insert_key("max_ms", (int64_t)(entry.second.max_usec / 1000));
+  }
+
+  return result;
+}
+
+// Changing the limits should take effect without waiting for the
+// next change to the hashing view.
+void
+apply_pieces_hash_reschedule() {
+  if (control->core()->hashing_view() != nullptr)
+    control->core()->hash_scheduler()->update(
+      control->core()->hashing_view());
+}
+
 void
 initialize_command_local() {
   core::DownloadList*    dList        = control->core()->download_list();
   core::DownloadStore*   dStore       = control->core()->download_store();
+  core::HashScheduler*   hScheduler   = control->core()->hash_scheduler();
   torrent::ChunkManager* chunkManager = torrent::chunk_manager();
   torrent::FileManager*  fileManager  = torrent::file_manager();
 
@@ -256,8 +287,53 @@ initialize_command_local() {
     return torrent::utils::timer::current_usec();
   });
 
-  CMD2_ANY_VALUE_V("system.umask.set",
-                   [](const auto&, const auto& mode) { return umask(mode); });
+  CMD2_ANY("system.profile.enabled", [](const auto&, const auto&) {
+    return (int64_t)rpc::profiler.is_enabled();
+  });
+  CMD2_ANY_VALUE_V("system.profile.enabled.set",
+                   [](const auto&, const auto& v) {
+                     return rpc::profiler.set_enabled(v != 0);
+                   });
+  CMD2_ANY("system.profile.commands", [](const auto&, const auto& args) {
+    int64_t limit = 0;
+    rpc::convert_to_value_nothrow(args, &limit);
+
+    return rpc::profiler.commands_object(std::max<int64_t>(limit, 0));
+  });
+  CMD2_ANY_STRING("system.profile.command", [](const auto&, const auto& arg) {
+    if (!rpc::commands.has(arg))
+      throw torrent::input_error("Command not found.");
+
+    return rpc::profiler.command(arg.c_str())->to_object();
+  });
+  CMD2_ANY("system.profile.rpc", [](const auto&, const auto&) {
+    return rpc::profiler.rpc_object();
+  });
+  CMD2_ANY("system.profile.tasks", [](const auto&, const auto&) {
+    return control->core()->tick_profiler()->tasks_object();
+  });
+  CMD2_ANY("system.profile.ticks", [](const auto&, const auto&) {
+    return control->core()->tick_profiler()->ticks_object();
+  });
+  CMD2_ANY("system.profile.stall_threshold", [](const auto&, const auto&) {
+    return (int64_t)control->core()->tick_profiler()->stall_threshold() / 1000;
+  });
+  CMD2_ANY_VALUE_V(
+    "system.profile.stall_threshold.set", [](const auto&, const auto& v) {
+      if (v <= 0)
+        throw torrent::input_error("Invalid stall threshold.");
+
+      return control->core()->tick_profiler()->set_stall_threshold(v * 1000);
+    });
+  CMD2_ANY_V("system.profile.reset", [](const auto&, const auto&) {
+    control->core()->tick_profiler()->reset();
+    return rpc::profiler.reset();
+  });
+
+  CMD2_ANY_VALUE_V("system.umask.set", [](const auto&, const auto& mode) {
+    rpc::execFile.spawner()->set_umask(mode);
+    return umask(mode);
+  });
 
   CMD2_VAR_BOOL("system.daemon", false);
 
@@ -361,6 +437,39 @@ initialize_command_local() {
            [](const auto&, const auto&) { return torrent::hash_queue_size(); });
   CMD2_VAR_BOOL("pieces.hash.on_completion", false);
 
+  CMD2_ANY("pieces.hash.max_active", [hScheduler](const auto&, const auto&) {
+    return hScheduler->max_active();
+  });
+  CMD2_ANY_VALUE_V("pieces.hash.max_active.set",
+                   [hScheduler](const auto&, const auto& value) {
+                     hScheduler->set_max_active(value);
+                     return apply_pieces_hash_reschedule();
+                   });
+  CMD2_ANY("pieces.hash.max_per_device",
+           [hScheduler](const auto&, const auto&) {
+             return hScheduler->max_per_device();
+           });
+  CMD2_ANY_VALUE_V("pieces.hash.max_per_device.set",
+                   [hScheduler](const auto&, const auto& value) {
+                     hScheduler->set_max_per_device(value);
+                     return apply_pieces_hash_reschedule();
+                   });
+  CMD2_ANY("pieces.hash.active", [hScheduler](const auto&, const auto&) {
+    return hScheduler->size_active();
+  });
+  CMD2_ANY("pieces.hash.waiting", [hScheduler](const auto&, const auto&) {
+    return hScheduler->size_waiting();
+  });
+  CMD2_ANY("pieces.hash.checked", [hScheduler](const auto&, const auto&) {
+    return hScheduler->checked();
+  });
+  CMD2_ANY("pieces.hash.bytes_checked", [hScheduler](const auto&, const auto&) {
+    return hScheduler->bytes_checked();
+  });
+  CMD2_ANY("pieces.hash.bytes_left", [hScheduler](const auto&, const auto&) {
+    return hScheduler->bytes_left();
+  });
+
   CMD2_VAR_STRING("directory.default", "./");
 
   CMD2_VAR_STRING("session.name", "");
@@ -404,6 +513,30 @@ initialize_command_local() {
   CMD2_EXECUTE("execute.capture_nothrow",
                rpc::ExecFile::flag_expand_tilde | rpc::ExecFile::flag_capture);
 
+  // Background commands run through the process spawner are limited to
+  // this many at a time, the rest wait in a queue.
+  CMD2_ANY("execute.max_running", [](const auto&, const auto&) {
+    return (int64_t)rpc::execFile.spawner()->max_running();
+  });
+  CMD2_ANY_VALUE_V("execute.max_running.set", [](const auto&, const auto& v) {
+    return rpc::execFile.spawner()->set_max_running(v);
+  });
+  CMD2_ANY("execute.running", [](const auto&, const auto&) {
+    return (int64_t)rpc::execFile.spawner()->size_running();
+  });
+  CMD2_ANY("execute.queued", [](const auto&, const auto&) {
+    return (int64_t)rpc::execFile.spawner()->size_queued();
+  });
+  CMD2_ANY("execute.spawner", [](const auto&, const auto&) {
+    return (int64_t)rpc::execFile.spawner()->is_open();
+  });
+  CMD2_ANY("execute.stats", [](const auto&, const auto&) {
+    return retrieve_execute_stats();
+  });
+  CMD2_ANY_V("execute.stats.clear", [](const auto&, const auto&) {
+    return rpc::execFile.spawner()->clear_stats();
+  });
+
   CMD2_ANY_LIST("file.append", [](const auto&, const auto& args) {
     return cmd_file_append(args);
   });
@@ -12,6 +12,7 @@
 #include "core/download_list.h"
 #include "core/manager.h"
 #include "rpc/parse_commands.h"
+#include "utils/trace_ring.h"
 
 #include "command_helpers.h"
 #include "control.h"
@@ -149,6 +150,29 @@ log_vmmap_dump(const std::string& str) {
   return torrent::Object();
 }
 
+torrent::Object
+log_trace_dump(const std::string& str) {
+  if (str.empty())
+    throw torrent::input_error("Empty filename.");
+
+  FILE* log_file = fopen(torrent::utils::path_expand(str).c_str(), "w");
+
+  if (log_file == nullptr)
+    throw torrent::input_error("Could not open trace dump file.");
+
+  try {
+    utils::traceRing.dump(log_file);
+  } catch (torrent::input_error&) {
+    fclose(log_file);
+    throw;
+  }
+
+  if (fclose(log_file) != 0)
+    throw torrent::input_error("Could not write trace dump.");
+
+  return torrent::Object();
+}
+
 void
 initialize_command_logging() {
   CMD2_ANY_LIST("log.open_file", [](const auto&, const auto& args) {
@@ -187,4 +211,17 @@ initialize_command_logging() {
   CMD2_ANY_STRING_V("log.rpc", [](const auto&, const auto& filename) {
     return worker_thread->set_rpc_log(filename);
   });
+
+  CMD2_ANY_STRING("log.trace.dump", [](const auto&, const auto& str) {
+    return log_trace_dump(str);
+  });
+  CMD2_ANY("log.trace.enabled", [](const auto&, const auto&) {
+    return (int64_t)utils::traceRing.is_enabled();
+  });
+  CMD2_ANY_VALUE_V("log.trace.enabled.set", [](const auto&, const auto& v) {
+    return utils::traceRing.set_enabled(v != 0);
+  });
+  CMD2_ANY("log.trace.position", [](const auto&, const auto&) {
+    return (int64_t)utils::traceRing.position();
+  });
 }
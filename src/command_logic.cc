@@ -1,4 +1,4 @@
-#include <regex>
+#include <algorithm>
 
 #include <torrent/utils/algorithm.h>
 #include <torrent/utils/log.h>
@@ -8,6 +8,7 @@
 #include "core/manager.h"
 #include "rpc/parse.h"
 #include "ui/root.h"
+#include "utils/pattern.h"
 
 torrent::Object
 apply_cat(rpc::target_type, const torrent::Object& rawArgs) {
@@ -317,15 +318,15 @@ apply_match(rpc::target_type target, const torrent::Object::list_type& args) {
   std::transform(text.begin(), text.end(), text.begin(), ::tolower);
   std::transform(pattern.begin(), pattern.end(), pattern.begin(), ::tolower);
 
-  bool isAMatch = false;
-  try {
-    std::regex re(pattern);
-    isAMatch = std::regex_match(text, re);
-  } catch (const std::regex_error& exc) {
-    control->core()->push_log_std("regex_error: " + std::string(exc.what()));
-  }
+  // Filters call this once per download with the same pattern, so
+  // compile it once and only report an invalid one the first time.
+  bool                  compiled = false;
+  const utils::Pattern& re       = utils::patternCache.find(pattern, &compiled);
+
+  if (compiled && !re.is_valid())
+    control->core()->push_log_std("regex_error: " + re.error());
 
-  return isAMatch ? (int64_t) true : (int64_t) false;
+  return re.match(text) ? (int64_t) true : (int64_t) false;
 }
 
 torrent::Object
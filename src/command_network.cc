@@ -233,6 +233,66 @@ apply_scgi(const std::string& arg, int type) {
   return torrent::Object();
 }
 
+int
+http_request_class(const std::string& name) {
+  for (int c = 0; c < core::CurlGet::class_size; c++)
+    if (name == core::CurlGet::class_name(c))
+      return c;
+
+  throw torrent::input_error("Unknown http request class '" + name + "'.");
+}
+
+static constexpr int http_stats_queued    = 0;
+static constexpr int http_stats_active    = 1;
+static constexpr int http_stats_completed = 2;
+static constexpr int http_stats_wait      = 3;
+static constexpr int http_stats_time      = 4;
+static constexpr int http_stats_weight    = 5;
+
+// Wait and time are the average number of milliseconds requests of
+// the class spent in the queue and in transfer.
+torrent::Object
+retrieve_http_stats(const std::string& name, int type) {
+  core::CurlStack* httpStack = control->core()->http_stack();
+
+  int requestClass = http_request_class(name);
+
+  const core::CurlStack::class_stats& stats = httpStack->stats(requestClass);
+
+  switch (type) {
+    case http_stats_queued:
+      return (int64_t)httpStack->queued(requestClass);
+    case http_stats_active:
+      return (int64_t)stats.active;
+    case http_stats_completed:
+      return (int64_t)stats.completed;
+    case http_stats_wait:
+      return (int64_t)(stats.completed + stats.active == 0
+                         ? 0
+                         : stats.wait_usec / 1000 /
+                             (stats.completed + stats.active));
+    case http_stats_time:
+      return (int64_t)(stats.completed == 0
+                         ? 0
+                         : stats.time_usec / 1000 / stats.completed);
+    case http_stats_weight:
+    default:
+      return (int64_t)stats.weight;
+  }
+}
+
+torrent::Object
+apply_http_weight(const torrent::Object::list_type& args) {
+  if (args.size() != 2)
+    throw torrent::input_error("Wrong argument count.");
+
+  control->core()->http_stack()->set_weight(
+    http_request_class(args.front().as_string()),
+    rpc::convert_to_value(args.back()));
+
+  return torrent::Object();
+}
+
 void
 initialize_command_network() {
   torrent::ConnectionManager* cm          = torrent::connection_manager();
@@ -290,6 +350,20 @@ initialize_command_network() {
                    [httpStack](const auto&, const auto& timeout) {
                      return httpStack->set_dns_timeout(timeout);
                    });
+  CMD2_ANY("network.http.keep_alive", [httpStack](const auto&, const auto&) {
+    return httpStack->keep_alive();
+  });
+  CMD2_ANY_VALUE_V("network.http.keep_alive.set",
+                   [httpStack](const auto&, const auto& v) {
+                     return httpStack->set_keep_alive(v);
+                   });
+  CMD2_ANY("network.http.http2", [httpStack](const auto&, const auto&) {
+    return httpStack->http2();
+  });
+  CMD2_ANY_VALUE_V("network.http.http2.set",
+                   [httpStack](const auto&, const auto& v) {
+                     return httpStack->set_http2(v);
+                   });
   CMD2_ANY("network.http.current_open", [httpStack](const auto&, const auto&) {
     return httpStack->active();
   });
@@ -300,6 +374,48 @@ initialize_command_network() {
                    [httpStack](const auto&, const auto& a) {
                      return httpStack->set_max_active(a);
                    });
+  // Torrents fetched over http are rejected as soon as they exceed
+  // this size.
+  CMD2_VAR_VALUE("network.http.max_metadata_size", (int64_t)64 << 20);
+
+  CMD2_ANY("network.http.max_open_per_host",
+           [httpStack](const auto&, const auto&) {
+             return httpStack->max_active_per_host();
+           });
+  CMD2_ANY_VALUE_V("network.http.max_open_per_host.set",
+                   [httpStack](const auto&, const auto& a) {
+                     return httpStack->set_max_active_per_host(a);
+                   });
+
+  CMD2_ANY_STRING("network.http.queue.size",
+                  [](const auto&, const auto& name) {
+                    return retrieve_http_stats(name, http_stats_queued);
+                  });
+  CMD2_ANY_STRING("network.http.queue.active",
+                  [](const auto&, const auto& name) {
+                    return retrieve_http_stats(name, http_stats_active);
+                  });
+  CMD2_ANY_STRING("network.http.queue.completed",
+                  [](const auto&, const auto& name) {
+                    return retrieve_http_stats(name, http_stats_completed);
+                  });
+  CMD2_ANY_STRING("network.http.queue.wait",
+                  [](const auto&, const auto& name) {
+                    return retrieve_http_stats(name, http_stats_wait);
+                  });
+  CMD2_ANY_STRING("network.http.queue.time",
+                  [](const auto&, const auto& name) {
+                    return retrieve_http_stats(name, http_stats_time);
+                  });
+  CMD2_ANY_STRING("network.http.queue.weight",
+                  [](const auto&, const auto& name) {
+                    return retrieve_http_stats(name, http_stats_weight);
+                  });
+  CMD2_ANY_LIST("network.http.queue.weight.set",
+                [](const auto&, const auto& args) {
+                  return apply_http_weight(args);
+                });
+
   CMD2_ANY("network.http.proxy_address", [httpStack](const auto&, const auto&) {
     return httpStack->http_proxy();
   });
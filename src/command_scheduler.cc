@@ -6,97 +6,77 @@
 #include "core/download.h"
 #include "core/download_list.h"
 #include "core/manager.h"
-#include "core/view.h"
-#include "core/view_manager.h"
+#include "core/queue_manager.h"
 
 #include "command_helpers.h"
 #include "control.h"
 #include "globals.h"
 
-torrent::Object
-cmd_scheduler_simple_added(core::Download* download) {
-  unsigned int numActive =
-    (*control->view_manager()->find("active"))->size_visible();
-  int64_t maxActive =
-    rpc::call_command("scheduler.max_active", torrent::Object()).as_value();
-
-  if (numActive < (uint64_t)maxActive)
-    control->core()->download_list()->resume(download);
-
-  return torrent::Object();
-}
-
-torrent::Object
-cmd_scheduler_simple_removed(core::Download* download) {
-  control->core()->download_list()->pause(download);
-
-  core::View* viewActive = *control->view_manager()->find("active");
-  int64_t     maxActive =
-    rpc::call_command("scheduler.max_active", torrent::Object()).as_value();
-
-  if ((int64_t)viewActive->size_visible() >= maxActive)
-    return torrent::Object();
-
-  // The 'started' view contains all the views we may choose amongst.
-  core::View* viewStarted = *control->view_manager()->find("started");
-
-  for (core::View::iterator itr  = viewStarted->begin_visible(),
-                            last = viewStarted->end_visible();
-       itr != last;
-       itr++) {
-    if ((*itr)->is_active())
-      continue;
-
-    control->core()->download_list()->resume(*itr);
-  }
-
-  return torrent::Object();
-}
-
-torrent::Object
-cmd_scheduler_simple_update(core::Download*) {
-  core::View* viewActive  = *control->view_manager()->find("active");
-  core::View* viewStarted = *control->view_manager()->find("started");
-
-  unsigned int numActive = viewActive->size_visible();
-  uint64_t     maxActive =
-    rpc::call_command("scheduler.max_active", torrent::Object()).as_value();
-
-  if (viewActive->size_visible() < maxActive) {
-
-    for (core::View::iterator itr  = viewStarted->begin_visible(),
-                              last = viewStarted->end_visible();
-         itr != last;
-         itr++) {
-      if ((*itr)->is_active())
-        continue;
-
-      control->core()->download_list()->resume(*itr);
-
-      if (++numActive >= maxActive)
-        break;
-    }
-
-  } else if (viewActive->size_visible() > maxActive) {
-
-    while (viewActive->size_visible() > maxActive)
-      control->core()->download_list()->pause(*viewActive->begin_visible());
-  }
-
-  return torrent::Object();
-}
-
 void
 initialize_command_scheduler() {
-  CMD2_VAR_VALUE("scheduler.max_active", int64_t(-1));
+  CMD2_ANY("scheduler.max_active", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->max_active();
+  });
+  CMD2_ANY_VALUE_V("scheduler.max_active.set", [](const auto&, const auto& v) {
+    return control->core()->queue_manager()->set_max_active(v);
+  });
+  CMD2_ANY("scheduler.max_downloading", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->max_downloading();
+  });
+  CMD2_ANY_VALUE_V(
+    "scheduler.max_downloading.set", [](const auto&, const auto& v) {
+      return control->core()->queue_manager()->set_max_downloading(v);
+    });
+  CMD2_ANY("scheduler.max_seeding", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->max_seeding();
+  });
+  CMD2_ANY_VALUE_V("scheduler.max_seeding.set", [](const auto&, const auto& v) {
+    return control->core()->queue_manager()->set_max_seeding(v);
+  });
+  CMD2_ANY("scheduler.max_per_tracker", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->max_per_tracker();
+  });
+  CMD2_ANY_VALUE_V(
+    "scheduler.max_per_tracker.set", [](const auto&, const auto& v) {
+      return control->core()->queue_manager()->set_max_per_tracker(v);
+    });
+
+  CMD2_ANY("scheduler.active.downloading", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->active_downloading();
+  });
+  CMD2_ANY("scheduler.active.seeding", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->active_seeding();
+  });
+  CMD2_ANY("scheduler.queued.downloading", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->queued_downloading();
+  });
+  CMD2_ANY("scheduler.queued.seeding", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->queued_seeding();
+  });
+  CMD2_ANY("scheduler.started", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->started();
+  });
+  CMD2_ANY("scheduler.paused", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->paused();
+  });
+
+  CMD2_DL("scheduler.queue.position", [](const auto& download, const auto&) {
+    return control->core()->queue_manager()->position(download);
+  });
+  CMD2_DL("scheduler.queue.reason", [](const auto& download, const auto&) {
+    return core::QueueManager::reason_name(
+      control->core()->queue_manager()->reason(download));
+  });
 
-  CMD2_DL("scheduler.simple.added", [](const auto& download, const auto&) {
-    return cmd_scheduler_simple_added(download);
+  // The 'started' view calls these as downloads are added and removed.
+  CMD2_DL_V("scheduler.simple.added", [](const auto& download, const auto&) {
+    return control->core()->queue_manager()->insert(download);
   });
-  CMD2_DL("scheduler.simple.removed", [](const auto& download, const auto&) {
-    return cmd_scheduler_simple_removed(download);
+  CMD2_DL_V("scheduler.simple.removed", [](const auto& download, const auto&) {
+    control->core()->download_list()->pause(download);
+    return control->core()->queue_manager()->erase(download);
   });
-  CMD2_DL("scheduler.simple.update", [](const auto& download, const auto&) {
-    return cmd_scheduler_simple_update(download);
+  CMD2_DL_V("scheduler.simple.update", [](const auto&, const auto&) {
+    return control->core()->queue_manager()->update();
   });
 }
@@ -2,6 +2,9 @@
 // Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
 
 #include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
 #include <torrent/download/resource_manager.h>
 #include <torrent/rate.h>
 #include <torrent/throttle.h>
@@ -16,51 +19,63 @@
 #include "control.h"
 #include "globals.h"
 
-std::pair<uint32_t, uint32_t>
+core::AddressKey
+parse_address(const char* host) {
+  torrent::utils::address_info* ai;
+
+  if (torrent::utils::address_info::get_address_info(
+        host, PF_UNSPEC, SOCK_STREAM, &ai) != 0)
+    throw torrent::input_error("Could not resolve host.");
+
+  core::AddressKey key;
+  bool             valid =
+    core::AddressKey::from_sockaddr(ai->address()->c_sockaddr(), &key);
+  torrent::utils::address_info::free_address_info(ai);
+
+  if (!valid)
+    throw torrent::input_error("Could not resolve host.");
+
+  return key;
+}
+
+// Returns the inclusive range of addresses given by either a single
+// host, a network/prefix or a start and end address.
+std::pair<core::AddressKey, core::AddressKey>
 parse_address_range(const torrent::Object::list_type&          args,
                     torrent::Object::list_type::const_iterator itr) {
-  unsigned int                  prefixWidth, ret;
-  char                          dummy;
-  char                          host[1024];
-  torrent::utils::address_info* ai;
+  unsigned int prefixWidth, ret;
+  char         dummy;
+  char         host[1024];
 
   ret = std::sscanf(
     itr->as_string().c_str(), "%1023[^/]/%u%c", host, &prefixWidth, &dummy);
-  if (ret < 1 || torrent::utils::address_info::get_address_info(
-                   host, PF_INET, SOCK_STREAM, &ai) != 0)
+  if (ret < 1)
     throw torrent::input_error("Could not resolve host.");
 
-  uint32_t                       begin, end;
-  torrent::utils::socket_address sa;
-  sa.copy(*ai->address(), ai->length());
-  begin = end = sa.sa_inet()->address_h();
-  torrent::utils::address_info::free_address_info(ai);
+  core::AddressKey begin = parse_address(host);
+  core::AddressKey end   = begin;
 
   if (ret == 2) {
     if (++itr != args.end())
       throw torrent::input_error("Cannot specify both network and range end.");
 
-    uint32_t netmask = std::numeric_limits<uint32_t>::max()
-                       << (32 - prefixWidth);
-    if (prefixWidth >= 32 || sa.sa_inet()->address_h() & ~netmask)
+    if (begin.is_ipv4())
+      prefixWidth += core::AddressKey::ipv4_bits;
+
+    if (prefixWidth > core::AddressKey::bits ||
+        begin.masked(prefixWidth) != begin)
       throw torrent::input_error("Invalid address/prefix.");
 
-    end = sa.sa_inet()->address_h() | ~netmask;
+    end = begin.filled(prefixWidth);
 
   } else if (++itr != args.end()) {
-    if (torrent::utils::address_info::get_address_info(
-          itr->as_string().c_str(), PF_INET, SOCK_STREAM, &ai) != 0)
-      throw torrent::input_error("Could not resolve host.");
+    end = parse_address(itr->as_string().c_str());
 
-    sa.copy(*ai->address(), ai->length());
-    torrent::utils::address_info::free_address_info(ai);
-    end = sa.sa_inet()->address_h();
+    if (end.is_ipv4() != begin.is_ipv4() || end < begin)
+      throw torrent::input_error("Invalid address range.");
   }
 
-  // convert to [begin, end) making sure the end doesn't overflow
-  // (this precludes 255.255.255.255 from ever matching, but that's not a real
-  // IP anyway)
-  return std::make_pair((uint32_t)begin, (uint32_t)std::max(end, end + 1));
+  return std::make_pair(begin, end);
 }
 
 torrent::Object
@@ -138,7 +153,7 @@ apply_address_throttle(const torrent::Object::list_type& args) {
   if (args.size() < 2 || args.size() > 3)
     throw torrent::input_error("Incorrect number of arguments.");
 
-  std::pair<uint32_t, uint32_t> range =
+  std::pair<core::AddressKey, core::AddressKey> range =
     parse_address_range(args, ++args.begin());
   core::ThrottleMap::iterator throttleItr =
     control->core()->throttles().find(args.begin()->as_string().c_str());
@@ -150,6 +165,117 @@ apply_address_throttle(const torrent::Object::list_type& args) {
   return torrent::Object();
 }
 
+// Each line holds the same arguments as 'throttle.ip' separated by
+// whitespace, blank lines and lines starting with '#' are ignored.
+torrent::Object
+apply_address_throttle_load(const std::string& filename) {
+  std::ifstream file(filename.c_str());
+
+  if (!file.is_open())
+    throw torrent::input_error("Could not open file: " + filename);
+
+  std::string line;
+  int         lineNumber = 0;
+
+  while (std::getline(file, line)) {
+    lineNumber++;
+
+    std::istringstream         stream(line);
+    torrent::Object::list_type args;
+    std::string                word;
+
+    while (stream >> word && word[0] != '#')
+      args.push_back(word);
+
+    if (args.empty())
+      continue;
+
+    try {
+      apply_address_throttle(args);
+    } catch (torrent::input_error& e) {
+      throw torrent::input_error(filename + ":" + std::to_string(lineNumber) +
+                                 ": " + e.what());
+    }
+  }
+
+  return torrent::Object();
+}
+
+torrent::Object
+apply_throttle_class_insert(const torrent::Object::list_type& args) {
+  if (args.empty() || args.size() > 2)
+    throw torrent::input_error("Expected a class name and optional parent.");
+
+  control->core()->throttle_shaper()->insert(
+    args.front().as_string(),
+    args.size() == 2 ? args.back().as_string() : std::string());
+  return torrent::Object();
+}
+
+// Rates and burst sizes are given in KiB, the same as 'throttle.up'.
+torrent::Object
+apply_throttle_class_set(const torrent::Object::list_type& args) {
+  if (args.size() != 3)
+    throw torrent::input_error("Expected class name, option and value.");
+
+  const std::string& name   = args.begin()->as_string();
+  const std::string& option = std::next(args.begin())->as_string();
+  int64_t            value  = rpc::convert_to_value(args.back());
+
+  if (value < 0)
+    throw torrent::input_error("Throttle class value must be non-negative.");
+
+  control->core()->throttle_shaper()->set_option(
+    name, option, option == "weight" ? value : value * 1024);
+  return torrent::Object();
+}
+
+torrent::Object
+retrieve_throttle_class(const torrent::Object::list_type& args) {
+  if (args.size() != 2)
+    throw torrent::input_error("Expected class name and option.");
+
+  return control->core()->throttle_shaper()->option(args.front().as_string(),
+                                                    args.back().as_string());
+}
+
+// Profile entries take a 'HH:MM' start time followed by the upload and
+// download ceiling in KiB, where zero lifts the ceiling.
+torrent::Object
+apply_throttle_profile_insert(const torrent::Object::list_type& args) {
+  if (args.size() != 4)
+    throw torrent::input_error("Expected class name, start time and rates.");
+
+  torrent::Object::list_const_iterator itr = args.begin();
+
+  const std::string& name = (itr++)->as_string();
+  unsigned int       hours, minutes;
+  char               dummy;
+
+  if (std::sscanf((itr++)->as_string().c_str(),
+                  "%u:%u%c",
+                  &hours,
+                  &minutes,
+                  &dummy) != 2 ||
+      hours >= 24 || minutes >= 60)
+    throw torrent::input_error("Invalid profile start time.");
+
+  int64_t up   = rpc::convert_to_value(*itr++);
+  int64_t down = rpc::convert_to_value(*itr);
+
+  if (up < 0 || down < 0)
+    throw torrent::input_error("Profile rates must be non-negative.");
+
+  core::ThrottleShaper* shaper = control->core()->throttle_shaper();
+  uint32_t              start  = 3600 * hours + 60 * minutes;
+
+  shaper->insert_profile(
+    name, core::ThrottleShaper::direction_up, start, up * 1024);
+  shaper->insert_profile(
+    name, core::ThrottleShaper::direction_down, start, down * 1024);
+  return torrent::Object();
+}
+
 torrent::Object
 throttle_update(const char* variable, int64_t value) {
   rpc::commands.call_command(variable, value);
@@ -263,6 +389,37 @@ initialize_command_throttle() {
   CMD2_ANY_LIST("throttle.ip", [](const auto&, const auto& args) {
     return apply_address_throttle(args);
   });
+  CMD2_ANY_STRING("throttle.ip.load", [](const auto&, const auto& filename) {
+    return apply_address_throttle_load(filename);
+  });
+  CMD2_ANY("throttle.ip.size", [](const auto&, const auto&) {
+    return (int64_t)control->core()->address_throttle_size();
+  });
+
+  CMD2_ANY_LIST("throttle.class.insert", [](const auto&, const auto& args) {
+    return apply_throttle_class_insert(args);
+  });
+  CMD2_ANY_LIST("throttle.class.set", [](const auto&, const auto& args) {
+    return apply_throttle_class_set(args);
+  });
+  CMD2_ANY_LIST("throttle.class.get", [](const auto&, const auto& args) {
+    return retrieve_throttle_class(args);
+  });
+  CMD2_ANY("throttle.class.list", [](const auto&, const auto&) {
+    torrent::Object result = torrent::Object::create_list();
+
+    for (const auto& name : control->core()->throttle_shaper()->names())
+      result.as_list().push_back(name);
+
+    return result;
+  });
+  CMD2_ANY_LIST("throttle.profile.insert", [](const auto&, const auto& args) {
+    return apply_throttle_profile_insert(args);
+  });
+  CMD2_ANY_STRING_V("throttle.profile.clear",
+                    [](const auto&, const auto& name) {
+                      control->core()->throttle_shaper()->clear_profile(name);
+                    });
 
   CMD2_ANY_STRING("throttle.up.max", [](const auto&, const auto& name) {
     return retrieve_throttle_info(name, throttle_info_up | throttle_info_max);
@@ -225,6 +225,38 @@ initialize_command_tracker() {
   CMD2_VAR_VALUE("trackers.numwant", -1);
   CMD2_VAR_BOOL("trackers.use_udp", true);
 
+  CMD2_ANY("trackers.scrape.batch_size", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->batch_size();
+  });
+  CMD2_ANY_VALUE_V(
+    "trackers.scrape.batch_size.set", [](const auto&, const auto& v) {
+      return control->core()->scrape_batcher()->set_batch_size(v);
+    });
+  CMD2_ANY("trackers.scrape.delay", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->delay();
+  });
+  CMD2_ANY_VALUE_V("trackers.scrape.delay.set", [](const auto&, const auto& v) {
+    return control->core()->scrape_batcher()->set_delay(v);
+  });
+  CMD2_ANY_V("trackers.scrape.flush", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->flush();
+  });
+  CMD2_ANY("trackers.scrape.pending", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->size_pending();
+  });
+  CMD2_ANY("trackers.scrape.active", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->size_active();
+  });
+  CMD2_ANY("trackers.scrape.requests", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->requests();
+  });
+  CMD2_ANY("trackers.scrape.scraped", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->scraped();
+  });
+  CMD2_ANY("trackers.scrape.fallbacks", [](const auto&, const auto&) {
+    return control->core()->scrape_batcher()->fallbacks();
+  });
+
   CMD2_ANY_STRING_V("dht.mode.set", [](const auto&, const auto& arg) {
     return control->dht_manager()->set_mode(arg);
   });
@@ -5,6 +5,8 @@
 #include "control.h"
 #include "core/manager.h"
 #include "core/view_manager.h"
+#include "display/column_layout.h"
+#include "display/manager.h"
 #include "rpc/command.h"
 #include "rpc/parse.h"
 #include "ui/root.h"
@@ -305,8 +307,38 @@ initialize_command_ui() {
                   return cmd_status_throttle_names(false, args);
                 });
 
-  // TODO: Add 'option_string' for rtorrent-specific options.
-  CMD2_VAR_STRING("ui.torrent_list.layout", "full");
+  CMD2_ANY("ui.torrent_list.layout", [](const auto&, const auto&) {
+    return display::downloadListLayout.name;
+  });
+  CMD2_ANY_STRING_V("ui.torrent_list.layout.set",
+                    [](const auto&, const auto& name) {
+                      if (name != "full" && name != "compact")
+                        throw torrent::input_error(
+                          "Invalid torrent list layout, valid layouts are "
+                          "'full' and 'compact'.");
+
+                      display::downloadListLayout.name = name;
+                    });
+  CMD2_ANY("ui.torrent_list.columns", [](const auto&, const auto&) {
+    return display::downloadListLayout.columns.spec();
+  });
+  CMD2_ANY_STRING_V("ui.torrent_list.columns.set",
+                    [](const auto&, const auto& spec) {
+                      display::downloadListLayout.columns =
+                        display::ColumnLayout(spec);
+                    });
+
+  CMD2_ANY("ui.refresh.idle_period", [](const auto&, const auto&) {
+    return (int64_t)control->display()->idle_period();
+  });
+  CMD2_ANY_VALUE_V("ui.refresh.idle_period.set",
+                   [](const auto&, const auto& seconds) {
+                     if (seconds < 0)
+                       throw torrent::input_error(
+                         "Idle period must be zero or positive.");
+
+                     control->display()->set_idle_period(seconds);
+                   });
 
   CMD2_ANY("print", &apply_print);
 }
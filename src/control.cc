@@ -26,6 +26,7 @@
 #include "rpc/object_storage.h"
 #include "rpc/parse_commands.h"
 #include "rpc/scgi.h"
+#include "thread_queue.h"
 #include "ui/root.h"
 
 #include "control.h"
@@ -39,14 +40,17 @@ Control::Control()
 
   m_commandScheduler(new rpc::CommandScheduler())
   , m_objectStorage(new rpc::object_storage())
-  , m_directory_events(new torrent::directory_events()) {
+  , m_directory_events(new torrent::directory_events())
+  , m_mainQueue(new ThreadQueue) {
 
   m_core        = new core::Manager();
   m_viewManager = new core::ViewManager();
   m_dhtManager  = new core::DhtManager();
 
-  m_inputStdin->slot_pressed(
-    [this](const auto& key) { m_input->pressed(key); });
+  m_inputStdin->slot_pressed([this](const auto& key) {
+    m_display->receive_activity();
+    m_input->pressed(key);
+  });
 
   m_taskShutdown.slot() = [this] { handle_shutdown(); };
 
@@ -65,6 +69,7 @@ Control::~Control() {
   delete m_core;
   delete m_dhtManager;
 
+  delete m_mainQueue;
   delete m_directory_events;
   delete m_commandScheduler;
   delete m_objectStorage;
@@ -92,6 +97,12 @@ Control::initialize() {
   if (display::Canvas::isInitialized()) {
     m_inputStdin->insert(torrent::main_thread()->poll());
   }
+
+  rpc::execFile.spawner()->activate();
+
+  // Attached before the worker thread is started, so it is never seen
+  // detached by the SCGI worker until cleanup.
+  m_mainQueue->attach(torrent::main_thread()->poll());
 }
 
 void
@@ -105,6 +116,11 @@ Control::cleanup() {
     m_inputStdin->remove(torrent::main_thread()->poll());
   }
 
+  rpc::execFile.spawner()->deactivate();
+  rpc::execFile.spawner()->close();
+
+  m_mainQueue->detach();
+
   m_core->download_store()->disable();
 
   m_ui->cleanup();
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "core/address_trie.h"
+
+namespace core {
+
+AddressKey
+AddressKey::from_ipv4(uint32_t addr) {
+  AddressKey key;
+  key.low = (uint64_t(0xffff) << 32) | addr;
+  return key;
+}
+
+AddressKey
+AddressKey::from_ipv6(const uint8_t* addr) {
+  AddressKey key;
+
+  for (int i = 0; i < 8; i++) {
+    key.high = (key.high << 8) | addr[i];
+    key.low  = (key.low << 8) | addr[i + 8];
+  }
+
+  return key;
+}
+
+bool
+AddressKey::from_sockaddr(const sockaddr* sa, AddressKey* key) {
+  switch (sa->sa_family) {
+    case AF_INET:
+      *key = from_ipv4(
+        ntohl(reinterpret_cast<const sockaddr_in*>(sa)->sin_addr.s_addr));
+      return true;
+    case AF_INET6:
+      *key = from_ipv6(
+        reinterpret_cast<const sockaddr_in6*>(sa)->sin6_addr.s6_addr);
+      return true;
+    default:
+      return false;
+  }
+}
+
+AddressKey
+AddressKey::masked(unsigned int length) const {
+  AddressKey key;
+
+  if (length >= bits) {
+    key = *this;
+  } else if (length > 64) {
+    key.high = high;
+    key.low  = low & ~(~uint64_t() >> (length - 64));
+  } else if (length == 64) {
+    key.high = high;
+  } else if (length != 0) {
+    key.high = high & ~(~uint64_t() >> length);
+  }
+
+  return key;
+}
+
+AddressKey
+AddressKey::filled(unsigned int length) const {
+  AddressKey mask = AddressKey{ ~uint64_t(), ~uint64_t() }.masked(length);
+
+  return AddressKey{ high | ~mask.high, low | ~mask.low };
+}
+
+unsigned int
+AddressKey::common_length(const AddressKey& other) const {
+  if (high != other.high)
+    return __builtin_clzll(high ^ other.high);
+
+  if (low != other.low)
+    return 64 + __builtin_clzll(low ^ other.low);
+
+  return bits;
+}
+
+}
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <torrent/download/choke_group.h>
+#include <torrent/download/choke_queue.h>
+#include <torrent/exceptions.h>
+#include <torrent/peer/peer.h>
+#include <torrent/rate.h>
+
+#include "core/choke_group_manager.h"
+#include "core/download.h"
+
+namespace core {
+
+static void
+add_stats(Download* download, ChokeGroupManager::group_stats& result) {
+  result.up_rate += download->info()->up_rate()->rate();
+  result.down_rate += download->info()->down_rate()->rate();
+
+  if (!download->is_active())
+    return;
+
+  result.active++;
+
+  for (const auto& peer : *download->connection_list()) {
+    result.peers++;
+    result.up_unchoked += !peer->is_up_choked();
+    result.down_unchoked += !peer->is_down_choked_limited();
+  }
+}
+
+ChokeGroupManager::ChokeGroupManager()
+  : m_slotGroup([](Download* d) { return d->group(); })
+  , m_slotSetGroup([](Download* d, uint32_t index) { d->set_group(index); })
+  , m_slotStats(&add_stats) {}
+
+ChokeGroupManager::~ChokeGroupManager() {
+  clear();
+}
+
+int64_t
+ChokeGroupManager::index_of(const std::string& name) const {
+  auto itr = m_index.find(name);
+
+  return itr != m_index.end() ? (int64_t)itr->second : -1;
+}
+
+ChokeGroupManager::group_entry&
+ChokeGroupManager::entry_at(uint32_t index) {
+  if (index >= m_groups.size())
+    throw torrent::input_error("Choke group not found.");
+
+  return m_groups[index];
+}
+
+torrent::choke_group*
+ChokeGroupManager::at(uint32_t index) {
+  return entry_at(index).group;
+}
+
+const ChokeGroupManager::member_set&
+ChokeGroupManager::members(uint32_t index) const {
+  if (index >= m_groups.size())
+    throw torrent::input_error("Choke group not found.");
+
+  return m_groups[index].members;
+}
+
+torrent::choke_group*
+ChokeGroupManager::insert(const std::string& name) {
+  if (name.empty() || m_index.find(name) != m_index.end())
+    throw torrent::input_error("Duplicate name for choke group.");
+
+  torrent::choke_group* group = new torrent::choke_group();
+  group->set_name(name);
+
+  group->up_queue()->set_heuristics(
+    torrent::choke_queue::HEURISTICS_UPLOAD_LEECH);
+  group->down_queue()->set_heuristics(
+    torrent::choke_queue::HEURISTICS_DOWNLOAD_LEECH);
+
+  m_index[name] = m_groups.size();
+  m_groups.push_back(group_entry{ group, member_set() });
+
+  return group;
+}
+
+void
+ChokeGroupManager::clear() {
+  for (auto& entry : m_groups)
+    delete entry.group;
+
+  m_groups.clear();
+  m_index.clear();
+}
+
+void
+ChokeGroupManager::erase_group(uint32_t index) {
+  if (index == 0)
+    throw torrent::input_error("Cannot erase the default choke group.");
+
+  group_entry& entry = entry_at(index);
+
+  for (Download* download : entry.members) {
+    m_slotSetGroup(download, 0);
+    m_groups.front().members.insert(download);
+  }
+
+  m_index.erase(entry.group->name());
+  delete entry.group;
+
+  m_groups.erase(m_groups.begin() + index);
+
+  for (; index != m_groups.size(); index++) {
+    m_index[m_groups[index].group->name()] = index;
+
+    for (Download* download : m_groups[index].members)
+      m_slotSetGroup(download, index);
+  }
+}
+
+void
+ChokeGroupManager::rename_group(uint32_t index, const std::string& name) {
+  group_entry& entry = entry_at(index);
+
+  if (name == entry.group->name())
+    return;
+
+  if (name.empty() || m_index.find(name) != m_index.end())
+    throw torrent::input_error("Duplicate name for choke group.");
+
+  m_index.erase(entry.group->name());
+  m_index[name] = index;
+
+  entry.group->set_name(name);
+}
+
+void
+ChokeGroupManager::insert(Download* download) {
+  uint32_t index = m_slotGroup(download);
+
+  if (index < m_groups.size())
+    m_groups[index].members.insert(download);
+}
+
+void
+ChokeGroupManager::erase(Download* download) {
+  uint32_t index = m_slotGroup(download);
+
+  if (index < m_groups.size())
+    m_groups[index].members.erase(download);
+}
+
+void
+ChokeGroupManager::set_group(Download* download, uint32_t index) {
+  group_entry& entry = entry_at(index);
+
+  erase(download);
+  m_slotSetGroup(download, index);
+  entry.members.insert(download);
+}
+
+ChokeGroupManager::group_stats
+ChokeGroupManager::stats(uint32_t index) const {
+  group_stats result;
+
+  for (Download* download : members(index))
+    m_slotStats(download, result);
+
+  return result;
+}
+
+}
@@ -14,10 +14,13 @@ namespace core {
 
 size_t
 curl_get_receive_write(void* data, size_t size, size_t nmemb, void* handle) {
-  if (!((CurlGet*)handle)
-         ->stream()
-         ->write((const char*)data, size * nmemb)
-         .fail())
+  CurlGet* get = (CurlGet*)handle;
+
+  if (get->write_slot())
+    return get->write_slot()((const char*)data, size * nmemb) ? size * nmemb
+                                                               : 0;
+
+  if (!get->stream()->write((const char*)data, size * nmemb).fail())
     return size * nmemb;
   else
     return 0;
@@ -27,13 +30,60 @@ CurlGet::~CurlGet() {
   close();
 }
 
+const char*
+CurlGet::class_name(int c) {
+  switch (c) {
+    case class_announce:
+      return "announce";
+    case class_scrape:
+      return "scrape";
+    case class_metadata:
+      return "metadata";
+    case class_user:
+      return "user";
+    default:
+      return "unknown";
+  }
+}
+
+std::string
+CurlGet::parse_host(const std::string& url) {
+  std::string::size_type first = url.find("://");
+
+  if (first == std::string::npos)
+    first = 0;
+  else
+    first += 3;
+
+  std::string::size_type last = url.find_first_of("/?#", first);
+  std::string            host = url.substr(first, last - first);
+
+  std::string::size_type userinfo = host.rfind('@');
+
+  if (userinfo != std::string::npos)
+    host.erase(0, userinfo + 1);
+
+  return host;
+}
+
+// Trackers follow the convention of replacing the last "announce"
+// path component with "scrape" for scrape requests.
+bool
+CurlGet::is_scrape_url(const std::string& url) {
+  std::string::size_type last  = url.find_first_of("?#");
+  std::string::size_type slash = url.rfind('/', last);
+
+  return slash != std::string::npos &&
+         url.compare(slash + 1, 6, "scrape") == 0;
+}
+
 void
 CurlGet::start() {
   if (is_busy())
     throw torrent::internal_error(
       "Tried to call CurlGet::start on a busy object.");
 
-  if (m_stream == nullptr)
+  if (m_stream == nullptr && !m_slot_write)
     throw torrent::internal_error(
       "Tried to call CurlGet::start without a valid output stream.");
 
@@ -60,7 +110,6 @@ CurlGet::start() {
                             torrent::utils::timer::from_seconds(m_timeout + 5));
   }
 
-  curl_easy_setopt(m_handle, CURLOPT_FORBID_REUSE, (long)1);
   curl_easy_setopt(m_handle, CURLOPT_NOSIGNAL, (long)1);
   curl_easy_setopt(m_handle, CURLOPT_FOLLOWLOCATION, (long)1);
   curl_easy_setopt(m_handle, CURLOPT_MAXREDIRS, (long)5);
@@ -70,6 +119,13 @@ CurlGet::start() {
   curl_easy_setopt(m_handle, CURLOPT_ENCODING, "");
 
   m_ipv6 = false;
+  m_host = parse_host(m_url);
+
+  // Tracker requests reuse the same object for announces and scrapes.
+  if (m_baseClass == class_announce && is_scrape_url(m_url))
+    m_requestClass = class_scrape;
+  else
+    m_requestClass = m_baseClass;
 
   m_stack->add_get(this);
 }
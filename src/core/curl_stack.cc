@@ -3,8 +3,10 @@
 
 #include <algorithm>
 
+#include <curl/curl.h>
 #include <curl/multi.h>
 #include <torrent/exceptions.h>
+#include <torrent/utils/timer.h>
 
 #include "core/curl_get.h"
 #include "core/curl_socket.h"
@@ -12,10 +14,85 @@
 
 namespace core {
 
+void
+CurlHostQueue::push_back(CurlGet* get, const std::string& host) {
+  host_map::iterator itr = m_hosts.emplace(host, host_map::mapped_type()).first;
+
+  if (itr->second.empty())
+    m_order.emplace(m_sequence, itr);
+
+  itr->second.push_back(entry_type{ m_sequence++, get });
+  m_size++;
+}
+
+bool
+CurlHostQueue::erase(CurlGet* get, const std::string& host) {
+  host_map::iterator itr = m_hosts.find(host);
+
+  if (itr == m_hosts.end())
+    return false;
+
+  auto& queue = itr->second;
+  auto  entry = std::find_if(queue.begin(), queue.end(), [get](const auto& e) {
+    return e.get == get;
+  });
+
+  if (entry == queue.end())
+    return false;
+
+  m_size--;
+
+  if (entry != queue.begin()) {
+    queue.erase(entry);
+    return true;
+  }
+
+  // The host moves to the position of its next oldest request.
+  m_order.erase(entry->sequence);
+  queue.pop_front();
+
+  if (queue.empty())
+    m_hosts.erase(itr);
+  else
+    m_order.emplace(queue.front().sequence, itr);
+
+  return true;
+}
+
+CurlGet*
+CurlHostQueue::front_available(const slot_available& available) const {
+  for (const auto& order : m_order)
+    if (available(order.second->first))
+      return order.second->second.front().get;
+
+  return nullptr;
+}
+
+// The multi handle keeps a connection cache shared by all the easy
+// handles added to it, while the share handle lets them reuse DNS
+// lookups and TLS sessions.
 CurlStack::CurlStack()
-  : m_handle((void*)curl_multi_init()) {
+  : m_handle((void*)curl_multi_init())
+  , m_shareHandle((void*)curl_share_init()) {
   m_taskTimeout.slot() = [this] { receive_timeout(); };
 
+  // Tracker announces are the most latency sensitive, while a burst
+  // of scrapes or .torrent fetches can wait.
+  m_stats[CurlGet::class_announce] = class_stats{ 8, 0, 0, 0, 0, 0 };
+  m_stats[CurlGet::class_scrape]   = class_stats{ 2, 0, 0, 0, 0, 0 };
+  m_stats[CurlGet::class_metadata] = class_stats{ 4, 0, 0, 0, 0, 0 };
+  m_stats[CurlGet::class_user]     = class_stats{ 4, 0, 0, 0, 0, 0 };
+
+  curl_share_setopt(
+    (CURLSH*)m_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(
+    (CURLSH*)m_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+#ifdef CURLPIPE_MULTIPLEX
+  curl_multi_setopt(
+    (CURLM*)m_handle, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+#endif
+
   curl_multi_setopt((CURLM*)m_handle, CURLMOPT_TIMERDATA, this);
   curl_multi_setopt(
     (CURLM*)m_handle, CURLMOPT_TIMERFUNCTION, &CurlStack::set_timeout);
@@ -25,16 +102,51 @@ CurlStack::CurlStack()
 }
 
 CurlStack::~CurlStack() {
+  // Make sure closing the active requests doesn't start queued ones.
+  m_maxActive = 0;
+
   while (!empty())
     front()->close();
 
   curl_multi_cleanup((CURLM*)m_handle);
+  curl_share_cleanup((CURLSH*)m_shareHandle);
   priority_queue_erase(&taskScheduler, &m_taskTimeout);
 }
 
 CurlGet*
-CurlStack::new_object() {
-  return new CurlGet(this);
+CurlStack::new_object(int requestClass) {
+  return new CurlGet(this, requestClass);
+}
+
+void
+CurlStack::set_max_active(unsigned int a) {
+  m_maxActive = a;
+  activate_pending();
+}
+
+void
+CurlStack::set_max_active_per_host(unsigned int a) {
+  m_maxActivePerHost = a;
+  activate_pending();
+}
+
+long
+CurlStack::http_version() const {
+#if LIBCURL_VERSION_NUM >= 0x072f00
+  if (m_http2 && (curl_version_info(CURLVERSION_NOW)->features &
+                  CURL_VERSION_HTTP2))
+    return CURL_HTTP_VERSION_2TLS;
+#endif
+
+  return CURL_HTTP_VERSION_1_1;
+}
+
+void
+CurlStack::set_weight(int requestClass, unsigned int weight) {
+  if (weight == 0)
+    throw torrent::input_error("Request class weight must be positive.");
+
+  m_stats[requestClass].weight = weight;
 }
 
 CurlSocket*
@@ -167,17 +279,31 @@ CurlStack::add_get(CurlGet* get) {
   curl_easy_setopt(
     get->handle(), CURLOPT_SSL_VERIFYPEER, (long)(m_ssl_verify_peer ? 1 : 0));
   curl_easy_setopt(get->handle(), CURLOPT_DNS_CACHE_TIMEOUT, m_dns_timeout);
+  curl_easy_setopt(get->handle(), CURLOPT_SHARE, (CURLSH*)m_shareHandle);
 
-  base_type::push_back(get);
+  curl_easy_setopt(
+    get->handle(), CURLOPT_FORBID_REUSE, (long)(m_keep_alive ? 0 : 1));
+  curl_easy_setopt(
+    get->handle(), CURLOPT_TCP_KEEPALIVE, (long)(m_keep_alive ? 1 : 0));
 
-  if (m_active >= m_maxActive)
-    return;
+  // Set explicitly as libcurl 7.62 and later default to HTTP/2 over
+  // TLS.
+  curl_easy_setopt(get->handle(), CURLOPT_HTTP_VERSION, http_version());
 
-  m_active++;
-  get->set_active(true);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+  if (http_version() == CURL_HTTP_VERSION_2TLS) {
+    // Wait for an existing connection to confirm multiplexing rather
+    // than opening a new connection to the same host.
+    curl_easy_setopt(get->handle(), CURLOPT_PIPEWAIT, (long)1);
+  }
+#endif
 
-  if (curl_multi_add_handle((CURLM*)m_handle, get->handle()) > 0)
-    throw torrent::internal_error("Error calling curl_multi_add_handle.");
+  base_type::push_back(get);
+
+  get->m_timeQueued = torrent::utils::timer::current_usec();
+  m_queued[get->request_class()].push_back(get, get->host());
+
+  activate_pending();
 }
 
 void
@@ -190,26 +316,113 @@ CurlStack::remove_get(CurlGet* get) {
 
   base_type::erase(itr);
 
-  // The CurlGet object was never activated, so we just skip this one.
-  if (!get->is_active())
+  // The CurlGet object was never activated, so we just remove it from
+  // the queue.
+  if (!get->is_active()) {
+    if (!m_queued[get->request_class()].erase(get, get->host()))
+      throw torrent::internal_error(
+        "Could not find queued CurlGet when calling CurlStack::remove.");
+
     return;
+  }
 
   get->set_active(false);
 
   if (curl_multi_remove_handle((CURLM*)m_handle, get->handle()) > 0)
     throw torrent::internal_error("Error calling curl_multi_remove_handle.");
 
-  if (m_active == m_maxActive &&
-      (itr = std::find_if(
-         begin(), end(), std::not_fn(std::mem_fn(&CurlGet::is_active)))) !=
-        end()) {
-    (*itr)->set_active(true);
+  class_stats& stats = m_stats[get->request_class()];
 
-    if (curl_multi_add_handle((CURLM*)m_handle, (*itr)->handle()) > 0)
-      throw torrent::internal_error("Error calling curl_multi_add_handle.");
+  stats.active--;
+  stats.completed++;
+  stats.time_usec +=
+    torrent::utils::timer::current_usec() - get->m_timeStarted;
 
-  } else {
-    m_active--;
+  host_map::iterator hostItr = m_hostActive.find(get->host());
+
+  if (hostItr != m_hostActive.end() && --hostItr->second == 0)
+    m_hostActive.erase(hostItr);
+
+  m_active--;
+  activate_pending();
+}
+
+bool
+CurlStack::is_host_available(const std::string& host) const {
+  if (m_maxActivePerHost == 0)
+    return true;
+
+  host_map::const_iterator itr = m_hostActive.find(host);
+
+  return itr == m_hostActive.end() || itr->second < m_maxActivePerHost;
+}
+
+// Stride scheduling between the request classes; each class advances
+// its pass by the inverse of its weight when a request is started,
+// and the class with the lowest pass goes next. Idle classes are
+// brought up to the current pass so they can't build up credit.
+CurlGet*
+CurlStack::select_next() {
+  int      bestClass = -1;
+  CurlGet* best      = nullptr;
+
+  CurlHostQueue::slot_available available = [this](const std::string& host) {
+    return is_host_available(host);
+  };
+
+  for (int c = 0; c < CurlGet::class_size; c++) {
+    if (bestClass != -1 && std::max(m_stats[c].pass, m_pass) >=
+                             std::max(m_stats[bestClass].pass, m_pass))
+      continue;
+
+    CurlGet* get = m_queued[c].front_available(available);
+
+    if (get == nullptr)
+      continue;
+
+    bestClass = c;
+    best      = get;
+  }
+
+  if (bestClass == -1)
+    return nullptr;
+
+  class_stats& stats = m_stats[bestClass];
+
+  m_queued[bestClass].erase(best, best->host());
+
+  m_pass     = std::max(stats.pass, m_pass);
+  stats.pass = m_pass + (1 << 16) / stats.weight;
+
+  return best;
+}
+
+void
+CurlStack::activate(CurlGet* get) {
+  class_stats& stats = m_stats[get->request_class()];
+
+  get->set_active(true);
+  get->m_timeStarted = torrent::utils::timer::current_usec();
+
+  stats.active++;
+  stats.wait_usec += get->m_timeStarted - get->m_timeQueued;
+
+  m_hostActive[get->host()]++;
+  m_active++;
+
+  if (curl_multi_add_handle((CURLM*)m_handle, get->handle()) > 0)
+    throw torrent::internal_error("Error calling curl_multi_add_handle.");
+}
+
+void
+CurlStack::activate_pending() {
+  while (m_active < m_maxActive) {
+    CurlGet* get = select_next();
+
+    if (get == nullptr)
+      return;
+
+    activate(get);
   }
 }
 
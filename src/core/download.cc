@@ -72,6 +72,26 @@ Download::set_priority(uint32_t p) {
   bencode()->get_key("rtorrent").insert_key("priority", (int64_t)p);
 }
 
+const char*
+Download::priority_str() {
+  static const char* names[] = { "off", "low", "normal", "high" };
+
+  uint32_t p = priority();
+
+  return p < 4 ? names[p] : nullptr;
+}
+
+int64_t
+Download::ratio() {
+  if (is_hash_checking())
+    return 0;
+
+  int64_t bytesDone = m_download.bytes_done();
+  int64_t upTotal   = info()->up_rate()->total();
+
+  return bytesDone > 0 ? (1000 * upTotal) / bytesDone : 0;
+}
+
 uint32_t
 Download::connection_list_size() const {
   return m_download.connection_list()->size();
@@ -153,6 +173,7 @@ Download::set_root_directory(const std::string& path) {
 
   control->core()->download_list()->close_directly(this);
   file_list->set_root_dir(torrent::utils::path_expand(path));
+  control->core()->hash_scheduler()->invalidate_device(this);
 
   bencode()->get_key("rtorrent").insert_key("directory", path);
 }
@@ -18,6 +18,7 @@
 #include <torrent/utils/string_manip.h>
 
 #include "rpc/parse_commands.h"
+#include "utils/bencode_decoder.h"
 
 #include "control.h"
 #include "core/curl_get.h"
@@ -90,6 +91,7 @@ DownloadFactory::~DownloadFactory() {
 
   delete m_stream;
   delete m_object;
+  delete m_decoder;
   m_stream = nullptr;
 }
 
@@ -130,13 +132,21 @@ DownloadFactory::receive_load() {
       "DownloadFactory::load*() called on an object with m_stream != NULL");
 
   if (is_network_uri(m_uri)) {
-    // Http handling here.
-    m_stream                = new std::stringstream;
-    HttpQueue::iterator itr = m_manager->http_queue()->insert(m_uri, m_stream);
-
-    (*itr)->signal_done().push_front([this] { receive_loaded(); });
-    (*itr)->signal_failed().push_front(
-      [this](const auto& msg) { receive_failed(msg); });
+    // Http handling here. The torrent is decoded as it arrives,
+    // rather than buffering the whole response first.
+    m_decoder = new utils::BencodeDecoder(
+      rpc::call_command_value("network.http.max_metadata_size"));
+
+    HttpQueue::iterator itr = m_manager->http_queue()->insert(
+      m_uri, [this](const char* data, size_t length) {
+        return m_decoder->write(data, length);
+      });
+
+    (*itr)->signal_done().push_front([this] { receive_decoded(); });
+    (*itr)->signal_failed().push_front([this](const auto& msg) {
+      receive_failed(m_decoder->is_error() ? std::string(m_decoder->error())
+                                           : msg);
+    });
 
     m_variables["tied_to_file"] = (int64_t) false;
 
@@ -175,6 +185,19 @@ DownloadFactory::receive_loaded() {
     receive_success();
 }
 
+void
+DownloadFactory::receive_decoded() {
+  if (!m_decoder->is_done())
+    return receive_failed("Incomplete torrent data");
+
+  m_object = m_decoder->release();
+
+  delete m_decoder;
+  m_decoder = nullptr;
+
+  receive_loaded();
+}
+
 void
 DownloadFactory::receive_commit() {
   m_commited = true;
@@ -474,6 +497,11 @@ DownloadFactory::initialize_rtorrent(Download*        download,
   rtorrent->insert_preserve_copy("timestamp.last_active", (int64_t)0);
 
   rtorrent->insert_preserve_copy("tied_to_file", "");
+
+  rtorrent->insert_preserve_copy("scrape_complete", (int64_t)0);
+  rtorrent->insert_preserve_copy("scrape_incomplete", (int64_t)0);
+  rtorrent->insert_preserve_copy("scrape_downloaded", (int64_t)0);
+  rtorrent->insert_preserve_copy("scrape_time_last", (int64_t)0);
   rtorrent->insert_key("loaded_file", m_isFile ? m_uri : std::string());
 
   if (rtorrent->has_key_value("priority"))
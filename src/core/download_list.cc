@@ -4,6 +4,7 @@
 #include "buildinfo.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <torrent/data/file.h>
@@ -30,6 +31,7 @@
 #include "core/download_list.h"
 #include "core/download_store.h"
 #include "ui/root.h"
+#include "utils/trace_ring.h"
 
 #define DL_TRIGGER_EVENT(download, event_name)                                 \
   rpc::commands.call_catch(event_name,                                         \
@@ -39,6 +41,16 @@
 
 namespace core {
 
+// The leading bytes of the info hash, enough to tell downloads apart
+// in a trace.
+static int64_t
+trace_hash(Download* download) {
+  int64_t result;
+  std::memcpy(&result, download->info()->hash().data(), sizeof(result));
+
+  return result;
+}
+
 #ifdef RT_USE_EXTRA_DEBUG
 inline void
 DownloadList::check_contains(Download* d) {
@@ -183,6 +195,9 @@ DownloadList::insert(Download* download) {
       this->received_inactive(download);
     };
 
+    control->core()->choke_group_manager()->insert(download);
+    control->core()->search_index()->insert(download);
+
     // This needs to be separated into two different calls to ensure
     // the download remains in the view.
     for (const auto& view : *control->view_manager()) {
@@ -233,6 +248,11 @@ DownloadList::erase(iterator itr) {
     v->erase(*itr);
   }
 
+  control->core()->hash_scheduler()->erase(*itr);
+  control->core()->queue_manager()->erase(*itr);
+  control->core()->choke_group_manager()->erase(*itr);
+  control->core()->search_index()->erase(*itr);
+
   torrent::download_remove(*(*itr)->download());
   delete *itr;
 
@@ -375,6 +395,8 @@ void
 DownloadList::resume(Download* download, int flags) {
   check_contains(download);
 
+  utils::trace(utils::TRACE_DOWNLOAD_RESUME, trace_hash(download), flags);
+
   lt_log_print_info(torrent::LOG_TORRENT_INFO,
                     download->info(),
                     "download_list",
@@ -523,6 +545,8 @@ void
 DownloadList::pause(Download* download, int flags) {
   check_contains(download);
 
+  utils::trace(utils::TRACE_DOWNLOAD_PAUSE, trace_hash(download), flags);
+
   lt_log_print_info(torrent::LOG_TORRENT_INFO,
                     download->info(),
                     "download_list",
@@ -622,6 +646,10 @@ DownloadList::hash_done(Download* download) {
   lt_log_print_info(
     torrent::LOG_TORRENT_INFO, download->info(), "download_list", "Hash done.");
 
+  utils::trace(utils::TRACE_DOWNLOAD_HASH,
+               trace_hash(download),
+               download->is_hash_checked());
+
   if (download->is_hash_checking() || download->is_active())
     throw torrent::internal_error(
       "DownloadList::hash_done(...) download in invalid state.");
@@ -774,6 +802,8 @@ DownloadList::confirm_finished(Download* download) {
                     "download_list",
                     "Confirming finished.");
 
+  utils::trace(utils::TRACE_DOWNLOAD_FINISHED, trace_hash(download));
+
   if (download->download()->info()->is_meta_download())
     return process_meta_download(download);
 
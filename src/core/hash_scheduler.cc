@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <torrent/bitfield.h>
+#include <torrent/data/file_list.h>
+#include <torrent/download.h>
+#include <torrent/exceptions.h>
+#include <torrent/object.h>
+#include <torrent/utils/log.h>
+#include <torrent/utils/resume.h>
+
+#include "rpc/parse_commands.h"
+
+#include "core/download.h"
+#include "core/download_list.h"
+#include "core/hash_scheduler.h"
+#include "core/view.h"
+
+namespace core {
+
+uint32_t
+HashScheduler::max_active() const {
+  if (m_maxActive != 0)
+    return m_maxActive;
+
+  return std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+}
+
+uint64_t
+HashScheduler::bytes_left() const {
+  uint64_t result = m_waitingBytes;
+
+  for (const auto& entry : m_active) {
+    uint64_t hashed = (uint64_t)entry.first->download()->chunks_hashed() *
+                      entry.first->file_list()->chunk_size();
+
+    result += entry.second.size - std::min(hashed, entry.second.size);
+  }
+
+  return result;
+}
+
+HashScheduler::device_type
+HashScheduler::find_device(const std::string& root) {
+  struct stat st;
+
+  // Walk up the path until we find something that exists, as the
+  // root directory of a multi-file torrent may not be created yet.
+  std::string path = root;
+
+  while (!path.empty() && ::stat(path.c_str(), &st) != 0) {
+    std::string::size_type split = path.rfind('/', path.size() - 2);
+
+    if (split == std::string::npos)
+      return device_type();
+
+    path.resize(split + 1);
+  }
+
+  return path.empty() ? device_type() : st.st_dev;
+}
+
+HashScheduler::device_type
+HashScheduler::device_of(Download* download) {
+  auto itr = m_devices.find(download);
+
+  if (itr == m_devices.end())
+    itr = m_devices
+            .emplace(download, find_device(download->file_list()->root_dir()))
+            .first;
+
+  return itr->second;
+}
+
+// Partially completed downloads go first as they are the most likely
+// to be wanted back soon, then the smallest so that as many downloads
+// as possible become usable early.
+bool
+HashScheduler::compare_priority(const candidate_type& a,
+                                const candidate_type& b) {
+  if (a.partial != b.partial)
+    return a.partial;
+
+  return a.size < b.size;
+}
+
+HashScheduler::candidate_list
+HashScheduler::start_waiting(candidate_list    candidates,
+                             device_map*       active,
+                             uint32_t          maxActive,
+                             uint32_t          maxPerDevice,
+                             const slot_start& start) {
+  std::stable_sort(candidates.begin(), candidates.end(), &compare_priority);
+
+  uint32_t       activeCount = 0;
+  candidate_list waiting;
+
+  for (const auto& entry : *active)
+    activeCount += entry.second;
+
+  for (const auto& candidate : candidates) {
+    auto device = active->find(candidate.device);
+
+    if (activeCount >= maxActive ||
+        (maxPerDevice != 0 && device != active->end() &&
+         device->second >= maxPerDevice)) {
+      waiting.push_back(candidate);
+      continue;
+    }
+
+    if (!start(candidate))
+      continue;
+
+    (*active)[candidate.device]++;
+    activeCount++;
+  }
+
+  return waiting;
+}
+
+void
+HashScheduler::insert_active(Download* download) {
+  device_type device = device_of(download);
+
+  m_active[download] =
+    active_entry{ device, download->file_list()->size_bytes() };
+  m_deviceActive[device]++;
+}
+
+HashScheduler::active_map::iterator
+HashScheduler::erase_active(active_map::iterator itr) {
+  auto device = m_deviceActive.find(itr->second.device);
+
+  if (--device->second == 0)
+    m_deviceActive.erase(device);
+
+  return m_active.erase(itr);
+}
+
+void
+HashScheduler::erase(Download* download) {
+  auto itr = m_active.find(download);
+
+  if (itr != m_active.end())
+    erase_active(itr);
+
+  m_devices.erase(download);
+}
+
+void
+HashScheduler::reap_finished() {
+  for (auto itr = m_active.begin(); itr != m_active.end();) {
+    if (itr->first->is_hash_checking()) {
+      ++itr;
+      continue;
+    }
+
+    // Stopped or failed hash checks are not counted.
+    if (!itr->first->is_hash_failed() && itr->first->is_hash_checked()) {
+      m_checked++;
+      m_bytesChecked += itr->second.size;
+    }
+
+    itr = erase_active(itr);
+  }
+}
+
+bool
+HashScheduler::start_check(Download* download) {
+  try {
+    m_downloadList->open_throw(download);
+
+    // Since the bitfield is allocated on loading of resume load or
+    // hash start, and unallocated on close, we know that if it it
+    // not empty then we have already loaded any existing resume
+    // data.
+    if (download->download()->file_list()->bitfield()->empty())
+      torrent::resume_load_progress(
+        *download->download(),
+        download->download()->bencode()->get_key("libtorrent_resume"));
+
+    download->download()->hash_check(false);
+
+  } catch (torrent::local_error& e) {
+    download->set_hash_failed(true);
+    lt_log_print(torrent::LOG_TORRENT_ERROR, "Hashing failed: %s", e.what());
+    return false;
+  }
+
+  return true;
+}
+
+// DownloadList's hashing related functions don't actually start the
+// hashing, it only reacts to events. This functions checks the
+// hashing view and starts hashing if necessary.
+void
+HashScheduler::update(View* view) {
+  reap_finished();
+
+  candidate_list candidates;
+
+  for (View::iterator itr = view->begin_visible(), last = view->end_visible();
+       itr != last;
+       ++itr) {
+    Download* download = *itr;
+
+    if (download->is_hash_checked())
+      throw torrent::internal_error(
+        "core::HashScheduler::update() download->is_hash_checked().");
+
+    if (download->is_hash_failed())
+      continue;
+
+    // Hash checks not started by us, e.g. those already running when
+    // the scheduler took over, still count against the limits.
+    if (download->is_hash_checking()) {
+      if (m_active.find(download) == m_active.end())
+        insert_active(download);
+
+      continue;
+    }
+
+    // Try quick hashing all those with hashing == initial, which
+    // verifies the resume data and lets the download start without
+    // waiting for a slot. Set them to rehash when failed.
+    bool tryQuick =
+      rpc::call_command_value("d.hashing", rpc::make_target(download)) ==
+        Download::variable_hashing_initial &&
+      download->download()->file_list()->bitfield()->empty();
+
+    if (tryQuick) {
+      try {
+        m_downloadList->open_throw(download);
+
+        torrent::resume_load_progress(
+          *download->download(),
+          download->download()->bencode()->get_key("libtorrent_resume"));
+
+        if (download->download()->hash_check(true))
+          continue;
+
+        download->download()->hash_stop();
+
+      } catch (torrent::local_error& e) {
+      }
+
+      // Make sure we don't repeat the quick hashing.
+      rpc::call_command_set_value("d.hashing.set",
+                                  Download::variable_hashing_rehash,
+                                  rpc::make_target(download));
+    }
+
+    candidates.push_back(
+      candidate_type{ download,
+                      device_of(download),
+                      download->file_list()->completed_chunks() != 0,
+                      download->file_list()->size_bytes() });
+  }
+
+  // The per-device counts are updated by start_waiting, the entries in
+  // m_active by the slot.
+  auto waiting = start_waiting(std::move(candidates),
+                               &m_deviceActive,
+                               max_active(),
+                               m_maxPerDevice,
+                               [this](const candidate_type& candidate) {
+                                 if (!start_check(candidate.download))
+                                   return false;
+
+                                 m_active[candidate.download] =
+                                   active_entry{ candidate.device,
+                                                 candidate.size };
+                                 return true;
+                               });
+
+  m_waiting      = waiting.size();
+  m_waitingBytes = 0;
+
+  for (const auto& candidate : waiting)
+    m_waitingBytes += candidate.size;
+}
+
+}
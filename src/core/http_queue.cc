@@ -13,10 +13,28 @@ namespace core {
 
 HttpQueue::iterator
 HttpQueue::insert(const std::string& url, std::iostream* s) {
-  std::unique_ptr<CurlGet> h(m_slot_factory());
+  CurlGet* h = m_slot_factory();
 
   h->set_url(url);
   h->set_stream(s);
+
+  return insert_get(h);
+}
+
+HttpQueue::iterator
+HttpQueue::insert(const std::string& url, slot_write s) {
+  CurlGet* h = m_slot_factory();
+
+  h->set_url(url);
+  h->set_write_slot(s);
+
+  return insert_get(h);
+}
+
+HttpQueue::iterator
+HttpQueue::insert_get(CurlGet* get) {
+  std::unique_ptr<CurlGet> h(get);
+
   h->set_timeout(5 * 60);
 
   iterator signal_itr = base_type::insert(end(), h.get());
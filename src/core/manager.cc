@@ -20,7 +20,6 @@
 #include <torrent/utils/error_number.h>
 #include <torrent/utils/log.h>
 #include <torrent/utils/path.h>
-#include <torrent/utils/resume.h>
 #include <torrent/utils/string_manip.h>
 #include <unistd.h>
 
@@ -104,11 +103,18 @@ Manager::push_log(const char* msg) {
 Manager::Manager()
   : m_log_important(torrent::log_open_log_buffer("important"))
   , m_log_complete(torrent::log_open_log_buffer("complete")) {
-  m_downloadStore   = new DownloadStore();
-  m_downloadList    = new DownloadList();
-  m_fileStatusCache = new FileStatusCache();
-  m_httpQueue       = new HttpQueue();
-  m_httpStack       = new CurlStack();
+  m_downloadStore     = new DownloadStore();
+  m_downloadList      = new DownloadList();
+  m_hashScheduler     = new HashScheduler(m_downloadList);
+  m_queueManager      = new QueueManager(m_downloadList);
+  m_fileStatusCache   = new FileStatusCache();
+  m_httpQueue         = new HttpQueue();
+  m_httpStack         = new CurlStack();
+  m_scrapeBatcher     = new ScrapeBatcher(m_downloadList, m_httpStack);
+  m_throttleShaper    = new ThrottleShaper(&m_throttles);
+  m_chokeGroupManager = new ChokeGroupManager();
+  m_tickProfiler      = new TickProfiler();
+  m_searchIndex       = new SearchIndex();
 
   torrent::Throttle* unthrottled = torrent::Throttle::create_throttle();
   unthrottled->set_max_rate(0);
@@ -117,6 +123,13 @@ Manager::Manager()
 
 Manager::~Manager() {
   torrent::Throttle::destroy_throttle(m_throttles["NULL"].first);
+  delete m_searchIndex;
+  delete m_tickProfiler;
+  delete m_chokeGroupManager;
+  delete m_throttleShaper;
+  delete m_scrapeBatcher;
+  delete m_queueManager;
+  delete m_hashScheduler;
   delete m_downloadList;
 
   // TODO: Clean up logs objects.
@@ -154,10 +167,10 @@ Manager::get_throttle(const std::string& name) {
 }
 
 void
-Manager::set_address_throttle(uint32_t              begin,
-                              uint32_t              end,
+Manager::set_address_throttle(const AddressKey&     first,
+                              const AddressKey&     last,
                               torrent::ThrottlePair throttles) {
-  m_addressThrottles.set_merge(begin, end, throttles);
+  m_addressThrottles.insert_range(first, last, throttles);
   torrent::connection_manager()->address_throttle() = [](const auto& addr) {
     return control->core()->get_address_throttle(addr);
   };
@@ -165,9 +178,12 @@ Manager::set_address_throttle(uint32_t              begin,
 
 torrent::ThrottlePair
 Manager::get_address_throttle(const sockaddr* addr) {
-  return m_addressThrottles.get(
-    torrent::utils::socket_address::cast_from(addr)->sa_inet()->address_h(),
-    torrent::ThrottlePair(nullptr, nullptr));
+  AddressKey key;
+
+  if (!AddressKey::from_sockaddr(addr, &key))
+    return torrent::ThrottlePair(nullptr, nullptr);
+
+  return m_addressThrottles.get(key, torrent::ThrottlePair(nullptr, nullptr));
 }
 
 int64_t
@@ -204,8 +220,11 @@ Manager::retrieve_throttle_value(const torrent::Object::string_type& name,
 // Most of this should be possible to move out.
 void
 Manager::initialize_second() {
-  torrent::Http::slot_factory() = [this] { return m_httpStack->new_object(); };
-  m_httpQueue->set_slot_factory([this] { return m_httpStack->new_object(); });
+  torrent::Http::slot_factory() = [this] {
+    return m_httpStack->new_object(CurlGet::class_announce);
+  };
+  m_httpQueue->set_slot_factory(
+    [this] { return m_httpStack->new_object(CurlGet::class_metadata); });
 
   CurlStack::global_init();
 }
@@ -222,6 +241,7 @@ Manager::cleanup() {
 
   torrent::cleanup();
 
+  m_scrapeBatcher->clear();
   delete m_httpStack;
   CurlStack::global_cleanup();
 }
@@ -549,80 +569,9 @@ Manager::try_create_download_expand(const std::string& uri,
   return rawResult;
 }
 
-// DownloadList's hashing related functions don't actually start the
-// hashing, it only reacts to events. This functions checks the
-// hashing view and starts hashing if necessary.
 void
 Manager::receive_hashing_changed() {
-  bool foundHashing = std::find_if(m_hashingView->begin_visible(),
-                                   m_hashingView->end_visible(),
-                                   std::mem_fn(&Download::is_hash_checking)) !=
-                      m_hashingView->end_visible();
-
-  // Try quick hashing all those with hashing == initial, set them to
-  // something else when failed.
-  for (View::iterator itr  = m_hashingView->begin_visible(),
-                      last = m_hashingView->end_visible();
-       itr != last;
-       ++itr) {
-    if ((*itr)->is_hash_checked())
-      throw torrent::internal_error(
-        "core::Manager::receive_hashing_changed() (*itr)->is_hash_checked().");
-
-    if ((*itr)->is_hash_checking() || (*itr)->is_hash_failed())
-      continue;
-
-    bool tryQuick =
-      rpc::call_command_value("d.hashing", rpc::make_target(*itr)) ==
-        Download::variable_hashing_initial &&
-      (*itr)->download()->file_list()->bitfield()->empty();
-
-    if (!tryQuick && foundHashing)
-      continue;
-
-    try {
-      m_downloadList->open_throw(*itr);
-
-      // Since the bitfield is allocated on loading of resume load or
-      // hash start, and unallocated on close, we know that if it it
-      // not empty then we have already loaded any existing resume
-      // data.
-      if ((*itr)->download()->file_list()->bitfield()->empty())
-        torrent::resume_load_progress(
-          *(*itr)->download(),
-          (*itr)->download()->bencode()->get_key("libtorrent_resume"));
-
-      if (tryQuick) {
-        if ((*itr)->download()->hash_check(true))
-          continue;
-
-        (*itr)->download()->hash_stop();
-
-        if (foundHashing) {
-          rpc::call_command_set_value("d.hashing.set",
-                                      Download::variable_hashing_rehash,
-                                      rpc::make_target(*itr));
-          continue;
-        }
-      }
-
-      (*itr)->download()->hash_check(false);
-      foundHashing = true;
-
-    } catch (torrent::local_error& e) {
-      if (tryQuick) {
-        // Make sure we don't repeat the quick hashing.
-        rpc::call_command_set_value("d.hashing.set",
-                                    Download::variable_hashing_rehash,
-                                    rpc::make_target(*itr));
-
-      } else {
-        (*itr)->set_hash_failed(true);
-        lt_log_print(
-          torrent::LOG_TORRENT_ERROR, "Hashing failed: %s", e.what());
-      }
-    }
-  }
+  m_hashScheduler->update(m_hashingView);
 }
 
 }
@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <torrent/exceptions.h>
+#include <torrent/tracker.h>
+#include <torrent/tracker_list.h>
+
+#include "core/download.h"
+#include "core/download_list.h"
+#include "core/queue_manager.h"
+
+namespace core {
+
+void
+TrackerQueue::insert(const std::string& tracker, const entry_type& entry) {
+  m_positionsValid = false;
+  m_order.insert(entry);
+  m_buckets[tracker].insert(entry);
+}
+
+void
+TrackerQueue::erase(const std::string& tracker, const entry_type& entry) {
+  m_positionsValid = false;
+  m_order.erase(entry);
+
+  bucket_map::iterator itr = m_buckets.find(tracker);
+
+  if (itr == m_buckets.end())
+    return;
+
+  itr->second.erase(entry);
+
+  if (itr->second.empty())
+    m_buckets.erase(itr);
+}
+
+int64_t
+TrackerQueue::position(const entry_type& entry) const {
+  if (!m_positionsValid) {
+    int64_t index = 0;
+
+    m_positions.clear();
+
+    for (const auto& e : m_order)
+      m_positions[e.sequence] = index++;
+
+    m_positionsValid = true;
+  }
+
+  auto itr = m_positions.find(entry.sequence);
+
+  return itr != m_positions.end() ? itr->second : -1;
+}
+
+const TrackerQueue::entry_type*
+TrackerQueue::front_available(const slot_available& available) const {
+  const entry_type* result = nullptr;
+
+  for (const auto& bucket : m_buckets) {
+    const entry_type& head = *bucket.second.begin();
+
+    if ((result == nullptr || head < *result) && available(bucket.first))
+      result = &head;
+  }
+
+  return result;
+}
+
+QueueManager::QueueManager(DownloadList* downloadList)
+  : m_slotState(&state_of)
+  , m_slotTracker(&tracker_of)
+  , m_slotResume([downloadList](Download* d) { downloadList->resume(d); })
+  , m_slotPause([downloadList](Download* d) { downloadList->pause(d); }) {}
+
+const char*
+QueueManager::reason_name(reason_type reason) {
+  switch (reason) {
+    case reason_active:
+      return "active";
+    case reason_not_queued:
+      return "not_queued";
+    case reason_slots:
+      return "slots";
+    case reason_slots_downloading:
+      return "slots_downloading";
+    case reason_slots_seeding:
+      return "slots_seeding";
+    case reason_slots_tracker:
+      return "slots_tracker";
+    case reason_queued:
+    default:
+      return "queued";
+  }
+}
+
+void
+QueueManager::set_max_active(int64_t v) {
+  m_maxActive = v;
+  update();
+}
+
+void
+QueueManager::set_max_downloading(int64_t v) {
+  m_maxDownloading = v;
+  update();
+}
+
+void
+QueueManager::set_max_seeding(int64_t v) {
+  m_maxSeeding = v;
+  update();
+}
+
+void
+QueueManager::set_max_per_tracker(int64_t v) {
+  m_maxPerTracker = v;
+  update();
+}
+
+// Downloads waiting for their initial hash check have been resumed and
+// keep their slot until the check is done, as the simple scheduler
+// counted them through the 'active' view.
+QueueManager::state_type
+QueueManager::state_of(Download* download) {
+  bool holdsSlot =
+    download->is_active() ||
+    (!download->is_hash_checked() && !download->is_hash_failed() &&
+     download->resume_flags() != ~uint32_t());
+
+  return state_type{ holdsSlot, download->is_done(), download->priority() };
+}
+
+std::string
+QueueManager::tracker_of(Download* download) {
+  if (download->tracker_list()->empty())
+    return std::string();
+
+  const std::string& url = download->tracker_list()->at(0)->url();
+
+  std::string::size_type first = url.find("://");
+  first                        = first == std::string::npos ? 0 : first + 3;
+
+  std::string::size_type last = url.find_first_of(":/?", first);
+
+  return url.substr(first, last == std::string::npos ? last : last - first);
+}
+
+void
+QueueManager::enqueue(Download*          download,
+                      const state_type&  state,
+                      uint64_t           sequence,
+                      const std::string& tracker) {
+  TrackerQueue* queue = state.done ? &m_queueSeeding : &m_queueDownloading;
+  queue_entry   entry{ state.priority, sequence, download };
+
+  queue->insert(tracker, entry);
+  m_queued[download] = queued_entry{ queue, entry, tracker };
+}
+
+void
+QueueManager::dequeue(Download* download) {
+  queued_map::iterator itr = m_queued.find(download);
+
+  if (itr == m_queued.end())
+    return;
+
+  itr->second.queue->erase(itr->second.tracker, itr->second.entry);
+  m_queued.erase(itr);
+}
+
+void
+QueueManager::add_active(Download*          download,
+                         bool               seeding,
+                         uint64_t           sequence,
+                         const std::string& tracker) {
+  active_entry entry{ seeding, tracker, sequence };
+
+  if (entry.seeding)
+    m_activeSeeding++;
+  else
+    m_activeDownloading++;
+
+  if (!entry.tracker.empty())
+    m_trackerActive[entry.tracker]++;
+
+  m_active[download] = entry;
+}
+
+void
+QueueManager::remove_active(active_map::iterator itr) {
+  if (itr->second.seeding)
+    m_activeSeeding--;
+  else
+    m_activeDownloading--;
+
+  if (!itr->second.tracker.empty()) {
+    tracker_map::iterator trackerItr =
+      m_trackerActive.find(itr->second.tracker);
+
+    if (--trackerItr->second == 0)
+      m_trackerActive.erase(trackerItr);
+  }
+
+  m_active.erase(itr);
+}
+
+QueueManager::reason_type
+QueueManager::blocked_by(bool seeding, const std::string& tracker) const {
+  if (is_full(m_maxActive, m_active.size()))
+    return reason_slots;
+
+  if (seeding && is_full(m_maxSeeding, m_activeSeeding))
+    return reason_slots_seeding;
+
+  if (!seeding && is_full(m_maxDownloading, m_activeDownloading))
+    return reason_slots_downloading;
+
+  if (is_tracker_full(tracker))
+    return reason_slots_tracker;
+
+  return reason_queued;
+}
+
+bool
+QueueManager::is_tracker_full(const std::string& tracker) const {
+  if (tracker.empty() || m_maxPerTracker < 0)
+    return false;
+
+  tracker_map::const_iterator itr = m_trackerActive.find(tracker);
+
+  return itr != m_trackerActive.end() && is_full(m_maxPerTracker, itr->second);
+}
+
+void
+QueueManager::insert(Download* download) {
+  if (m_active.find(download) != m_active.end() ||
+      m_queued.find(download) != m_queued.end())
+    return;
+
+  state_type  state   = m_slotState(download);
+  std::string tracker = m_slotTracker(download);
+
+  if (state.holds_slot)
+    add_active(download, state.done, ++m_sequence, tracker);
+  else
+    enqueue(download, state, ++m_sequence, tracker);
+
+  fill();
+}
+
+void
+QueueManager::erase(Download* download) {
+  active_map::iterator itr = m_active.find(download);
+
+  if (itr != m_active.end())
+    remove_active(itr);
+  else
+    dequeue(download);
+
+  fill();
+}
+
+void
+QueueManager::update() {
+  for (active_map::iterator itr = m_active.begin(); itr != m_active.end();) {
+    Download*  download = itr->first;
+    state_type state    = m_slotState(download);
+
+    if (!state.holds_slot) {
+      uint64_t    sequence = itr->second.sequence;
+      std::string tracker  = itr->second.tracker;
+
+      remove_active(itr++);
+      enqueue(download, state, sequence, tracker);
+
+    } else if (itr->second.seeding != state.done) {
+      // Finished downloads move over to the seeding slots.
+      if (itr->second.seeding) {
+        m_activeSeeding--;
+        m_activeDownloading++;
+      } else {
+        m_activeDownloading--;
+        m_activeSeeding++;
+      }
+
+      itr->second.seeding = !itr->second.seeding;
+      itr++;
+
+    } else {
+      itr++;
+    }
+  }
+
+  for (queued_map::iterator itr = m_queued.begin(); itr != m_queued.end();) {
+    Download*     download = itr->first;
+    queued_entry& queued   = itr->second;
+    state_type    state    = m_slotState(download);
+
+    if (state.holds_slot) {
+      queued.queue->erase(queued.tracker, queued.entry);
+      add_active(download, state.done, queued.entry.sequence, queued.tracker);
+
+      itr = m_queued.erase(itr);
+      continue;
+    }
+
+    // Downloads that got hash checked as complete while queued are
+    // moved to the right queue.
+    TrackerQueue* queue = state.done ? &m_queueSeeding : &m_queueDownloading;
+
+    if (queued.queue != queue) {
+      queued.queue->erase(queued.tracker, queued.entry);
+      queued.queue = queue;
+      queued.queue->insert(queued.tracker, queued.entry);
+    }
+
+    itr++;
+  }
+
+  trim();
+  fill();
+}
+
+void
+QueueManager::update_priority(Download* download) {
+  queued_map::iterator itr = m_queued.find(download);
+
+  if (itr == m_queued.end())
+    return;
+
+  state_type state = m_slotState(download);
+
+  if (itr->second.entry.priority == state.priority)
+    return;
+
+  uint64_t    sequence = itr->second.entry.sequence;
+  std::string tracker  = itr->second.tracker;
+
+  dequeue(download);
+  enqueue(download, state, sequence, tracker);
+  fill();
+}
+
+int64_t
+QueueManager::position(Download* download) const {
+  queued_map::const_iterator itr = m_queued.find(download);
+
+  if (itr == m_queued.end())
+    return -1;
+
+  return itr->second.queue->position(itr->second.entry);
+}
+
+QueueManager::reason_type
+QueueManager::reason(Download* download) const {
+  if (m_active.find(download) != m_active.end())
+    return reason_active;
+
+  queued_map::const_iterator itr = m_queued.find(download);
+
+  if (itr == m_queued.end())
+    return reason_not_queued;
+
+  return blocked_by(itr->second.queue == &m_queueSeeding,
+                    itr->second.tracker);
+}
+
+// Starts the first download in the queue not held back by its tracker
+// limit, the class limits having been checked by the caller.
+bool
+QueueManager::start_next(TrackerQueue* queue) {
+  const queue_entry* entry =
+    queue->front_available([this](const std::string& tracker) {
+      return !is_tracker_full(tracker);
+    });
+
+  if (entry == nullptr)
+    return false;
+
+  Download*   download = entry->download;
+  uint64_t    sequence = entry->sequence;
+  std::string tracker  = m_queued[download].tracker;
+
+  dequeue(download);
+  add_active(download, m_slotState(download).done, sequence, tracker);
+
+  m_started++;
+  m_slotResume(download);
+  return true;
+}
+
+void
+QueueManager::fill() {
+  while (!is_full(m_maxActive, m_active.size())) {
+    bool canDownload = !m_queueDownloading.empty() &&
+                       !is_full(m_maxDownloading, m_activeDownloading);
+    bool canSeed =
+      !m_queueSeeding.empty() && !is_full(m_maxSeeding, m_activeSeeding);
+
+    if (!canDownload && !canSeed)
+      return;
+
+    // Both queues share the same ordering, so pick whichever head
+    // comes first.
+    bool downloadFirst =
+      canDownload &&
+      (!canSeed || m_queueDownloading.front() < m_queueSeeding.front());
+
+    TrackerQueue* first =
+      downloadFirst ? &m_queueDownloading : &m_queueSeeding;
+    TrackerQueue* second =
+      downloadFirst ? &m_queueSeeding : &m_queueDownloading;
+
+    if (start_next(first))
+      continue;
+
+    if ((downloadFirst ? canSeed : canDownload) && start_next(second))
+      continue;
+
+    return;
+  }
+}
+
+// Pauses the downloads last in the queue order until the limits are
+// met.
+void
+QueueManager::trim() {
+  while (true) {
+    bool overTotal       = is_over(m_maxActive, m_active.size());
+    bool overDownloading = is_over(m_maxDownloading, m_activeDownloading);
+    bool overSeeding     = is_over(m_maxSeeding, m_activeSeeding);
+
+    if (!overTotal && !overDownloading && !overSeeding)
+      return;
+
+    active_map::iterator worst = m_active.end();
+    queue_entry          worstEntry{};
+
+    for (active_map::iterator itr = m_active.begin(); itr != m_active.end();
+         itr++) {
+      if (!overTotal && (itr->second.seeding ? !overSeeding : !overDownloading))
+        continue;
+
+      queue_entry entry{
+        m_slotState(itr->first).priority, itr->second.sequence, itr->first
+      };
+
+      if (worst == m_active.end() || worstEntry < entry) {
+        worst      = itr;
+        worstEntry = entry;
+      }
+    }
+
+    if (worst == m_active.end())
+      throw torrent::internal_error("QueueManager::trim() found no download.");
+
+    Download*   download = worst->first;
+    std::string tracker  = worst->second.tracker;
+
+    remove_active(worst);
+    enqueue(download, m_slotState(download), worstEntry.sequence, tracker);
+
+    m_paused++;
+    m_slotPause(download);
+  }
+}
+
+}
@@ -0,0 +1,309 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <memory>
+
+#include <torrent/exceptions.h>
+#include <torrent/object.h>
+#include <torrent/tracker.h>
+#include <torrent/tracker_controller.h>
+#include <torrent/tracker_list.h>
+#include <torrent/utils/log.h>
+#include <torrent/utils/timer.h>
+
+#include "rpc/parse_commands.h"
+#include "utils/bencode_decoder.h"
+
+#include "core/curl_get.h"
+#include "core/curl_stack.h"
+#include "core/download.h"
+#include "core/download_list.h"
+#include "core/scrape_batcher.h"
+
+#include "globals.h"
+
+namespace core {
+
+// Scrape responses are small, a few dozen bytes per info hash.
+static constexpr uint64_t scrape_response_max = 1 << 20;
+
+ScrapeBatcher::ScrapeBatcher(DownloadList* downloadList, CurlStack* stack)
+  : m_downloadList(downloadList)
+  , m_stack(stack)
+  , m_slotSend([this](const std::string& url, hash_list& hashes) {
+    send_request(url, hashes);
+  })
+  , m_slotScraped([this](const torrent::HashString& hash,
+                         const torrent::Object&     stats) {
+    store(hash, stats);
+  })
+  , m_slotFallback(
+      [this](const torrent::HashString& hash) { fallback(hash); }) {
+  m_taskFlush.slot() = [this] { flush(); };
+}
+
+ScrapeBatcher::~ScrapeBatcher() {
+  clear();
+}
+
+void
+ScrapeBatcher::set_batch_size(uint32_t v) {
+  if (v == 0)
+    throw torrent::input_error("Scrape batch size must be at least one.");
+
+  m_batchSize = v;
+}
+
+uint32_t
+ScrapeBatcher::size_pending() const {
+  uint32_t result = 0;
+
+  for (const auto& entry : m_pending)
+    result += entry.second.size();
+
+  return result;
+}
+
+// Follows the BEP 48 convention; only announce urls whose last path
+// component starts with "announce" support scraping.
+std::string
+ScrapeBatcher::scrape_url(const std::string& announceUrl) {
+  std::string::size_type query = announceUrl.find('?');
+  std::string::size_type slash = announceUrl.rfind('/', query);
+
+  if (slash == std::string::npos ||
+      announceUrl.compare(slash + 1, 8, "announce") != 0)
+    return std::string();
+
+  return announceUrl.substr(0, slash + 1) + "scrape" +
+         announceUrl.substr(slash + 9);
+}
+
+torrent::Tracker*
+ScrapeBatcher::primary_tracker(Download* download) {
+  for (const auto& tracker : *download->tracker_list())
+    if (tracker->is_usable())
+      return tracker;
+
+  return nullptr;
+}
+
+void
+ScrapeBatcher::insert(Download* download) {
+  torrent::Tracker* tracker = primary_tracker(download);
+
+  if (tracker == nullptr)
+    return;
+
+  std::string url;
+
+  if (tracker->type() == torrent::Tracker::TRACKER_HTTP &&
+      tracker->can_scrape())
+    url = scrape_url(tracker->url());
+
+  insert(url, download->info()->hash());
+}
+
+void
+ScrapeBatcher::insert(const std::string& url, const torrent::HashString& hash) {
+  if (url.empty()) {
+    m_fallbacks++;
+    m_slotFallback(hash);
+    return;
+  }
+
+  hash_list& hashes = m_pending[url];
+
+  for (const auto& queued : hashes)
+    if (queued == hash)
+      return;
+
+  hashes.push_back(hash);
+
+  if (hashes.size() >= m_batchSize) {
+    send(url, hashes);
+    m_pending.erase(url);
+    return;
+  }
+
+  if (!m_taskFlush.is_queued())
+    priority_queue_insert(
+      &taskScheduler,
+      &m_taskFlush,
+      (cachedTime + torrent::utils::timer::from_seconds(m_delay))
+        .round_seconds());
+}
+
+void
+ScrapeBatcher::flush() {
+  priority_queue_erase(&taskScheduler, &m_taskFlush);
+
+  pending_map pending;
+  pending.swap(m_pending);
+
+  for (auto& entry : pending)
+    send(entry.first, entry.second);
+}
+
+void
+ScrapeBatcher::clear() {
+  priority_queue_erase(&taskScheduler, &m_taskFlush);
+
+  m_pending.clear();
+
+  for (auto& request : m_active) {
+    request.get->close();
+    delete request.get;
+  }
+
+  m_active.clear();
+}
+
+std::string
+ScrapeBatcher::request_url(const std::string& url, const hash_list& hashes) {
+  std::string target    = url;
+  char        separator = url.find('?') == std::string::npos ? '?' : '&';
+
+  for (const auto& hash : hashes) {
+    target += separator;
+    target += "info_hash=";
+
+    for (auto c : hash) {
+      static const char hex[] = "0123456789ABCDEF";
+
+      target += '%';
+      target += hex[(unsigned char)c >> 4];
+      target += hex[(unsigned char)c & 0xf];
+    }
+
+    separator = '&';
+  }
+
+  return target;
+}
+
+void
+ScrapeBatcher::send(const std::string& url, hash_list& hashes) {
+  m_requests++;
+  m_slotSend(url, hashes);
+}
+
+void
+ScrapeBatcher::send_request(const std::string& url, hash_list& hashes) {
+  auto itr = m_active.insert(m_active.end(), request_type());
+  itr->get = m_stack->new_object(CurlGet::class_scrape);
+  itr->hashes.swap(hashes);
+
+  itr->get->set_url(request_url(url, itr->hashes));
+  itr->get->set_timeout(2 * 60);
+  itr->get->set_write_slot([itr](const char* data, size_t length) {
+    if (itr->data.size() + length > scrape_response_max)
+      return false;
+
+    itr->data.append(data, length);
+    return true;
+  });
+
+  itr->get->signal_done().push_back([this, itr] { receive_done(itr); });
+  itr->get->signal_failed().push_back(
+    [this, itr](const auto& msg) { receive_failed(itr, msg); });
+
+  itr->get->start();
+}
+
+void
+ScrapeBatcher::receive(const hash_list& hashes, const std::string& data) {
+  utils::BencodeDecoder decoder(scrape_response_max);
+
+  if (!decoder.write(data.c_str(), data.size()) || !decoder.is_done())
+    return receive_failed(hashes, "Could not parse scrape response.");
+
+  std::unique_ptr<torrent::Object> response(decoder.release());
+
+  // Trackers rejecting the request answer with a "failure reason"
+  // instead.
+  if (!response->is_map() || !response->has_key_map("files"))
+    return receive_failed(hashes, "Scrape response has no files.");
+
+  const torrent::Object& files = response->get_key("files");
+
+  for (const auto& hash : hashes) {
+    std::string key(hash.begin(), hash.end());
+
+    if (!files.has_key_map(key)) {
+      m_fallbacks++;
+      m_slotFallback(hash);
+      continue;
+    }
+
+    m_scraped++;
+    m_slotScraped(hash, files.get_key(key));
+  }
+}
+
+void
+ScrapeBatcher::receive_failed(const hash_list& hashes, const std::string& msg) {
+  lt_log_print(torrent::LOG_TRACKER_INFO,
+               "Batched scrape of %zu downloads failed: %s",
+               hashes.size(),
+               msg.c_str());
+
+  m_fallbacks += hashes.size();
+
+  for (const auto& hash : hashes)
+    m_slotFallback(hash);
+}
+
+void
+ScrapeBatcher::receive_done(request_list::iterator itr) {
+  receive(itr->hashes, itr->data);
+  finish(itr);
+}
+
+void
+ScrapeBatcher::receive_failed(request_list::iterator itr,
+                              const std::string&     msg) {
+  receive_failed(itr->hashes, msg);
+  finish(itr);
+}
+
+void
+ScrapeBatcher::finish(request_list::iterator itr) {
+  // The request is deleted from within its own signal, the same way
+  // HttpQueue handles it.
+  delete itr->get;
+  m_active.erase(itr);
+}
+
+void
+ScrapeBatcher::store(const torrent::HashString& hash,
+                     const torrent::Object&     stats) {
+  DownloadList::iterator download = m_downloadList->find(hash);
+
+  if (download == m_downloadList->end())
+    return;
+
+  rpc::target_type target = rpc::make_target(*download);
+
+  for (const char* name : { "complete", "incomplete", "downloaded" })
+    if (stats.has_key_value(name))
+      rpc::call_command_set_value(
+        (std::string("d.tracker.scrape_") + name + ".set").c_str(),
+        stats.get_key_value(name),
+        target);
+
+  rpc::call_command_set_value(
+    "d.tracker.scrape_time_last.set", cachedTime.seconds(), target);
+}
+
+void
+ScrapeBatcher::fallback(const torrent::HashString& hash) {
+  DownloadList::iterator download = m_downloadList->find(hash);
+
+  if (download == m_downloadList->end())
+    return;
+
+  (*download)->tracker_controller()->scrape_request(fallback_delay);
+}
+
+}
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <cctype>
+
+#include <torrent/data/file.h>
+#include <torrent/data/file_list.h>
+
+#include "core/download.h"
+#include "core/search_index.h"
+
+namespace core {
+
+void
+SearchIndex::assign(download_list* downloads, id_type id, Download* download) {
+  if (id >= downloads->size())
+    downloads->resize(id + 1, nullptr);
+
+  (*downloads)[id] = download;
+}
+
+SearchIndex::download_list
+SearchIndex::to_downloads(const std::vector<id_type>& ids,
+                          const download_list&        downloads) {
+  download_list result;
+  result.reserve(ids.size());
+
+  for (id_type id : ids)
+    result.push_back(downloads[id]);
+
+  return result;
+}
+
+void
+SearchIndex::insert(Download* download) {
+  if (m_entries.find(download) != m_entries.end())
+    return;
+
+  utils::TrigramIndex::text_list paths;
+
+  for (const auto& file : *download->file_list())
+    paths.push_back(file->path()->as_string());
+
+  insert(download, download->info()->name(), paths);
+}
+
+void
+SearchIndex::insert(Download*                             download,
+                    const std::string&                    name,
+                    const utils::TrigramIndex::text_list& paths) {
+  if (m_entries.find(download) != m_entries.end())
+    return;
+
+  entry_type entry;
+  entry.name  = m_names.insert({ name });
+  entry.files = m_files.insert(paths);
+
+  assign(&m_nameDownloads, entry.name, download);
+  assign(&m_fileDownloads, entry.files, download);
+
+  m_entries.emplace(download, entry);
+  m_cacheValid = false;
+}
+
+void
+SearchIndex::erase(Download* download) {
+  auto itr = m_entries.find(download);
+
+  if (itr == m_entries.end())
+    return;
+
+  m_names.erase(itr->second.name);
+  m_files.erase(itr->second.files);
+
+  m_nameDownloads[itr->second.name]  = nullptr;
+  m_fileDownloads[itr->second.files] = nullptr;
+
+  m_entries.erase(itr);
+  m_cacheValid = false;
+}
+
+SearchIndex::download_list
+SearchIndex::search_names(const std::string& query) const {
+  return to_downloads(m_names.search(query), m_nameDownloads);
+}
+
+SearchIndex::download_list
+SearchIndex::search_files(const std::string& query) const {
+  return to_downloads(m_files.search(query), m_fileDownloads);
+}
+
+bool
+SearchIndex::name_contains(Download* download, const std::string& query) {
+  if (!m_cacheValid || query != m_cacheQuery) {
+    download_list result = search_names(query);
+
+    m_cacheResult.clear();
+    m_cacheResult.insert(result.begin(), result.end());
+
+    m_cacheQuery = query;
+    m_cacheValid = true;
+    m_cacheMisses++;
+  }
+
+  return m_cacheResult.find(download) != m_cacheResult.end();
+}
+
+bool
+SearchIndex::is_plain(const std::string& pattern) {
+  return pattern.find_first_of("\\^$.|?*+()[]{}\",;") == std::string::npos;
+}
+
+std::string
+SearchIndex::filter_command(const std::string& pattern) {
+  if (is_plain(pattern))
+    return "d.search.name=\"" + pattern + "\"";
+
+  std::string regex = pattern;
+
+  if (regex.back() != '$')
+    regex = regex + ".*";
+  if (regex.front() != '^')
+    regex = ".*" + regex;
+
+  std::transform(regex.begin(), regex.end(), regex.begin(), ::tolower);
+
+  return "match={d.name=," + regex + "}";
+}
+
+}
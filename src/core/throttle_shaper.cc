@@ -0,0 +1,539 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <ctime>
+
+#include <torrent/exceptions.h>
+#include <torrent/rate.h>
+#include <torrent/throttle.h>
+#include <torrent/utils/timer.h>
+
+#include "rpc/parse_commands.h"
+
+#include "core/throttle_shaper.h"
+
+#include "globals.h"
+
+namespace core {
+
+// Idle leaves get their rate plus some headroom to grow into.
+static constexpr uint64_t demand_headroom = 16 << 10;
+
+// Throttles with a max rate of zero are unthrottled, so starved leaves
+// are kept at a trickle instead.
+static constexpr uint64_t rate_floor = 1 << 10;
+
+static uint64_t
+saturating_add(uint64_t a, uint64_t b) {
+  return a > ThrottleShaper::unlimited - b ? ThrottleShaper::unlimited : a + b;
+}
+
+ThrottleShaper::ThrottleShaper(throttle_map* throttles)
+  : m_throttles(throttles) {
+  m_root.name = "global";
+  m_taskUpdate.slot() = [this] { update(); };
+}
+
+ThrottleShaper::~ThrottleShaper() {
+  priority_queue_erase(&taskScheduler, &m_taskUpdate);
+}
+
+ThrottleShaper::class_type*
+ThrottleShaper::find(const std::string& name) {
+  if (name.empty() || name == m_root.name)
+    return &m_root;
+
+  class_map::iterator itr = m_classes.find(name);
+
+  return itr != m_classes.end() ? itr->second.get() : nullptr;
+}
+
+std::vector<std::string>
+ThrottleShaper::names() const {
+  std::vector<std::string> result;
+
+  for (const auto& entry : m_classes)
+    result.push_back(entry.first);
+
+  return result;
+}
+
+ThrottleShaper::class_type*
+ThrottleShaper::insert(const std::string& name, const std::string& parent) {
+  if (name.empty() || name == "NULL" || name == m_root.name)
+    throw torrent::input_error("Invalid throttle class name '" + name + "'.");
+
+  class_type* parentNode = find(parent);
+
+  if (parentNode == nullptr)
+    throw torrent::input_error("Throttle class '" + parent + "' not found.");
+
+  std::unique_ptr<class_type>& entry = m_classes[name];
+
+  if (entry == nullptr) {
+    entry.reset(new class_type);
+    entry->name = name;
+
+  } else {
+    for (class_type* node = parentNode; node != nullptr; node = node->parent)
+      if (node == entry.get())
+        throw torrent::input_error("Throttle class '" + name +
+                                   "' cannot be moved below itself.");
+
+    std::vector<class_type*>& siblings = entry->parent->children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), entry.get()));
+  }
+
+  entry->parent = parentNode;
+  parentNode->children.push_back(entry.get());
+
+  torrent::ThrottlePair& throttles = (*m_throttles)[name];
+
+  if (throttles.first == nullptr)
+    throttles.first = torrent::up_throttle_global()->create_slave();
+
+  if (throttles.second == nullptr)
+    throttles.second = torrent::down_throttle_global()->create_slave();
+
+  schedule();
+  return entry.get();
+}
+
+ThrottleShaper::shape_type*
+ThrottleShaper::find_shape(const std::string& name,
+                           const std::string& option,
+                           std::string*       field) {
+  class_type* node = find(name);
+
+  if (node == nullptr)
+    throw torrent::input_error("Throttle class '" + name + "' not found.");
+
+  if (option.compare(0, 3, "up.") == 0) {
+    *field = option.substr(3);
+    return &node->shape[direction_up];
+  }
+
+  if (option.compare(0, 5, "down.") == 0) {
+    *field = option.substr(5);
+    return &node->shape[direction_down];
+  }
+
+  *field = option;
+  return nullptr;
+}
+
+void
+ThrottleShaper::set_option(const std::string& name,
+                           const std::string& option,
+                           uint64_t           value) {
+  std::string field;
+  shape_type* shape = find_shape(name, option, &field);
+
+  if (shape == nullptr && field == "weight") {
+    if (value == 0)
+      throw torrent::input_error("Throttle class weight must be positive.");
+
+    find(name)->weight = value;
+
+  } else if (shape != nullptr && field == "min") {
+    shape->min = value;
+  } else if (shape != nullptr && field == "max") {
+    shape->max = value != 0 ? value : unlimited;
+  } else if (shape != nullptr && field == "burst") {
+    shape->burst  = value;
+    shape->tokens = std::min(shape->tokens, value);
+  } else {
+    throw torrent::input_error("Invalid throttle class option '" + option +
+                               "'.");
+  }
+}
+
+int64_t
+ThrottleShaper::option(const std::string& name, const std::string& option) {
+  std::string field;
+  shape_type* shape = find_shape(name, option, &field);
+
+  if (shape == nullptr && field == "weight")
+    return find(name)->weight;
+
+  if (shape == nullptr)
+    throw torrent::input_error("Invalid throttle class option '" + option +
+                               "'.");
+
+  // Unlimited rates are reported as zero, the same as throttles.
+  uint64_t value;
+
+  if (field == "min")
+    value = shape->min;
+  else if (field == "max")
+    value = shape->max;
+  else if (field == "burst")
+    value = shape->burst;
+  else if (field == "rate")
+    value = shape->rate;
+  else if (field == "allotted")
+    value = shape->allotted;
+  else if (field == "tokens")
+    value = shape->tokens;
+  else
+    throw torrent::input_error("Invalid throttle class option '" + option +
+                               "'.");
+
+  return value != unlimited ? value : 0;
+}
+
+void
+ThrottleShaper::insert_profile(const std::string& name,
+                               direction_type     direction,
+                               uint32_t           start,
+                               uint64_t           rate) {
+  class_type* node = find(name);
+
+  if (node == nullptr)
+    throw torrent::input_error("Throttle class '" + name + "' not found.");
+
+  if (start >= 24 * 3600)
+    throw torrent::input_error("Profile start must be within a day.");
+
+  std::vector<profile_entry>& profile = node->shape[direction].profile;
+
+  auto itr = std::lower_bound(
+    profile.begin(), profile.end(), start, [](const auto& entry, uint32_t t) {
+      return entry.start < t;
+    });
+
+  if (itr != profile.end() && itr->start == start)
+    itr->rate = rate != 0 ? rate : unlimited;
+  else
+    profile.insert(itr, profile_entry{ start, rate != 0 ? rate : unlimited });
+
+  if (node == &m_root)
+    m_globalEntry[direction] = entry_none;
+
+  schedule();
+}
+
+void
+ThrottleShaper::clear_profile(const std::string& name) {
+  class_type* node = find(name);
+
+  if (node == nullptr)
+    throw torrent::input_error("Throttle class '" + name + "' not found.");
+
+  for (int direction = 0; direction != direction_size; direction++) {
+    node->shape[direction].profile.clear();
+
+    if (node == &m_root)
+      m_globalEntry[direction] = entry_none;
+  }
+}
+
+const ThrottleShaper::profile_entry*
+ThrottleShaper::active_profile(const shape_type& shape, uint32_t now) {
+  if (shape.profile.empty())
+    return nullptr;
+
+  auto itr = std::upper_bound(
+    shape.profile.begin(),
+    shape.profile.end(),
+    now,
+    [](uint32_t t, const auto& entry) { return t < entry.start; });
+
+  return itr != shape.profile.begin() ? &*--itr : &shape.profile.back();
+}
+
+uint64_t
+ThrottleShaper::ceiling(const shape_type& shape, uint32_t now) {
+  const profile_entry* entry = active_profile(shape, now);
+
+  return entry != nullptr ? entry->rate : shape.max;
+}
+
+torrent::Throttle*
+ThrottleShaper::throttle(class_type* node, direction_type direction) {
+  throttle_map::iterator itr = m_throttles->find(node->name);
+
+  if (itr == m_throttles->end())
+    return nullptr;
+
+  return direction == direction_up ? itr->second.first : itr->second.second;
+}
+
+void
+ThrottleShaper::update() {
+  std::time_t t = cachedTime.seconds();
+  std::tm     local;
+
+  if (localtime_r(&t, &local) == nullptr)
+    throw torrent::internal_error(
+      "ThrottleShaper::update() could not convert to local time.");
+
+  uint32_t now = 3600 * local.tm_hour + 60 * local.tm_min + local.tm_sec;
+
+  for (int i = 0; i != direction_size; i++) {
+    direction_type     direction = (direction_type)i;
+    torrent::Throttle* global    = direction == direction_up
+                                     ? torrent::up_throttle_global()
+                                     : torrent::down_throttle_global();
+
+    update_profile_global(direction, now);
+    update_demand(&m_root, direction, now);
+
+    // Named throttles only take effect while the global throttle is
+    // enabled, so without it the classes are held at their ceiling.
+    update_allotment(&m_root,
+                     direction,
+                     global->is_throttled() ? global->max_rate() : unlimited,
+                     now);
+  }
+
+  schedule();
+}
+
+void
+ThrottleShaper::update_profile_global(direction_type direction, uint32_t now) {
+  const shape_type&    shape = m_root.shape[direction];
+  const profile_entry* entry = active_profile(shape, now);
+
+  if (entry == nullptr)
+    return;
+
+  size_t index = entry - shape.profile.data();
+
+  if (index == m_globalEntry[direction])
+    return;
+
+  m_globalEntry[direction] = index;
+
+  rpc::call_command_set_value(direction == direction_up
+                                ? "throttle.global_up.max_rate.set"
+                                : "throttle.global_down.max_rate.set",
+                              entry->rate != unlimited ? entry->rate : 0);
+}
+
+// Demand is estimated from the measured rate; classes using most of
+// their allotment want as much as they can get, the others only a bit
+// more than they currently use.
+uint64_t
+ThrottleShaper::estimate_demand(const shape_type& shape, uint64_t limit) {
+  if (saturating_add(shape.rate, shape.rate / 8) >= shape.allotted)
+    return limit;
+
+  return std::min(limit, shape.rate + shape.rate / 4 + demand_headroom);
+}
+
+void
+ThrottleShaper::update_demand(class_type*    node,
+                              direction_type direction,
+                              uint32_t       now) {
+  shape_type&        shape = node->shape[direction];
+  uint64_t           limit = ceiling(shape, now);
+  torrent::Throttle* t     = throttle(node, direction);
+
+  if (node->children.empty()) {
+    shape.rate   = t != nullptr ? t->rate()->rate() : 0;
+    shape.demand = estimate_demand(shape, limit);
+    return;
+  }
+
+  // Interior classes without downloads of their own don't hold back
+  // any of the capacity from their children.
+  shape_type& own = node->own[direction];
+
+  own.rate   = t != nullptr ? t->rate()->rate() : 0;
+  own.demand = own.rate != 0 ? estimate_demand(own, limit) : 0;
+
+  shape.rate   = own.rate;
+  shape.demand = own.demand;
+
+  for (class_type* child : node->children) {
+    update_demand(child, direction, now);
+
+    shape.rate   = saturating_add(shape.rate, child->shape[direction].rate);
+    shape.demand = saturating_add(shape.demand, child->shape[direction].demand);
+  }
+
+  shape.demand = std::min(limit, shape.demand);
+}
+
+// Hands out the remaining capacity by weight until every share reaches
+// its target, returning what is left.
+template<typename Target>
+static uint64_t
+distribute(const std::vector<ThrottleShaper::share_type>& shares,
+           std::vector<uint64_t>&                         allotted,
+           uint64_t                                       capacity,
+           Target                                         target) {
+  while (capacity != 0) {
+    uint64_t totalWeight = 0;
+
+    for (size_t i = 0; i != shares.size(); i++)
+      if (allotted[i] < target(i))
+        totalWeight += shares[i].weight;
+
+    if (totalWeight == 0)
+      break;
+
+    uint64_t used   = 0;
+    bool     capped = false;
+
+    for (size_t i = 0; i != shares.size(); i++) {
+      if (allotted[i] >= target(i))
+        continue;
+
+      uint64_t share = capacity;
+
+      if (capacity != ThrottleShaper::unlimited)
+        share = std::max<uint64_t>(
+          1, (double)capacity * shares[i].weight / totalWeight);
+
+      uint64_t room = target(i) - allotted[i];
+
+      if (share >= room) {
+        share  = room;
+        capped = true;
+      }
+
+      allotted[i] = saturating_add(allotted[i], share);
+      used        = saturating_add(used, share);
+    }
+
+    if (capacity == ThrottleShaper::unlimited)
+      break;
+
+    capacity -= std::min(used, capacity);
+
+    // Without anyone reaching their target the whole capacity was
+    // used, otherwise go around again with the leftovers.
+    if (!capped)
+      break;
+  }
+
+  return capacity;
+}
+
+uint64_t
+ThrottleShaper::split(uint64_t                       capacity,
+                      const std::vector<share_type>& shares,
+                      std::vector<uint64_t>*         allotted) {
+  uint64_t guaranteed = 0;
+
+  allotted->assign(shares.size(), 0);
+
+  for (size_t i = 0; i != shares.size(); i++) {
+    (*allotted)[i] =
+      std::min({ shares[i].min, shares[i].demand, shares[i].ceiling });
+    guaranteed     = saturating_add(guaranteed, (*allotted)[i]);
+  }
+
+  // Guarantees exceeding the capacity are scaled down evenly.
+  if (guaranteed > capacity) {
+    for (auto& rate : *allotted)
+      rate = (uint64_t)((double)rate * capacity / guaranteed);
+
+    guaranteed = capacity;
+  }
+
+  if (capacity != unlimited)
+    capacity -= guaranteed;
+
+  capacity = distribute(shares, *allotted, capacity, [&](size_t i) {
+    return std::min(shares[i].demand, shares[i].ceiling);
+  });
+
+  return distribute(shares, *allotted, capacity, [&](size_t i) {
+    return shares[i].ceiling;
+  });
+}
+
+void
+ThrottleShaper::update_allotment(class_type*    node,
+                                 direction_type direction,
+                                 uint64_t       capacity,
+                                 uint32_t       now) {
+  shape_type& shape = node->shape[direction];
+
+  shape.allotted =
+    node == &m_root ? capacity : std::min(capacity, ceiling(shape, now));
+
+  if (node->children.empty()) {
+    update_throttle(node, direction);
+    return;
+  }
+
+  std::vector<share_type> shares;
+  std::vector<uint64_t>   allotted;
+
+  for (class_type* child : node->children) {
+    const shape_type& childShape = child->shape[direction];
+
+    shares.push_back(share_type{ child->weight,
+                                 childShape.min,
+                                 childShape.demand,
+                                 ceiling(childShape, now) });
+  }
+
+  // The class's own downloads last, getting what is left over.
+  shape_type& own = node->own[direction];
+
+  shares.push_back(share_type{ 1, 0, own.demand, own.demand });
+
+  uint64_t remaining = split(shape.allotted, shares, &allotted);
+
+  own.allotted = saturating_add(allotted.back(), remaining);
+  update_own_throttle(node, direction);
+
+  for (size_t i = 0; i != node->children.size(); i++)
+    update_allotment(node->children[i], direction, allotted[i], now);
+}
+
+void
+ThrottleShaper::update_throttle(class_type* node, direction_type direction) {
+  shape_type&        shape = node->shape[direction];
+  torrent::Throttle* t     = throttle(node, direction);
+
+  if (shape.allotted == unlimited) {
+    shape.tokens = 0;
+
+    if (t != nullptr)
+      t->set_max_rate(0);
+
+    return;
+  }
+
+  if (shape.rate < shape.allotted)
+    shape.tokens = std::min(
+      shape.burst, saturating_add(shape.tokens, shape.allotted - shape.rate));
+  else
+    shape.tokens -= std::min(shape.tokens, shape.rate - shape.allotted);
+
+  if (t != nullptr)
+    t->set_max_rate(
+      std::max(rate_floor, saturating_add(shape.allotted, shape.tokens)));
+}
+
+void
+ThrottleShaper::update_own_throttle(class_type*    node,
+                                    direction_type direction) {
+  const shape_type&  own = node->own[direction];
+  torrent::Throttle* t   = throttle(node, direction);
+
+  if (t != nullptr)
+    t->set_max_rate(own.allotted != unlimited
+                      ? std::max(rate_floor, own.allotted)
+                      : 0);
+}
+
+void
+ThrottleShaper::schedule() {
+  if (m_taskUpdate.is_queued())
+    return;
+
+  priority_queue_insert(&taskScheduler,
+                        &m_taskUpdate,
+                        (cachedTime + torrent::utils::timer::from_seconds(1))
+                          .round_seconds());
+}
+
+}
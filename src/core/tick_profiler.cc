@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <cstdlib>
+#include <cxxabi.h>
+
+#include <torrent/utils/log.h>
+#include <torrent/utils/timer.h>
+
+#include "core/tick_profiler.h"
+#include "utils/trace_ring.h"
+
+namespace core {
+
+std::string
+TickProfiler::task_name(const std::type_info& type) {
+  int   status    = 0;
+  char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+  if (demangled == nullptr)
+    return type.name();
+
+  std::string result(demangled);
+  std::free(demangled);
+
+  return result;
+}
+
+TickProfiler::task_stats&
+TickProfiler::stats_for(const std::type_info& type) {
+  auto itr = m_tasks.find(&type);
+
+  if (itr == m_tasks.end())
+    itr = m_tasks.emplace(&type, task_stats{ task_name(type), {} }).first;
+
+  return itr->second;
+}
+
+void
+TickProfiler::tick_begin() {
+  m_tickStart   = torrent::utils::timer::current_usec();
+  m_longestTask = nullptr;
+  m_longestUsec = 0;
+
+  if (m_pollStart == 0)
+    return;
+
+  uint64_t polled = m_tickStart - m_pollStart;
+  m_poll.insert(polled);
+
+  // Sleeping up to the timeout is expected, anything beyond that was
+  // spent handling socket events with the global lock held.
+  if (polled > m_pollTimeout + m_stallThreshold) {
+    utils::trace(utils::TRACE_STALL, polled - m_pollTimeout, 0);
+
+    lt_log_print(torrent::LOG_WARN,
+                 "Main loop stalled for %" PRIu64
+                 " ms handling socket events.",
+                 (polled - m_pollTimeout) / 1000);
+  }
+}
+
+void
+TickProfiler::tick_end(uint64_t timeout) {
+  m_pollStart   = torrent::utils::timer::current_usec();
+  m_pollTimeout = timeout;
+
+  if (m_tickStart == 0)
+    return;
+
+  uint64_t worked = m_pollStart - m_tickStart;
+  m_work.insert(worked);
+
+  if (worked <= m_stallThreshold)
+    return;
+
+  utils::trace(utils::TRACE_STALL, worked, m_longestUsec);
+
+  if (m_longestTask == nullptr) {
+    lt_log_print(torrent::LOG_WARN,
+                 "Main loop stalled for %" PRIu64 " ms.",
+                 worked / 1000);
+    return;
+  }
+
+  lt_log_print(torrent::LOG_WARN,
+               "Main loop stalled for %" PRIu64
+               " ms, task '%s' took %" PRIu64 " ms.",
+               worked / 1000,
+               m_longestTask->name.c_str(),
+               m_longestUsec / 1000);
+}
+
+void
+TickProfiler::perform(torrent::utils::priority_queue_default* queue,
+                      torrent::utils::timer                   time) {
+  while (!queue->empty() && queue->top()->time() <= time) {
+    torrent::utils::priority_item* item = queue->top();
+    queue->pop();
+    item->clear_time();
+
+    // The task may erase or free its item, so look up its type first.
+    task_stats& stats = stats_for(item->slot().target_type());
+    uint64_t    start = torrent::utils::timer::current_usec();
+
+    item->slot()();
+
+    uint64_t elapsed = torrent::utils::timer::current_usec() - start;
+    stats.histogram.insert(elapsed);
+
+    if (elapsed > m_longestUsec) {
+      m_longestTask = &stats;
+      m_longestUsec = elapsed;
+    }
+  }
+}
+
+void
+TickProfiler::reset() {
+  for (auto& entry : m_tasks)
+    entry.second.histogram.clear();
+
+  m_work.clear();
+  m_poll.clear();
+}
+
+torrent::Object
+TickProfiler::tasks_object() const {
+  torrent::Object result = torrent::Object::create_map();
+
+  for (const auto& entry : m_tasks)
+    if (entry.second.histogram.count() != 0)
+      result.insert_key(entry.second.name, entry.second.histogram.to_object());
+
+  return result;
+}
+
+torrent::Object
+TickProfiler::ticks_object() const {
+  torrent::Object result = torrent::Object::create_map();
+
+  result.insert_key("work", m_work.to_object());
+  result.insert_key("poll", m_poll.to_object());
+
+  return result;
+}
+
+}
@@ -11,6 +11,7 @@
 #include "core/download_list.h"
 #include "core/manager.h"
 #include "core/view.h"
+#include "core/view_manager.h"
 #include "rpc/object_storage.h"
 #include "rpc/parse_commands.h"
 
@@ -128,10 +129,11 @@ struct view_downloads_filter {
   const torrent::Object& m_command2;
 };
 
+// The signal is emitted by the view manager along with those of other
+// views changed in the same main loop iteration.
 void
 View::emit_changed() {
-  priority_queue_erase(&taskScheduler, &m_delayChanged);
-  priority_queue_insert(&taskScheduler, &m_delayChanged, cachedTime);
+  control->view_manager()->mark_changed(this);
 }
 
 void
@@ -144,11 +146,12 @@ View::emit_changed_now() {
 }
 
 View::~View() {
+  control->view_manager()->unmark_changed(this);
+
   if (m_name.empty())
     return;
 
   clear_filter_on();
-  priority_queue_erase(&taskScheduler, &m_delayChanged);
 }
 
 void
@@ -174,7 +177,6 @@ View::initialize(const std::string& name) {
   m_focus = 0;
 
   set_last_changed(torrent::utils::timer());
-  m_delayChanged.slot() = [this] { emit_changed_now(); };
 }
 
 void
@@ -17,6 +17,46 @@
 
 namespace core {
 
+ViewManager::ViewManager() {
+  m_taskChanged.slot() = [this] { receive_changed(); };
+}
+
+ViewManager::~ViewManager() {
+  priority_queue_erase(&taskScheduler, &m_taskChanged);
+  m_changed.clear();
+
+  clear();
+}
+
+void
+ViewManager::mark_changed(View* view) {
+  if (std::find(m_changed.begin(), m_changed.end(), view) != m_changed.end())
+    return;
+
+  m_changed.push_back(view);
+
+  if (!m_taskChanged.is_queued())
+    priority_queue_insert(&taskScheduler, &m_taskChanged, cachedTime);
+}
+
+void
+ViewManager::unmark_changed(View* view) {
+  auto itr = std::find(m_changed.begin(), m_changed.end(), view);
+
+  if (itr != m_changed.end())
+    m_changed.erase(itr);
+}
+
+void
+ViewManager::receive_changed() {
+  // Views changed by the slots are queued for the next iteration.
+  std::vector<View*> changed;
+  changed.swap(m_changed);
+
+  for (const auto& view : changed)
+    view->emit_changed_now();
+}
+
 void
 ViewManager::clear() {
   for (const auto& view : *this) {
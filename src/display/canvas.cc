@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
 
+#include <algorithm>
 #include <iostream>
 #include <sys/ioctl.h>
 #include <termios.h>
@@ -14,8 +15,9 @@
 
 namespace display {
 
-bool Canvas::m_isInitialized = false;
-bool hasBeenInitialized      = false;
+bool    Canvas::m_isInitialized = false;
+SCREEN* Canvas::m_screen        = nullptr;
+bool    hasBeenInitialized      = false;
 
 Canvas::Canvas(int x, int y, int width, int height) {
   if (!m_isInitialized) {
@@ -26,6 +28,12 @@ Canvas::Canvas(int x, int y, int width, int height) {
 
   if (m_window == nullptr)
     throw torrent::internal_error("Could not allocate ncurses canvas.");
+
+  int w;
+  int h;
+  getmaxyx(m_window, h, w);
+
+  m_grid.resize(w, h);
 }
 
 void
@@ -36,6 +44,92 @@ Canvas::resize(int x, int y, int w, int h) {
 
   wresize(m_window, h, w);
   mvwin(m_window, y, x);
+
+  m_grid.resize(w, h);
+}
+
+void
+Canvas::print(const char* str, ...) {
+  if (!m_isInitialized) {
+    return;
+  }
+
+  va_list arglist;
+  va_start(arglist, str);
+  print_format(str, arglist);
+  va_end(arglist);
+}
+
+void
+Canvas::print(unsigned int x, unsigned int y, const char* str, ...) {
+  if (!m_isInitialized) {
+    return;
+  }
+
+  m_grid.move(x, y);
+
+  va_list arglist;
+  va_start(arglist, str);
+  print_format(str, arglist);
+  va_end(arglist);
+}
+
+void
+Canvas::print_format(const char* str, va_list arglist) {
+  char    buffer[512];
+  va_list copy;
+
+  va_copy(copy, arglist);
+  int length = vsnprintf(buffer, sizeof(buffer), str, copy);
+  va_end(copy);
+
+  if (length < 0)
+    return;
+
+  if (static_cast<size_t>(length) < sizeof(buffer)) {
+    m_grid.write(buffer, buffer + length);
+    return;
+  }
+
+  std::vector<char> large(length + 1);
+  vsnprintf(large.data(), large.size(), str, arglist);
+
+  m_grid.write(large.data(), large.data() + length);
+}
+
+void
+Canvas::print_border(chtype ls,
+                     chtype rs,
+                     chtype ts,
+                     chtype bs,
+                     chtype tl,
+                     chtype tr,
+                     chtype bl,
+                     chtype br) {
+  unsigned int w = m_grid.width();
+  unsigned int h = m_grid.height();
+
+  if (!m_isInitialized || w < 2 || h < 2) {
+    return;
+  }
+
+  // Zero picks the default line drawing character, as with wborder.
+  auto pick = [](chtype c, chtype fallback) { return c != 0 ? c : fallback; };
+
+  for (unsigned int x = 1; x + 1 < w; x++) {
+    print_char(x, 0, pick(ts, ACS_HLINE));
+    print_char(x, h - 1, pick(bs, ACS_HLINE));
+  }
+
+  for (unsigned int y = 1; y + 1 < h; y++) {
+    print_char(0, y, pick(ls, ACS_VLINE));
+    print_char(w - 1, y, pick(rs, ACS_VLINE));
+  }
+
+  print_char(0, 0, pick(tl, ACS_ULCORNER));
+  print_char(w - 1, 0, pick(tr, ACS_URCORNER));
+  print_char(0, h - 1, pick(bl, ACS_LLCORNER));
+  print_char(w - 1, h - 1, pick(br, ACS_LRCORNER));
 }
 
 void
@@ -50,12 +144,11 @@ Canvas::print_attributes(unsigned int           x,
 
   move(x, y);
 
-  attr_t org_attr;
-  short  org_pair;
-  wattr_get(m_window, &org_attr, &org_pair, nullptr);
+  attr_t org_attr = m_grid.attributes();
+  short  org_pair = m_grid.color();
 
   attributes_list::const_iterator attrItr = attributes->begin();
-  wattr_set(m_window, Attributes::a_normal, Attributes::color_default, nullptr);
+  m_grid.set_attributes(Attributes::a_normal, Attributes::color_default);
 
   while (first != last) {
     const char* next = last;
@@ -64,17 +157,19 @@ Canvas::print_attributes(unsigned int           x,
       next = attrItr->position();
 
       if (first >= next) {
-        wattr_set(m_window, attrItr->attributes(), attrItr->colors(), nullptr);
+        m_grid.set_attributes(attrItr->attributes(), attrItr->colors());
         ++attrItr;
       }
     }
 
-    print("%.*s", next - first, first);
+    // Text elements truncated to fit leave a nul before 'next', and
+    // the rest of the segment isn't printed.
+    m_grid.write(first, std::find(first, next, '\0'));
     first = next;
   }
 
   // Reset the color.
-  wattr_set(m_window, org_attr, org_pair, nullptr);
+  m_grid.set_attributes(org_attr, org_pair);
 }
 
 void
@@ -104,6 +199,23 @@ Canvas::initialize() {
   }
 }
 
+void
+Canvas::initialize_headless(FILE* output, int width, int height) {
+  if (m_isInitialized) {
+    return;
+  }
+
+  m_screen = newterm("xterm", output, stdin);
+
+  if (m_screen == nullptr)
+    throw torrent::internal_error("Could not create headless ncurses screen.");
+
+  // The size can't be queried from a file, so set it explicitly.
+  resizeterm(height, width);
+  curs_set(0);
+  m_isInitialized = true;
+}
+
 void
 Canvas::cleanup() {
   if (!m_isInitialized) {
@@ -114,6 +226,11 @@ Canvas::cleanup() {
 
   noraw();
   endwin();
+
+  if (m_screen != nullptr) {
+    delscreen(m_screen);
+    m_screen = nullptr;
+  }
 }
 
 std::pair<int, int>
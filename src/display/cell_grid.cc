@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cwchar>
+
+#include "display/cell_grid.h"
+
+namespace display {
+
+static constexpr unsigned int tab_size = 8;
+
+CellGrid::cell_type
+CellGrid::blank_cell() {
+  cell_type cell;
+
+  cell.glyph[0] = ' ';
+  cell.length   = 1;
+  cell.attr     = A_NORMAL;
+  cell.color    = 0;
+
+  return cell;
+}
+
+void
+CellGrid::resize(unsigned int width, unsigned int height) {
+  std::vector<cell_type> cells(width * height, blank_cell());
+
+  for (unsigned int y = 0; y < std::min(height, m_height); y++)
+    std::copy(row(y),
+              row(y) + std::min(width, m_width),
+              cells.begin() + y * width);
+
+  // A double width character cut in half by the new right edge.
+  if (width != 0 && width < m_width)
+    for (unsigned int y = 0; y < std::min(height, m_height); y++)
+      if (cell(width, y).length == 0)
+        cells[y * width + width - 1] = blank_cell();
+
+  m_cells.swap(cells);
+  m_width  = width;
+  m_height = height;
+
+  m_x = std::min(m_x, width != 0 ? width - 1 : 0);
+  m_y = std::min(m_y, height != 0 ? height - 1 : 0);
+
+  invalidate();
+}
+
+void
+CellGrid::invalidate() {
+  // No real cell has this length, so every cell differs.
+  cell_type invalid = blank_cell();
+  invalid.length    = UINT8_MAX;
+
+  m_front.assign(m_width * m_height, invalid);
+  m_dirty.assign(m_height, true);
+}
+
+void
+CellGrid::move(unsigned int x, unsigned int y) {
+  if (x >= m_width || y >= m_height)
+    return;
+
+  m_x = x;
+  m_y = y;
+}
+
+void
+CellGrid::write(const char* first, const char* last) {
+  std::mbstate_t state{};
+
+  while (first != last && m_y < m_height) {
+    unsigned char c = *first;
+
+    if (c == '\n') {
+      clear_to_eol();
+      newline();
+      first++;
+
+    } else if (c == '\t') {
+      for (unsigned int i = tab_size - m_x % tab_size; i != 0; i--)
+        put_glyph(" ", 1, 1);
+
+      first++;
+
+    } else if (c < 0x20 || c == 0x7f) {
+      char glyph = c == 0x7f ? '?' : c + '@';
+
+      put_glyph("^", 1, 1);
+      put_glyph(&glyph, 1, 1);
+      first++;
+
+    } else if (c < 0x80 || MB_CUR_MAX == 1) {
+      put_glyph(first, 1, 1);
+      first++;
+
+    } else {
+      wchar_t wc;
+      size_t  length = std::mbrtowc(&wc, first, last - first, &state);
+
+      if (length == 0 || length > size_t(last - first)) {
+        state = std::mbstate_t{};
+        put_glyph("?", 1, 1);
+        first++;
+        continue;
+      }
+
+      int width = ::wcwidth(wc);
+
+      if (width < 0)
+        put_glyph("?", 1, 1);
+      else if (width == 0)
+        append_combining(first, length);
+      else
+        put_glyph(first, length, width);
+
+      first += length;
+    }
+  }
+}
+
+void
+CellGrid::write_char(chtype ch) {
+  if (m_y >= m_height)
+    return;
+
+  attr_t saved_attr  = m_attr;
+  short  saved_color = m_color;
+
+  m_attr |= ch & (A_ATTRIBUTES & ~A_COLOR);
+
+  if (PAIR_NUMBER(ch & A_COLOR) != 0)
+    m_color = PAIR_NUMBER(ch & A_COLOR);
+
+  char glyph = ch & A_CHARTEXT;
+
+  if (ch & A_ALTCHARSET)
+    put_glyph(&glyph, 1, 1);
+  else
+    write(&glyph, &glyph + 1);
+
+  m_attr  = saved_attr;
+  m_color = saved_color;
+}
+
+void
+CellGrid::change_attributes(unsigned int x,
+                            unsigned int y,
+                            int          n,
+                            attr_t       attr,
+                            short        color) {
+  if (x >= m_width || y >= m_height)
+    return;
+
+  m_x = x;
+  m_y = y;
+
+  unsigned int last = n < 0 ? m_width : std::min<unsigned int>(m_width, x + n);
+
+  // Both halves of a double width character keep the same attributes.
+  if (row(y)[x].length == 0 && x != 0)
+    x--;
+
+  if (last < m_width && row(y)[last].length == 0)
+    last++;
+
+  for (cell_type* itr = row(y) + x; itr != row(y) + last; itr++) {
+    itr->attr  = attr;
+    itr->color = color;
+  }
+
+  m_dirty[y] = true;
+}
+
+void
+CellGrid::erase() {
+  std::fill(m_cells.begin(), m_cells.end(), blank_cell());
+  std::fill(m_dirty.begin(), m_dirty.end(), true);
+
+  m_x = 0;
+  m_y = 0;
+}
+
+void
+CellGrid::clear_to_eol() {
+  if (m_y >= m_height || m_width == 0)
+    return;
+
+  unsigned int x = m_x;
+
+  if (row(m_y)[x].length == 0 && x != 0)
+    x--;
+
+  std::fill(row(m_y) + x, row(m_y) + m_width, blank_cell());
+  m_dirty[m_y] = true;
+}
+
+unsigned int
+CellGrid::flush(WINDOW* window) {
+  unsigned int written = 0;
+
+  for (unsigned int y = 0; y < m_height; y++) {
+    if (!m_dirty[y])
+      continue;
+
+    m_dirty[y] = false;
+
+    cell_type* back  = row(y);
+    cell_type* front = m_front.data() + y * m_width;
+
+    for (unsigned int x = 0; x < m_width;) {
+      if (back[x] == front[x]) {
+        x++;
+        continue;
+      }
+
+      // Always start at the first half of a double width character.
+      if (back[x].length == 0 && x != 0)
+        x--;
+
+      unsigned int start = x;
+      attr_t       attr  = back[x].attr;
+      short        color = back[x].color;
+
+      m_buffer.clear();
+
+      do {
+        m_buffer.append(back[x].glyph, back[x].length);
+        front[x] = back[x];
+        x++;
+      } while (x < m_width &&
+               (back[x].length == 0 || (back[x] != front[x] &&
+                                        back[x].attr == attr &&
+                                        back[x].color == color)));
+
+      wmove(window, y, start);
+      wattr_set(window, attr, color, nullptr);
+      waddnstr(window, m_buffer.c_str(), m_buffer.size());
+
+      written += x - start;
+    }
+  }
+
+  wattr_set(window, A_NORMAL, 0, nullptr);
+
+  return written;
+}
+
+void
+CellGrid::put_glyph(const char*  glyph,
+                    unsigned int length,
+                    unsigned int width) {
+  if (m_y >= m_height || m_width == 0 || length > cell_type::max_glyph)
+    return;
+
+  // A double width character that doesn't fit goes on the next line.
+  if (m_x + width > m_width) {
+    clear_to_eol();
+    newline();
+
+    if (m_y >= m_height || width > m_width)
+      return;
+  }
+
+  cell_type cell;
+  std::memcpy(cell.glyph, glyph, length);
+  cell.length = length;
+  cell.attr   = m_attr;
+  cell.color  = m_color;
+
+  set_cell(m_x, m_y, cell);
+
+  if (width == 2) {
+    cell.length = 0;
+    set_cell(m_x + 1, m_y, cell);
+  }
+
+  m_dirty[m_y] = true;
+  m_x += width;
+
+  if (m_x >= m_width)
+    newline();
+}
+
+void
+CellGrid::append_combining(const char* glyph, unsigned int length) {
+  if (m_y >= m_height || m_width == 0 || (m_x == 0 && m_y == 0))
+    return;
+
+  unsigned int x = m_x != 0 ? m_x - 1 : m_width - 1;
+  unsigned int y = m_x != 0 ? m_y : m_y - 1;
+
+  if (row(y)[x].length == 0 && x != 0)
+    x--;
+
+  cell_type& cell = row(y)[x];
+
+  if (cell.length + length > cell_type::max_glyph)
+    return;
+
+  std::memcpy(cell.glyph + cell.length, glyph, length);
+  cell.length += length;
+
+  m_dirty[y] = true;
+}
+
+void
+CellGrid::set_cell(unsigned int x, unsigned int y, const cell_type& cell) {
+  cell_type* line = row(y);
+
+  // Overwriting either half of a double width character leaves the
+  // other half blank.
+  if (line[x].length == 0 && x != 0)
+    line[x - 1] = blank_cell();
+
+  if (x + 1 < m_width && line[x + 1].length == 0)
+    line[x + 1] = blank_cell();
+
+  line[x] = cell;
+}
+
+void
+CellGrid::newline() {
+  m_x = 0;
+  m_y++;
+}
+
+}
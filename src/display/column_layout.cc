@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <iterator>
+#include <torrent/data/file_list.h>
+#include <torrent/exceptions.h>
+#include <torrent/rate.h>
+
+#include "core/download.h"
+#include "display/utils.h"
+
+#include "display/column_layout.h"
+
+namespace display {
+
+DownloadListLayout downloadListLayout;
+
+namespace {
+
+char*
+print_name(char* first, char* last, core::Download* d) {
+  return print_buffer(first, last, " %-64.64s", d->info()->name().c_str());
+}
+
+char*
+print_status(char* first, char* last, core::Download* d) {
+  if (!d->download()->info()->is_open())
+    return print_buffer(first, last, "| CLOSED ");
+  else if (!d->download()->info()->is_active())
+    return print_buffer(first, last, "| OPEN   ");
+  else
+    return print_buffer(first, last, "|        ");
+}
+
+char*
+print_downloaded(char* first, char* last, core::Download* d) {
+  return print_buffer(first,
+                      last,
+                      "| %7.1f MB ",
+                      (double)d->download()->bytes_done() / (double)(1 << 20));
+}
+
+char*
+print_size(char* first, char* last, core::Download* d) {
+  return print_buffer(first,
+                      last,
+                      "| %7.1f MB ",
+                      (double)d->download()->file_list()->size_bytes() /
+                        (double)(1 << 20));
+}
+
+char*
+print_done(char* first, char* last, core::Download* d) {
+  if (d->is_done())
+    return print_buffer(first, last, "| 100%% ");
+  else if (d->is_open())
+    return print_buffer(first,
+                        last,
+                        "|  %2u%% ",
+                        (d->download()->file_list()->completed_chunks() * 100) /
+                          d->download()->file_list()->size_chunks());
+  else
+    return print_buffer(first, last, "|      ");
+}
+
+char*
+print_up_rate(char* first, char* last, core::Download* d) {
+  return print_buffer(first,
+                      last,
+                      "| %6.1f KB ",
+                      (double)d->info()->up_rate()->rate() / (1 << 10));
+}
+
+char*
+print_down_rate(char* first, char* last, core::Download* d) {
+  return print_buffer(first,
+                      last,
+                      "| %6.1f KB ",
+                      (double)d->info()->down_rate()->rate() / (1 << 10));
+}
+
+char*
+print_uploaded(char* first, char* last, core::Download* d) {
+  return print_buffer(first,
+                      last,
+                      "| %7.1f MB ",
+                      (double)d->info()->up_rate()->total() / (1 << 20));
+}
+
+char*
+print_eta(char* first, char* last, core::Download* d) {
+  first = print_buffer(first, last, "| ");
+
+  if (d->download()->info()->is_active() && !d->is_done())
+    return print_download_time_left(first, last, d);
+  else
+    return print_buffer(first, last, "         ");
+}
+
+char*
+print_ratio(char* first, char* last, core::Download* d) {
+  first = print_buffer(first, last, "| ");
+  first = print_download_ratio(first, last, d);
+  return print_buffer(first, last, " ");
+}
+
+char*
+print_misc(char* first, char* last, core::Download* d) {
+  first = print_buffer(first, last, "| ");
+  first = print_download_flags(first, last, d);
+  return print_download_misc(first, last, d);
+}
+
+const ColumnLayout::column_type columns[] = {
+  { "name",
+    " Name                           "
+    "                                 ",
+    &print_name },
+  { "status", "| Status ", &print_status },
+  { "downloaded", "| Downloaded ", &print_downloaded },
+  { "size", "| Size       ", &print_size },
+  { "done", "| Done ", &print_done },
+  { "up_rate", "| Up Rate   ", &print_up_rate },
+  { "down_rate", "| Down Rate ", &print_down_rate },
+  { "uploaded", "| Uploaded   ", &print_uploaded },
+  { "eta", "|  ETA      ", &print_eta },
+  { "ratio", "| Ratio", &print_ratio },
+  { "misc", "| Misc ", &print_misc },
+};
+
+}
+
+ColumnLayout::ColumnLayout(const std::string& spec)
+  : m_spec(spec) {
+  size_t pos = 0;
+
+  while (pos <= spec.size()) {
+    size_t      next = std::min(spec.find(',', pos), spec.size());
+    std::string name = spec.substr(pos, next - pos);
+
+    auto itr = std::find_if(
+      std::begin(columns), std::end(columns), [&name](const auto& column) {
+        return name == column.name;
+      });
+
+    if (itr == std::end(columns))
+      throw torrent::input_error("Unknown download list column '" + name +
+                                 "', valid columns are: " + column_names() +
+                                 ".");
+
+    m_columns.push_back(itr);
+    pos = next + 1;
+  }
+}
+
+std::string
+ColumnLayout::column_names() {
+  std::string result;
+
+  for (const auto& column : columns)
+    result += (result.empty() ? "" : ",") + std::string(column.name);
+
+  return result;
+}
+
+char*
+ColumnLayout::print_header(char* first, char* last) const {
+  for (const auto& column : m_columns)
+    first = print_buffer(first, last, "%s", column->header);
+
+  return first;
+}
+
+char*
+ColumnLayout::print(char* first, char* last, core::Download* d) const {
+  *first = '\0';
+
+  for (const auto& column : m_columns)
+    first = column->print(first, last, d);
+
+  if (first > last)
+    throw torrent::internal_error(
+      "ColumnLayout::print(...) wrote past end of the buffer.");
+
+  return first;
+}
+
+}
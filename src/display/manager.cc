@@ -12,7 +12,8 @@
 
 namespace display {
 
-Manager::Manager() {
+Manager::Manager()
+  : m_timeLastActivity(cachedTime) {
   m_taskUpdate.slot() = [this] { receive_update(); };
 }
 
@@ -25,8 +26,60 @@ Manager::force_redraw() {
   m_forceRedraw = true;
 }
 
+void
+Manager::receive_activity() {
+  m_timeLastActivity = cachedTime;
+
+  if (!m_idle)
+    return;
+
+  // Windows were left waiting on delayed redraws, so bring them all
+  // up to date right away.
+  m_idle      = false;
+  m_redrawAll = true;
+
+  torrent::utils::priority_queue_erase(&taskScheduler, &m_taskUpdate);
+  torrent::utils::priority_queue_insert(
+    &taskScheduler, &m_taskUpdate, cachedTime);
+}
+
+torrent::utils::timer
+Manager::idle_delay() const {
+  if (m_idlePeriod == 0)
+    return torrent::utils::timer();
+
+  int64_t idle    = (cachedTime - m_timeLastActivity).seconds();
+  int64_t periods = idle / m_idlePeriod;
+  int64_t delay   = 0;
+
+  // 2, 4, 8... seconds for each idle period, up to the max.
+  while (periods-- > 0 && delay < max_idle_delay)
+    delay = std::max<int64_t>(delay * 2, 2);
+
+  return torrent::utils::timer::from_seconds(
+    std::min<int64_t>(delay, max_idle_delay));
+}
+
 void
 Manager::schedule(Window* w, torrent::utils::timer t) {
+  if (!Canvas::isInitialized())
+    return;
+
+  // Only periodic redraws are delayed, not windows marked dirty.
+  if (t > cachedTime) {
+    torrent::utils::timer delay = idle_delay();
+
+    if (delay != torrent::utils::timer()) {
+      m_idle = true;
+      t      = std::max(t, (cachedTime + delay).round_seconds());
+    }
+  }
+
+  // A window marked dirty again before it has been redrawn keeps its
+  // place, it gets drawn in the same update either way.
+  if (w->task_update()->is_queued() && w->task_update()->time() <= t)
+    return;
+
   torrent::utils::priority_queue_erase(&m_scheduler, w->task_update());
   torrent::utils::priority_queue_insert(&m_scheduler, w->task_update(), t);
   schedule_update(50000);
@@ -56,6 +109,11 @@ Manager::receive_update() {
     Canvas::redraw_std();
 
     adjust_layout();
+    m_redrawAll = true;
+  }
+
+  if (m_redrawAll) {
+    m_redrawAll = false;
     m_rootFrame.redraw();
   }
 
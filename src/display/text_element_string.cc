@@ -60,6 +60,55 @@ TextElementCString::copy_string(char* first, char* last, rpc::target_type) {
   return first + length;
 }
 
+void
+TextElementCommand::compile() {
+  char        key[128];
+  const char* first = m_command;
+
+  m_args = torrent::Object();
+
+  if (rpc::parse_line(key, m_args, first, m_commandEnd)) {
+    compile_object(&m_args);
+    m_key = key;
+  }
+
+  m_compiled = true;
+}
+
+// Visits the same objects as 'parse_command_execute', which would
+// otherwise parse each '$command=' string again on every call.
+void
+TextElementCommand::compile_object(torrent::Object* object) {
+  if (object->is_list()) {
+    for (auto& itr : object->as_list())
+      if (!itr.is_list())
+        compile_object(&itr);
+
+  } else if (object->is_dict_key()) {
+    compile_object(&object->as_dict_obj());
+
+  } else if (object->is_string() && *object->as_string().c_str() == '$') {
+    const std::string& str   = object->as_string();
+    const char*        first = str.c_str() + 1;
+    char               key[128];
+    torrent::Object    args;
+
+    if (!rpc::parse_line(key, args, first, str.c_str() + str.size())) {
+      *object = torrent::Object();
+      return;
+    }
+
+    compile_object(&args);
+
+    torrent::Object function = torrent::Object::create_dict_key();
+    function.set_flags(torrent::Object::flag_function);
+    function.as_dict_key() = key;
+    function.as_dict_obj() = args;
+
+    *object = function;
+  }
+}
+
 char*
 TextElementCommand::print(char*                    first,
                           char*                    last,
@@ -69,8 +118,17 @@ TextElementCommand::print(char*                    first,
   push_attribute(attributes,
                  Attributes(first, m_attributes, Attributes::color_invalid));
 
-  torrent::Object result =
-    rpc::parse_command(target, m_command, m_commandEnd).first;
+  if (!m_compiled)
+    compile();
+
+  torrent::Object result;
+
+  if (!m_key.empty()) {
+    torrent::Object args = m_args;
+
+    rpc::parse_command_execute(target, &args);
+    result = rpc::commands.call_command(m_key.c_str(), args, target);
+  }
 
   if (first == last)
     return first;
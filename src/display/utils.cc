@@ -3,6 +3,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <functional>
 #include <iomanip>
 #include <sstream>
 #include <torrent/connection_manager.h>
@@ -23,7 +24,6 @@
 #include "core/download.h"
 #include "core/manager.h"
 #include "globals.h"
-#include "rpc/parse_commands.h"
 #include "ui/root.h"
 
 #include "display/utils.h"
@@ -117,6 +117,39 @@ print_download_title(char* first, char* last, core::Download* d) {
   return print_buffer(first, last, " %s", d->info()->name().c_str());
 }
 
+char*
+print_download_ratio(char* first, char* last, core::Download* d) {
+  return print_buffer(first, last, "%4.2f", (double)d->ratio() / 1000.0);
+}
+
+char*
+print_download_flags(char* first, char* last, core::Download* d) {
+  const torrent::Object& variables = d->bencode()->get_key("rtorrent");
+
+  return print_buffer(
+    first,
+    last,
+    "%c%c",
+    variables.get_key_string("tied_to_file").empty() ? ' ' : 'T',
+    variables.get_key_value("ignore_commands") == 0 ? ' ' : 'I');
+}
+
+char*
+print_download_misc(char* first, char* last, core::Download* d) {
+  const char* priority = d->priority_str();
+
+  if (d->priority() != 2 && priority != nullptr)
+    first = print_buffer(first, last, " %s", priority);
+
+  const std::string& throttleName =
+    d->bencode()->get_key("rtorrent").get_key_string("throttle_name");
+
+  if (!throttleName.empty())
+    first = print_buffer(first, last, " %s", throttleName.c_str());
+
+  return first;
+}
+
 char*
 print_download_info_full(char* first, char* last, core::Download* d) {
   if (!d->download()->info()->is_open())
@@ -157,34 +190,11 @@ print_download_info_full(char* first, char* last, core::Download* d) {
     first = print_buffer(first, last, "                ");
   }
 
-  first = print_buffer(
-    first,
-    last,
-    " [%c%c R: %4.2f",
-    rpc::call_command_string("d.tied_to_file", rpc::make_target(d)).empty()
-      ? ' '
-      : 'T',
-    rpc::call_command_value("d.ignore_commands", rpc::make_target(d)) == 0
-      ? ' '
-      : 'I',
-    (double)rpc::call_command_value("d.ratio", rpc::make_target(d)) / 1000.0);
-
-  if (d->priority() != 2)
-    first = print_buffer(
-      first,
-      last,
-      " %s",
-      rpc::call_command_string("d.priority_str", rpc::make_target(d)).c_str());
-
-  if (!d->bencode()
-         ->get_key("rtorrent")
-         .get_key_string("throttle_name")
-         .empty())
-    first = print_buffer(
-      first,
-      last,
-      " %s",
-      rpc::call_command_string("d.throttle_name", rpc::make_target(d)).c_str());
+  first = print_buffer(first, last, " [");
+  first = print_download_flags(first, last, d);
+  first = print_buffer(first, last, " R: ");
+  first = print_download_ratio(first, last, d);
+  first = print_download_misc(first, last, d);
 
   first = print_buffer(first, last, "]");
 
@@ -199,7 +209,7 @@ char*
 print_download_status(char* first, char* last, core::Download* d) {
   if (d->is_active())
     ;
-  else if (rpc::call_command_value("d.hashing", rpc::make_target(d)) != 0)
+  else if (d->bencode()->get_key("rtorrent").get_key_value("hashing") != 0)
     first = print_buffer(first, last, "Hashing: ");
   else if (!d->is_active())
     first = print_buffer(first, last, "Inactive: ");
@@ -241,114 +251,39 @@ print_download_status(char* first, char* last, core::Download* d) {
   return first;
 }
 
-char*
-print_download_column_compact(char* first, char* last) {
-  first = print_buffer(first, last, " %-64.64s", "Name");
-  first = print_buffer(first,
-                       last,
-                       "| Status | Downloaded | Size       | Done | Up Rate   "
-                       "| Down Rate | Uploaded   |  ETA      | Ratio| Misc ");
-
-  if (first > last)
-    throw torrent::internal_error(
-      "print_download_column_compact(...) wrote past end of the buffer.");
-
-  return first;
-}
-
-char*
-print_download_info_compact(char* first, char* last, core::Download* d) {
-  first = print_buffer(first, last, " %-64.64s", d->info()->name().c_str());
-  first = print_buffer(first, last, "|");
-
-  if (!d->download()->info()->is_open())
-    first = print_buffer(first, last, " CLOSED ");
-  else if (!d->download()->info()->is_active())
-    first = print_buffer(first, last, " OPEN   ");
-  else
-    first = print_buffer(first, last, "        ");
-
-  first = print_buffer(first,
-                       last,
-                       "| %7.1f MB ",
-                       (double)d->download()->bytes_done() / (double)(1 << 20));
-  first = print_buffer(first,
-                       last,
-                       "| %7.1f MB ",
-                       (double)d->download()->file_list()->size_bytes() /
-                         (double)(1 << 20));
-  first = print_buffer(first, last, "|");
-
-  if (d->is_done())
-    first = print_buffer(first, last, " 100%% ");
-  else if (d->is_open())
-    first =
-      print_buffer(first,
-                   last,
-                   "  %2u%% ",
-                   (d->download()->file_list()->completed_chunks() * 100) /
-                     d->download()->file_list()->size_chunks());
-  else
-    first = print_buffer(first, last, "      ");
-
-  first = print_buffer(first,
-                       last,
-                       "| %6.1f KB ",
-                       (double)d->info()->up_rate()->rate() / (1 << 10));
-  first = print_buffer(first,
-                       last,
-                       "| %6.1f KB ",
-                       (double)d->info()->down_rate()->rate() / (1 << 10));
-  first = print_buffer(first,
-                       last,
-                       "| %7.1f MB ",
-                       (double)d->info()->up_rate()->total() / (1 << 20));
-  first = print_buffer(first, last, "| ");
-
-  if (d->download()->info()->is_active() && !d->is_done())
-    first = print_download_time_left(first, last, d);
-  else
-    first = print_buffer(first, last, "         ");
-
-  first = print_buffer(
-    first,
-    last,
-    "| %4.2f ",
-    (double)rpc::call_command_value("d.ratio", rpc::make_target(d)) / 1000.0);
-  first = print_buffer(
-    first,
-    last,
-    "| %c%c",
-    rpc::call_command_string("d.tied_to_file", rpc::make_target(d)).empty()
-      ? ' '
-      : 'T',
-    rpc::call_command_value("d.ignore_commands", rpc::make_target(d)) == 0
-      ? ' '
-      : 'I',
-    (double)rpc::call_command_value("d.ratio", rpc::make_target(d)) / 1000.0);
-
-  if (d->priority() != 2)
-    first = print_buffer(
-      first,
-      last,
-      " %s",
-      rpc::call_command_string("d.priority_str", rpc::make_target(d)).c_str());
-
-  if (!d->bencode()
-         ->get_key("rtorrent")
-         .get_key_string("throttle_name")
-         .empty())
-    first = print_buffer(
-      first,
-      last,
-      " %s",
-      rpc::call_command_string("d.throttle_name", rpc::make_target(d)).c_str());
-
-  if (first > last)
-    throw torrent::internal_error(
-      "print_download_info_compact(...) wrote past end of the buffer.");
-
-  return first;
+uint64_t
+download_signature(core::Download* d) {
+  uint64_t signature = 0;
+
+  auto mix = [&signature](uint64_t value) {
+    signature = (signature ^ value) * 0x100000001b3;
+  };
+
+  const torrent::Object& variables = d->bencode()->get_key("rtorrent");
+
+  mix(std::hash<std::string>()(d->info()->name()));
+  mix(d->download()->info()->is_open() << 0 |
+      d->download()->info()->is_active() << 1 | d->is_done() << 2 |
+      d->is_hash_checking() << 3);
+  mix(d->download()->bytes_done());
+  mix(d->download()->file_list()->size_bytes());
+  mix(d->download()->file_list()->completed_chunks());
+  mix(d->download()->chunks_hashed());
+  mix(d->info()->up_rate()->rate());
+  mix(d->info()->down_rate()->rate());
+  mix(d->info()->up_rate()->total());
+  mix(d->priority());
+  mix(variables.get_key_value("hashing"));
+  mix(variables.get_key_value("ignore_commands"));
+  mix(std::hash<std::string>()(variables.get_key_string("tied_to_file")));
+  mix(std::hash<std::string>()(variables.get_key_string("throttle_name")));
+  mix(std::hash<std::string>()(d->message()));
+
+  // The status of a busy tracker is not worth tracking.
+  if (d->tracker_list()->has_active_not_scrape())
+    mix(cachedTime.usec());
+
+  return signature;
 }
 
 char*
@@ -6,9 +6,9 @@
 #include "core/download.h"
 #include "core/view.h"
 #include "display/canvas.h"
+#include "display/column_layout.h"
 #include "display/utils.h"
 #include "globals.h"
-#include "rpc/parse_commands.h"
 
 #include "display/window_download_list.h"
 
@@ -30,59 +30,129 @@ WindowDownloadList::set_view(core::View* l) {
     m_view->signal_changed().erase(m_changed_itr);
 
   m_view = l;
+  m_rows.clear();
 
   if (m_view != nullptr)
     m_changed_itr = m_view->signal_changed().insert(
       m_view->signal_changed().begin(), [this] { mark_dirty(); });
 }
 
+void
+WindowDownloadList::render_row(row_type*           row,
+                               core::Download*     download,
+                               const ColumnLayout* columns,
+                               char*               first,
+                               char*               last) {
+  row->lines.clear();
+
+  if (columns != nullptr) {
+    columns->print(first, last, download);
+    row->lines.emplace_back(first);
+    return;
+  }
+
+  print_download_title(first, last, download);
+  row->lines.emplace_back(first);
+  print_download_info_full(first, last, download);
+  row->lines.emplace_back(first);
+  print_download_status(first, last, download);
+  row->lines.emplace_back(first);
+}
+
+void
+WindowDownloadList::print_line(unsigned int       y,
+                               const std::string& text,
+                               int                attributes) {
+  if (y >= m_lines.size())
+    return;
+
+  line_type& line = m_lines[y];
+
+  if (line.text == text && line.attributes == attributes)
+    return;
+
+  m_canvas->erase_line(y);
+  m_canvas->set_default_attributes(attributes);
+  m_canvas->print(0, y, "%s", text.c_str());
+  m_canvas->set_default_attributes(A_NORMAL);
+
+  line.text       = text;
+  line.attributes = attributes;
+}
+
+void
+WindowDownloadList::clear_lines(unsigned int y) {
+  for (; y < m_lines.size(); y++)
+    print_line(y, std::string(), A_NORMAL);
+}
+
 void
 WindowDownloadList::redraw() {
   m_slotSchedule(
     this,
     (cachedTime + torrent::utils::timer::from_seconds(1)).round_seconds());
 
-  m_canvas->erase();
-
-  if (m_view == nullptr)
-    return;
+  // Lines that didn't change are left as they are in the window, but
+  // it still needs to be copied in full to the screen in case another
+  // window was shown in its place. Only changed cells reach the
+  // terminal either way.
+  m_canvas->touch();
 
   const auto width  = m_canvas->width();
   const auto height = m_canvas->height();
-  if (m_view->empty_visible() || width < 5 || height < 2) {
+
+  if (width != m_width || height != m_lines.size()) {
+    m_canvas->erase();
+    m_lines.assign(height, line_type());
+    m_rows.clear();
+    m_width = width;
+  }
+
+  if (m_view == nullptr || m_view->empty_visible() || width < 5 ||
+      height < 2) {
+    m_rows.clear();
+    clear_lines(0);
     return;
   }
 
-  m_canvas->print(0,
-                  0,
-                  "%s",
-                  ("[View: " + m_view->name() +
-                   (m_view->get_filter_temp().is_empty() ? "" : " (filtered)") +
-                   "]")
-                    .c_str());
+  std::string header =
+    "[View: " + m_view->name() +
+    (m_view->get_filter_temp().is_empty() ? "" : " (filtered)") + "]";
 
   // show "X of Y"
   if (width > 16 + 8 + m_view->name().length()) {
-    int item_idx = m_view->focus() - m_view->begin_visible();
+    char count[32];
+    int  item_idx = m_view->focus() - m_view->begin_visible();
+
     if (item_idx == int(m_view->size()))
-      m_canvas->print(width - 16, 0, "[ none of %-5d]", m_view->size());
+      snprintf(count, sizeof(count), "[ none of %-5d]", m_view->size());
     else
-      m_canvas->print(
-        width - 16, 0, "[%5d of %-5d]", item_idx + 1, m_view->size());
+      snprintf(
+        count, sizeof(count), "[%5d of %-5d]", item_idx + 1, m_view->size());
+
+    header.resize(width - 16, ' ');
+    header += count;
   }
 
-  int               layout_height;
-  const std::string layout_name =
-    rpc::call_command_string("ui.torrent_list.layout");
+  print_line(0, header.substr(0, width), A_NORMAL);
 
-  if (layout_name == "full") {
-    layout_height = 3;
-  } else if (layout_name == "compact") {
+  // The name is either 'full' or 'compact', as checked by
+  // 'ui.torrent_list.layout.set'.
+  const std::string&  layout_name = downloadListLayout.name;
+  const ColumnLayout* columns      = nullptr;
+  int                 layout_height = 3;
+
+  if (layout_name == "compact") {
+    columns       = &downloadListLayout.columns;
     layout_height = 1;
-  } else {
-    m_canvas->print(
-      0, 0, "INVALID ui.torrent_list.layout '%s'", layout_name.c_str());
-    return;
+  }
+
+  std::string layout =
+    columns != nullptr ? layout_name + ":" + columns->spec() : layout_name;
+
+  if (layout != m_layout) {
+    m_layout = layout;
+    m_rows.clear();
   }
 
   using Range = std::pair<core::View::iterator, core::View::iterator>;
@@ -100,46 +170,48 @@ WindowDownloadList::redraw() {
   if (range.second != m_view->end_visible())
     ++range.second;
 
-  int   pos    = 1;
-  char* buffer = static_cast<char*>(calloc(width + 1, sizeof(char)));
-  char* last   = buffer + width - 2 + 1;
+  unsigned int      pos = 1;
+  std::vector<char> buffer(width + 1);
+  char*             first = buffer.data();
+  char*             last  = buffer.data() + width - 2 + 1;
 
-  // Add a proper 'column info' method.
-  if (layout_name == "compact") {
-    print_download_column_compact(buffer, last);
-
-    m_canvas->set_default_attributes(A_BOLD);
-    m_canvas->print(0, pos++, "  %s", buffer);
+  if (columns != nullptr) {
+    columns->print_header(first, last);
+    print_line(pos++, "  " + std::string(first), A_BOLD);
   }
 
-  if (layout_name == "full") {
-    while (range.first != range.second) {
-      print_download_title(buffer, last, *range.first);
-      m_canvas->print(
-        0, pos++, "%c %s", range.first == m_view->focus() ? '*' : ' ', buffer);
-      print_download_info_full(buffer, last, *range.first);
-      m_canvas->print(
-        0, pos++, "%c %s", range.first == m_view->focus() ? '*' : ' ', buffer);
-      print_download_status(buffer, last, *range.first);
-      m_canvas->print(
-        0, pos++, "%c %s", range.first == m_view->focus() ? '*' : ' ', buffer);
-
-      range.first++;
+  // Downloads that scrolled out of view are dropped from the cache.
+  row_map rows;
+
+  for (; range.first != range.second; range.first++) {
+    core::Download* download  = *range.first;
+    uint64_t        signature = download_signature(download);
+    auto            itr       = m_rows.find(download);
+    row_type        row;
+
+    if (itr != m_rows.end() && itr->second.signature == signature) {
+      row = std::move(itr->second);
+    } else {
+      render_row(&row, download, columns, first, last);
+      row.signature = signature;
     }
 
-  } else {
-    while (range.first != range.second) {
-      print_download_info_compact(buffer, last, *range.first);
-      m_canvas->set_default_attributes(
-        range.first == m_view->focus() ? A_REVERSE : A_NORMAL);
-      m_canvas->print(
-        0, pos++, "%c %s", range.first == m_view->focus() ? '*' : ' ', buffer);
+    bool        focused = range.first == m_view->focus();
+    std::string prefix  = focused ? "* " : "  ";
 
-      range.first++;
+    if (columns == nullptr) {
+      for (const auto& line : row.lines)
+        print_line(pos++, prefix + line, A_NORMAL);
+    } else {
+      print_line(
+        pos++, prefix + row.lines.front(), focused ? A_REVERSE : A_NORMAL);
     }
+
+    rows.emplace(download, std::move(row));
   }
 
-  free(buffer);
+  m_rows.swap(rows);
+  clear_lines(pos);
 }
 
 }
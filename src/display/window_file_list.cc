@@ -92,43 +92,40 @@ WindowFileList::redraw() {
     (cachedTime + torrent::utils::timer::from_seconds(10)).round_seconds());
   m_canvas->erase();
 
-  torrent::FileList* fl = m_element->download()->download()->file_list();
+  const ui::FileListIndex& index     = m_element->index();
+  const bool               collapsed = m_element->is_collapsed();
+  const uint32_t           selected  = m_element->selected_row();
 
   const auto height = m_canvas->height();
   const auto width  = m_canvas->width();
-  if (fl->size_files() == 0 || height < 3 || width < 18) {
+  if (index.empty() || height < 3 || width < 18) {
     return;
   }
 
-  std::vector<iterator> entries(height - 1);
+  // Only the rows around the selection are visited, stepping over
+  // collapsed directories through the index.
+  std::vector<uint32_t> entries(height - 1);
 
   unsigned int last = 0;
 
-  for (iterator itr = m_element->selected(); last != height - 1;) {
-    if (m_element->is_collapsed())
-      itr.forward_current_depth();
-    else
-      ++itr;
+  for (uint32_t row = selected; last != height - 1;) {
+    row = index.next(row, collapsed);
 
-    entries[last++] = itr;
+    entries[last++] = row;
 
-    if (itr == iterator(fl->end()))
+    if (row == index.size())
       break;
   }
 
   unsigned int first = height - 1;
 
-  for (iterator itr = m_element->selected();
-       first >= last || first > (height - 1) / 2;) {
-    entries[--first] = itr;
+  for (uint32_t row = selected; first >= last || first > (height - 1) / 2;) {
+    entries[--first] = row;
 
-    if (itr == iterator(fl->begin()))
+    if (row == 0)
       break;
 
-    if (m_element->is_collapsed())
-      itr.backward_current_depth();
-    else
-      --itr;
+    row = index.prev(row, collapsed);
   }
 
   unsigned int pos           = 0;
@@ -137,12 +134,12 @@ WindowFileList::redraw() {
   m_canvas->print(0, pos++, "Cmp Pri  Size   Filename");
 
   while (pos != height) {
-    iterator itr = entries[first];
-
-    if (itr == iterator(fl->end()))
+    if (entries[first] == index.size())
       break;
 
-    m_canvas->set_default_attributes(itr == m_element->selected()
+    const iterator& itr = index.at(entries[first]);
+
+    m_canvas->set_default_attributes(entries[first] == selected
                                        ? is_focused() ? A_REVERSE : A_BOLD
                                        : A_NORMAL);
 
@@ -2,6 +2,7 @@
 // Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
 
 #include <algorithm>
+#include <vector>
 
 #include "display/canvas.h"
 #include "display/utils.h"
@@ -64,38 +65,31 @@ WindowText::redraw() {
 
   unsigned int position = 0;
 
-  if (m_errorHandler != nullptr && std::get<1>(m_target) == nullptr) {
-    char* buffer = static_cast<char*>(calloc(width + 1, sizeof(char)));
+  // A single line buffer and attribute list are reused for all lines.
+  std::vector<char>       buffer(width + 1);
+  Canvas::attributes_list attributes;
+
+  auto print_line = [&](TextElement* element) {
+    char* first = buffer.data();
 
-    Canvas::attributes_list attributes;
+    attributes.clear();
     attributes.push_back(
-      Attributes(buffer, Attributes::a_normal, Attributes::color_default));
+      Attributes(first, Attributes::a_normal, Attributes::color_default));
 
-    char* last =
-      m_errorHandler->print(buffer, buffer + width, &attributes, m_target);
+    char* last = element->print(first, first + width, &attributes, m_target);
 
-    m_canvas->print_attributes(0, position, buffer, last, &attributes);
+    m_canvas->print_attributes(0, position, first, last, &attributes);
+  };
 
-    free(buffer);
+  if (m_errorHandler != nullptr && std::get<1>(m_target) == nullptr) {
+    print_line(m_errorHandler);
     return;
   }
 
   for (iterator itr = begin(); itr != end() && position < height;
        ++itr, ++position) {
-    if (*itr == nullptr)
-      continue;
-
-    char* buffer = static_cast<char*>(calloc(width + 1, sizeof(char)));
-
-    Canvas::attributes_list attributes;
-    attributes.push_back(
-      Attributes(buffer, Attributes::a_normal, Attributes::color_default));
-
-    char* last = (*itr)->print(buffer, buffer + width, &attributes, m_target);
-
-    m_canvas->print_attributes(0, position, buffer, last, &attributes);
-
-    free(buffer);
+    if (*itr != nullptr)
+      print_line(*itr);
   }
 }
 
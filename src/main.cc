@@ -207,15 +207,20 @@ load_arg_torrents(char** first, char** last) {
 
 static uint64_t
 client_next_timeout() {
+  uint64_t timeout;
+
   if (taskScheduler.empty())
-    return (control->is_shutdown_started()
-              ? torrent::utils::timer::from_milliseconds(100)
-              : torrent::utils::timer::from_seconds(60))
-      .usec();
+    timeout = (control->is_shutdown_started()
+                 ? torrent::utils::timer::from_milliseconds(100)
+                 : torrent::utils::timer::from_seconds(60))
+                .usec();
   else if (taskScheduler.top()->time() <= cachedTime)
-    return 0;
+    timeout = 0;
   else
-    return (taskScheduler.top()->time() - cachedTime).usec();
+    timeout = (taskScheduler.top()->time() - cachedTime).usec();
+
+  control->core()->tick_profiler()->tick_end(timeout);
+  return timeout;
 }
 
 static void
@@ -224,13 +229,15 @@ client_perform() {
   if (control->is_shutdown_completed())
     throw torrent::shutdown_exception();
 
+  control->core()->tick_profiler()->tick_begin();
+
   if (control->is_shutdown_received())
     control->handle_shutdown();
 
   control->inc_tick();
 
   cachedTime = torrent::utils::timer::current();
-  torrent::utils::priority_queue_perform(&taskScheduler, cachedTime);
+  control->core()->tick_profiler()->perform(&taskScheduler, cachedTime);
 }
 
 int
@@ -240,6 +247,10 @@ main(int argc, char** argv) {
     // Temporary.
     setlocale(LC_ALL, "");
 
+    // Forked before anything else is allocated or any threads are
+    // started, so the helper running external commands stays small.
+    rpc::execFile.spawner()->open();
+
     cachedTime = torrent::utils::timer::current();
 
     // Initialize logging:
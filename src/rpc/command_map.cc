@@ -4,6 +4,7 @@
 #include <torrent/data/file_list_iterator.h>
 #include <torrent/exceptions.h>
 #include <torrent/object.h>
+#include <torrent/utils/timer.h>
 #include <vector>
 
 // Get better logging...
@@ -21,6 +22,27 @@ namespace rpc {
 
 command_base::stack_type command_base::current_stack;
 
+namespace {
+
+// Records the time spent in a command on leaving its scope, whether
+// it returns or throws.
+class command_timer {
+public:
+  command_timer(utils::LatencyHistogram* histogram)
+    : m_histogram(histogram)
+    , m_start(torrent::utils::timer::current_usec()) {}
+
+  ~command_timer() {
+    m_histogram->insert(torrent::utils::timer::current_usec() - m_start);
+  }
+
+private:
+  utils::LatencyHistogram* m_histogram;
+  int64_t                  m_start;
+};
+
+}
+
 CommandMap::~CommandMap() {
   std::vector<const char*> keys;
 
@@ -155,13 +177,21 @@ CommandMap::call_command(key_type           key,
     throw torrent::input_error("Command \"" + std::string(key) +
                                "\" does not exist.");
 
-  return itr->second.m_anySlot(&itr->second.m_variable, target, arg);
+  return call_command(itr, arg, target);
 }
 
 const CommandMap::mapped_type
 CommandMap::call_command(iterator           itr,
                          const mapped_type& arg,
                          target_type        target) {
+  if (!profiler.is_enabled())
+    return itr->second.m_anySlot(&itr->second.m_variable, target, arg);
+
+  if (itr->second.m_profile == nullptr)
+    itr->second.m_profile = profiler.command(itr->first);
+
+  command_timer timer(itr->second.m_profile);
+
   return itr->second.m_anySlot(&itr->second.m_variable, target, arg);
 }
 
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <vector>
+
+#include "rpc/command_profiler.h"
+
+namespace rpc {
+
+void
+CommandProfiler::insert_rpc_request(uint64_t usec) {
+  std::lock_guard<std::mutex> guard(m_rpcMutex);
+
+  m_rpcRequest.insert(usec);
+}
+
+void
+CommandProfiler::insert_rpc_lock(uint64_t waitUsec, uint64_t holdUsec) {
+  std::lock_guard<std::mutex> guard(m_rpcMutex);
+
+  m_rpcLockWait.insert(waitUsec);
+  m_rpcLockHold.insert(holdUsec);
+}
+
+void
+CommandProfiler::reset() {
+  for (auto& entry : m_commands)
+    entry.second.clear();
+
+  std::lock_guard<std::mutex> guard(m_rpcMutex);
+
+  m_rpcRequest.clear();
+  m_rpcLockWait.clear();
+  m_rpcLockHold.clear();
+}
+
+torrent::Object
+CommandProfiler::commands_object(uint32_t limit) const {
+  std::vector<command_map::const_iterator> sorted;
+
+  for (auto itr = m_commands.begin(); itr != m_commands.end(); itr++)
+    if (itr->second.count() != 0)
+      sorted.push_back(itr);
+
+  if (limit != 0 && limit < sorted.size()) {
+    std::partial_sort(sorted.begin(),
+                      sorted.begin() + limit,
+                      sorted.end(),
+                      [](const auto& a, const auto& b) {
+                        return a->second.sum() > b->second.sum();
+                      });
+    sorted.resize(limit);
+  }
+
+  torrent::Object result = torrent::Object::create_map();
+
+  for (const auto& itr : sorted)
+    result.insert_key(itr->first, itr->second.to_object());
+
+  return result;
+}
+
+torrent::Object
+CommandProfiler::rpc_object() const {
+  std::lock_guard<std::mutex> guard(m_rpcMutex);
+  torrent::Object             result = torrent::Object::create_map();
+
+  result.insert_key("request", m_rpcRequest.to_object());
+  result.insert_key("lock_wait", m_rpcLockWait.to_object());
+  result.insert_key("lock_hold", m_rpcLockHold.to_object());
+
+  return result;
+}
+
+}
@@ -13,16 +13,15 @@
 
 namespace rpc {
 
-CommandScheduler::~CommandScheduler() {
-  for (const auto& item : *this) {
-    delete item;
-  }
+CommandScheduler::CommandScheduler() {
+  m_task.slot() = [this] { wheel_run(); };
 }
 
-CommandScheduler::iterator
-CommandScheduler::find(const std::string& key) {
-  return std::find_if(
-    begin(), end(), [key](CommandSchedulerItem* i) { return key == i->key(); });
+CommandScheduler::~CommandScheduler() {
+  priority_queue_erase(&taskScheduler, &m_task);
+
+  for (const auto& entry : m_items)
+    delete entry.second;
 }
 
 CommandScheduler::iterator
@@ -30,26 +29,171 @@ CommandScheduler::insert(const std::string& key) {
   if (key.empty())
     throw torrent::input_error("Scheduler received an empty key.");
 
-  iterator itr = find(key);
+  erase(find(key));
 
+  return m_items.emplace(key, new CommandSchedulerItem(key)).first;
+}
+
+void
+CommandScheduler::erase(iterator itr) {
   if (itr == end())
-    itr = base_type::insert(end(), nullptr);
-  else
-    delete *itr;
+    return;
 
-  *itr           = new CommandSchedulerItem(key);
-  (*itr)->slot() = [this, item = *itr] { return call_item(item); };
+  value_type item = itr->second;
 
-  return itr;
+  if (item == m_calling)
+    m_calling = nullptr;
+
+  disable(item);
+  m_items.erase(itr);
+
+  delete item;
 }
 
 void
-CommandScheduler::erase(iterator itr) {
-  if (itr == end())
+CommandScheduler::enable(value_type item, torrent::utils::timer t) {
+  if (t == torrent::utils::timer())
+    throw torrent::internal_error(
+      "CommandScheduler::enable() t == torrent::utils::timer().");
+
+  if (item->is_queued())
+    disable(item);
+
+  // Only reset the wheel's time when nothing depends on it.
+  if (m_queued == 0)
+    m_wheelTime = cachedTime.seconds();
+
+  item->m_timeScheduled = t;
+  item->m_expires       = t.seconds();
+  item->m_sequence      = m_sequence++;
+
+  wheel_insert(item);
+  m_queued++;
+
+  wheel_update_task();
+}
+
+void
+CommandScheduler::disable(value_type item) {
+  item->m_timeScheduled = torrent::utils::timer();
+
+  if (!item->is_queued())
     return;
 
-  delete *itr;
-  base_type::erase(itr);
+  item->m_slot->erase(item->m_slotItr);
+  item->m_slot = nullptr;
+  m_queued--;
+
+  wheel_update_task();
+}
+
+void
+CommandScheduler::wheel_insert(value_type item) {
+  uint64_t expires = std::max(item->m_expires, m_wheelTime);
+  uint64_t delta   = expires - m_wheelTime;
+
+  unsigned int level = 0;
+
+  while (level + 1 < wheel_levels &&
+         delta >= (uint64_t(1) << (wheel_bits * (level + 1))))
+    level++;
+
+  // Items too far out for the top level are placed at its end, and
+  // moved back up when cascaded.
+  uint64_t range = uint64_t(1) << (wheel_bits * wheel_levels);
+
+  if (delta >= range)
+    expires = m_wheelTime + range - 1;
+
+  slot_type* slot =
+    &m_wheel[level][(expires >> (wheel_bits * level)) & wheel_mask];
+
+  item->m_slot    = slot;
+  item->m_slotItr = slot->insert(slot->end(), item);
+}
+
+// Moves the items of the current slot of a level down to the lower
+// levels. Returns true if the level wrapped around, in which case the
+// level above needs to be cascaded too.
+bool
+CommandScheduler::wheel_cascade(unsigned int level) {
+  unsigned int index = (m_wheelTime >> (wheel_bits * level)) & wheel_mask;
+  slot_type    items;
+
+  items.splice(items.end(), m_wheel[level][index]);
+
+  for (auto item : items)
+    wheel_insert(item);
+
+  return index == 0;
+}
+
+void
+CommandScheduler::wheel_run() {
+  uint64_t now = cachedTime.seconds();
+
+  while (m_queued != 0 && m_wheelTime <= now) {
+    unsigned int index = m_wheelTime & wheel_mask;
+
+    if (index == 0) {
+      unsigned int level = 1;
+
+      while (level < wheel_levels && wheel_cascade(level))
+        level++;
+    }
+
+    slot_type expired;
+    expired.splice(expired.end(), m_wheel[0][index]);
+
+    m_wheelTime++;
+
+    // Items cascaded from the levels above end up after those
+    // inserted directly.
+    expired.sort([](value_type a, value_type b) {
+      return a->m_sequence < b->m_sequence;
+    });
+
+    for (auto item : expired)
+      item->m_slot = &expired;
+
+    // Items may be erased or rescheduled by the commands we call, so
+    // take them off one at a time.
+    while (!expired.empty()) {
+      value_type item = expired.front();
+
+      expired.pop_front();
+      item->m_slot = nullptr;
+      m_queued--;
+
+      call_item(item);
+    }
+  }
+
+  wheel_update_task();
+}
+
+void
+CommandScheduler::wheel_update_task() {
+  if (m_queued == 0) {
+    priority_queue_erase(&taskScheduler, &m_task);
+    return;
+  }
+
+  // Wake up for the next non-empty slot, or when the lowest level
+  // wraps around and the level above needs to be cascaded.
+  uint64_t next = m_wheelTime;
+
+  while ((next & wheel_mask) != 0 && m_wheel[0][next & wheel_mask].empty())
+    next++;
+
+  if (m_task.is_queued() && m_taskTime == next)
+    return;
+
+  priority_queue_erase(&taskScheduler, &m_task);
+  priority_queue_insert(
+    &taskScheduler, &m_task, torrent::utils::timer::from_seconds(next));
+
+  m_taskTime = next;
 }
 
 void
@@ -58,22 +202,27 @@ CommandScheduler::call_item(value_type item) {
     throw torrent::internal_error(
       "CommandScheduler::call_item(...) called but item is still queued.");
 
-  if (std::find(begin(), end(), item) == end())
-    throw torrent::internal_error("CommandScheduler::call_item(...) called but "
-                                  "the item isn't in the scheduler.");
-
-  // Remove the item before calling the command if it should be
-  // removed.
+  m_calling = item;
 
   try {
     rpc::call_object(item->command());
 
   } catch (torrent::input_error& e) {
-    if (m_slotErrorMessage != nullptr)
+    if (m_slotErrorMessage != nullptr && m_calling == item)
       m_slotErrorMessage("Scheduled command failed: " + item->key() + ": " +
                          e.what());
   }
 
+  // The command erased or replaced its own schedule.
+  if (m_calling != item)
+    return;
+
+  m_calling = nullptr;
+
+  // Rescheduled by the command itself.
+  if (item->is_queued())
+    return;
+
   // Still schedule if we caught a torrrent::input_error?
   torrent::utils::timer next = item->next_time_scheduled();
 
@@ -86,7 +235,7 @@ CommandScheduler::call_item(value_type item) {
     throw torrent::internal_error("CommandScheduler::call_item(...) tried to "
                                   "schedule a zero interval item.");
 
-  item->enable(next);
+  enable(item, next);
 }
 
 void
@@ -100,13 +249,14 @@ CommandScheduler::parse(const std::string&     key,
   uint32_t absolute = parse_absolute(bufAbsolute.c_str());
   uint32_t interval = parse_interval(bufInterval.c_str());
 
-  CommandSchedulerItem* item = *insert(key);
+  CommandSchedulerItem* item = insert(key)->second;
 
   item->command() = command;
   item->set_interval(interval);
 
-  item->enable((cachedTime + torrent::utils::timer::from_seconds(absolute))
-                 .round_seconds());
+  enable(item,
+         (cachedTime + torrent::utils::timer::from_seconds(absolute))
+           .round_seconds());
 }
 
 uint32_t
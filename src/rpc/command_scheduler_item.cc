@@ -7,32 +7,6 @@
 
 namespace rpc {
 
-CommandSchedulerItem::~CommandSchedulerItem() {
-  priority_queue_erase(&taskScheduler, &m_task);
-}
-
-void
-CommandSchedulerItem::enable(torrent::utils::timer t) {
-  if (t == torrent::utils::timer())
-    throw torrent::internal_error(
-      "CommandSchedulerItem::enable() t == torrent::utils::timer().");
-
-  if (is_queued())
-    disable();
-
-  // If 'first' is zero then we execute the task
-  // immediately. ''interval()'' will not return zero so we never end
-  // up in an infinit loop.
-  m_timeScheduled = t;
-  priority_queue_insert(&taskScheduler, &m_task, t);
-}
-
-void
-CommandSchedulerItem::disable() {
-  m_timeScheduled = torrent::utils::timer();
-  priority_queue_erase(&taskScheduler, &m_task);
-}
-
 torrent::utils::timer
 CommandSchedulerItem::next_time_scheduled() const {
   if (m_interval == 0)
@@ -43,14 +17,15 @@ CommandSchedulerItem::next_time_scheduled() const {
       "CommandSchedulerItem::next_time_scheduled() m_timeScheduled == "
       "torrent::utils::timer().");
 
-  torrent::utils::timer next = m_timeScheduled;
+  torrent::utils::timer now   = cachedTime.round_seconds();
+  uint64_t              count = 1;
 
-  // This should be done in a non-looping manner.
-  do {
-    next += torrent::utils::timer::from_seconds(m_interval);
-  } while (next <= cachedTime.round_seconds());
+  // Skip the intervals we missed without looping over each of them.
+  if (m_timeScheduled <= now)
+    count += (now - m_timeScheduled).seconds() / m_interval;
 
-  return next;
+  return m_timeScheduled +
+         torrent::utils::timer::from_seconds(count * m_interval);
 }
 
 }
@@ -9,6 +9,7 @@
 
 #include <torrent/utils/error_number.h>
 #include <torrent/utils/path.h>
+#include <torrent/utils/timer.h>
 
 #include "thread_base.h"
 
@@ -27,6 +28,16 @@ const int ExecFile::flag_background;
 
 // Close m_logFd.
 
+static size_t
+argument_count(char* const* argv) {
+  size_t count = 0;
+
+  while (argv[count] != nullptr)
+    count++;
+
+  return count;
+}
+
 int
 ExecFile::execute(const char* file, char* const* argv, int flags) {
   ssize_t __attribute__((unused)) result;
@@ -47,10 +58,57 @@ ExecFile::execute(const char* file, char* const* argv, int flags) {
 
   int pipeFd[2];
 
+  if (m_spawner.is_open() && (flags & flag_background)) {
+    m_spawner.execute_async(
+      ProcessSpawner::argument_list(argv, argv + argument_count(argv)));
+
+    if (m_logFd != -1)
+      result = write(m_logFd,
+                     "\n--- Background task ---\n",
+                     sizeof("\n--- Background task ---\n"));
+
+    return 0;
+  }
+
   if ((flags & flag_capture) && pipe(pipeFd))
     throw torrent::input_error("ExecFile::execute(...) Pipe creation failed.");
 
-  pid_t childPid = fork();
+  if (m_spawner.is_open()) {
+    int replyFd;
+
+    try {
+      replyFd = m_spawner.spawn(argv, (flags & flag_capture) ? pipeFd[1] : -1);
+    } catch (torrent::input_error&) {
+      if (flags & flag_capture) {
+        ::close(pipeFd[0]);
+        ::close(pipeFd[1]);
+      }
+
+      throw;
+    }
+
+    ThreadBase::release_global_lock();
+
+    if (flags & flag_capture)
+      read_capture(pipeFd);
+
+    int      status;
+    uint64_t elapsedUsec;
+    bool     exited = m_spawner.wait(replyFd, &status, &elapsedUsec);
+
+    ThreadBase::acquire_global_lock();
+
+    if (!exited)
+      throw torrent::input_error(
+        "ExecFile::execute(...) Process spawner failed.");
+
+    m_spawner.record(file, status, elapsedUsec);
+    log_status(status);
+    return status;
+  }
+
+  torrent::utils::timer start    = torrent::utils::timer::current();
+  pid_t                 childPid = fork();
 
   if (childPid == -1)
     throw torrent::input_error("ExecFile::execute(...) Fork failed.");
@@ -108,28 +166,8 @@ ExecFile::execute(const char* file, char* const* argv, int flags) {
   // finish so that XMLRPC and other threads can continue working.
   ThreadBase::release_global_lock();
 
-  if (flags & flag_capture) {
-    m_capture = std::string();
-    ::close(pipeFd[1]);
-
-    char    buffer[4096];
-    ssize_t length;
-
-    do {
-      length = read(pipeFd[0], buffer, sizeof(buffer));
-
-      if (length > 0)
-        m_capture += std::string(buffer, length);
-    } while (length > 0);
-
-    ::close(pipeFd[0]);
-
-    if (m_logFd != -1) {
-      result =
-        write(m_logFd, "Captured output:\n", sizeof("Captured output:\n"));
-      result = write(m_logFd, m_capture.data(), m_capture.length());
-    }
-  }
+  if (flags & flag_capture)
+    read_capture(pipeFd);
 
   int status;
   int wpid;
@@ -144,16 +182,50 @@ ExecFile::execute(const char* file, char* const* argv, int flags) {
   if (wpid != childPid)
     throw torrent::internal_error("ExecFile::execute(...) waitpid failed.");
 
-  // Check return value?
+  m_spawner.record(
+    file, status, (torrent::utils::timer::current() - start).usec());
+  log_status(status);
+  return status;
+}
+
+void
+ExecFile::read_capture(int* pipeFd) {
+  m_capture = std::string();
+  ::close(pipeFd[1]);
+
+  char    buffer[4096];
+  ssize_t length;
+
+  do {
+    length = read(pipeFd[0], buffer, sizeof(buffer));
+
+    if (length > 0)
+      m_capture += std::string(buffer, length);
+  } while (length > 0);
+
+  ::close(pipeFd[0]);
+
   if (m_logFd != -1) {
-    if (status == 0)
-      result =
-        write(m_logFd, "\n--- Success ---\n", sizeof("\n--- Success ---\n"));
-    else
-      result = write(m_logFd, "\n--- Error ---\n", sizeof("\n--- Error ---\n"));
+    ssize_t __attribute__((unused)) result;
+
+    result = write(m_logFd, "Captured output:\n", sizeof("Captured output:\n"));
+    result = write(m_logFd, m_capture.data(), m_capture.length());
   }
+}
 
-  return status;
+void
+ExecFile::log_status(int status) {
+  if (m_logFd == -1)
+    return;
+
+  ssize_t __attribute__((unused)) result;
+
+  // Check return value?
+  if (status == 0)
+    result =
+      write(m_logFd, "\n--- Success ---\n", sizeof("\n--- Success ---\n"));
+  else
+    result = write(m_logFd, "\n--- Error ---\n", sizeof("\n--- Error ---\n"));
 }
 
 torrent::Object
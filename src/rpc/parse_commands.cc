@@ -12,9 +12,10 @@
 
 namespace rpc {
 
-CommandMap commands;
-RpcManager rpc;
-ExecFile   execFile;
+CommandMap      commands;
+RpcManager      rpc;
+ExecFile        execFile;
+CommandProfiler profiler;
 
 struct command_map_is_space {
   bool operator()(char c) const {
@@ -0,0 +1,576 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <torrent/exceptions.h>
+#include <torrent/poll.h>
+#include <torrent/utils/log.h>
+#include <torrent/utils/thread_base.h>
+#include <torrent/utils/timer.h>
+
+#include "rpc/process_spawner.h"
+#include "utils/trace_ring.h"
+
+namespace rpc {
+
+namespace {
+
+constexpr uint32_t request_capture    = 0x1;
+constexpr uint32_t request_log        = 0x2;
+constexpr uint32_t request_reply      = 0x4;
+constexpr uint32_t request_background = 0x8;
+constexpr int      request_max_fds    = 3;
+
+// Followed by the nul terminated working directory, empty if unknown,
+// and 'argc' nul terminated arguments. The descriptors flagged are
+// passed along in the order of the flag bits.
+struct request_header {
+  uint64_t id;
+  uint32_t flags;
+  uint32_t argc;
+  uint32_t umask;
+  uint32_t unused;
+};
+
+struct reply_type {
+  uint64_t id;
+  int64_t  status;
+  uint64_t elapsed_usec;
+};
+
+struct helper_child {
+  uint64_t              id;
+  int                   replyFd;
+  torrent::utils::timer start;
+};
+
+int helper_signal_fd = -1;
+
+void
+helper_sigchld(int) {
+  int     savedErrno = errno;
+  char    c          = 0;
+  ssize_t __attribute__((unused)) result = write(helper_signal_fd, &c, 1);
+  errno = savedErrno;
+}
+
+bool
+write_reply(int fd, const reply_type& reply, bool socket) {
+  ssize_t result;
+
+  do {
+    result = socket ? send(fd, &reply, sizeof(reply), MSG_NOSIGNAL)
+                    : write(fd, &reply, sizeof(reply));
+  } while (result == -1 && errno == EINTR);
+
+  return result == sizeof(reply);
+}
+
+void
+helper_spawn(int sock, std::map<pid_t, helper_child>* children) {
+  static char buffer[ProcessSpawner::max_request_size + 1];
+  char        control[CMSG_SPACE(request_max_fds * sizeof(int))];
+
+  iovec  iov{ buffer, ProcessSpawner::max_request_size };
+  msghdr msg{};
+
+  msg.msg_iov        = &iov;
+  msg.msg_iovlen     = 1;
+  msg.msg_control    = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t length = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+
+  if (length == -1 && errno == EINTR)
+    return;
+
+  if (length <= 0)
+    _exit(0);
+
+  int fds[request_max_fds];
+  int fdCount = 0;
+
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg          = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+
+    int count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+    for (int i = 0; i != count && fdCount != request_max_fds; i++)
+      std::memcpy(
+        &fds[fdCount++], CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+  }
+
+  request_header header;
+
+  if ((size_t)length < sizeof(header))
+    _exit(1);
+
+  std::memcpy(&header, buffer, sizeof(header));
+  buffer[length] = '\0';
+
+  int   fdIndex   = 0;
+  int   captureFd = header.flags & request_capture ? fds[fdIndex++] : -1;
+  int   logFd     = header.flags & request_log ? fds[fdIndex++] : -1;
+  int   replyFd   = header.flags & request_reply ? fds[fdIndex++] : -1;
+  char* cwd       = buffer + sizeof(header);
+  auto  argv      = std::vector<char*>();
+
+  if (fdIndex != fdCount)
+    _exit(1);
+
+  for (char *itr = cwd + std::strlen(cwd) + 1, *last = buffer + length;
+       itr < last && argv.size() != header.argc;
+       itr += std::strlen(itr) + 1)
+    argv.push_back(itr);
+
+  argv.push_back(nullptr);
+
+  torrent::utils::timer start = torrent::utils::timer::current();
+  pid_t                 pid   = argv.size() > 1 ? fork() : -1;
+
+  if (pid == 0) {
+    int devNull = open("/dev/null", O_RDWR | O_CLOEXEC);
+
+    dup2(devNull, 0);
+    dup2(captureFd != -1 ? captureFd : logFd != -1 ? logFd : devNull, 1);
+    dup2(logFd != -1 ? logFd : devNull, 2);
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGHUP, SIG_DFL);
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGPIPE, SIG_DFL);
+
+    // The client's, which may have changed since the helper was forked.
+    umask(header.umask);
+
+    if (*cwd != '\0' && chdir(cwd) != 0)
+      _exit(-1);
+
+    // Background commands shouldn't get signals meant for the client's
+    // process group or terminal.
+    if (header.flags & request_background)
+      setsid();
+
+    _exit(execvp(argv[0], argv.data()));
+  }
+
+  if (captureFd != -1)
+    ::close(captureFd);
+
+  if (logFd != -1)
+    ::close(logFd);
+
+  if (pid == -1) {
+    reply_type reply{ header.id, -1, 0 };
+
+    if (replyFd != -1) {
+      write_reply(replyFd, reply, false);
+      ::close(replyFd);
+    } else {
+      write_reply(sock, reply, true);
+    }
+
+    return;
+  }
+
+  (*children)[pid] = helper_child{ header.id, replyFd, start };
+}
+
+void
+helper_reap(int sock, std::map<pid_t, helper_child>* children) {
+  int   status;
+  pid_t pid;
+
+  while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+    auto itr = children->find(pid);
+
+    if (itr == children->end())
+      continue;
+
+    reply_type reply{
+      itr->second.id,
+      status,
+      (uint64_t)(torrent::utils::timer::current() - itr->second.start).usec()
+    };
+
+    if (itr->second.replyFd != -1) {
+      write_reply(itr->second.replyFd, reply, false);
+      ::close(itr->second.replyFd);
+    } else {
+      write_reply(sock, reply, true);
+    }
+
+    children->erase(itr);
+  }
+}
+
+[[noreturn]] void
+helper_main(int sock) {
+  // The helper goes away when the client closes its end of the socket,
+  // not on signals sent to the whole process group.
+  signal(SIGINT, SIG_IGN);
+  signal(SIGHUP, SIG_IGN);
+  signal(SIGPIPE, SIG_IGN);
+
+  for (int i = 0, last = sysconf(_SC_OPEN_MAX); i != last; i++)
+    if (i != sock)
+      ::close(i);
+
+  // Keep the standard descriptors taken so that received ones never
+  // end up there.
+  for (int i = 0; i != 3; i++)
+    open("/dev/null", O_RDWR);
+
+  int signalPipe[2];
+
+  if (pipe2(signalPipe, O_CLOEXEC | O_NONBLOCK) == -1)
+    _exit(1);
+
+  helper_signal_fd = signalPipe[1];
+
+  struct sigaction sa {};
+  sa.sa_handler = &helper_sigchld;
+  sa.sa_flags   = SA_RESTART | SA_NOCLDSTOP;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGCHLD, &sa, nullptr);
+
+  std::map<pid_t, helper_child> children;
+
+  while (true) {
+    pollfd fds[2] = { { sock, POLLIN, 0 }, { signalPipe[0], POLLIN, 0 } };
+
+    if (poll(fds, 2, -1) == -1) {
+      if (errno == EINTR)
+        continue;
+
+      _exit(1);
+    }
+
+    if (fds[1].revents & POLLIN) {
+      char drain[64];
+
+      while (read(signalPipe[0], drain, sizeof(drain)) > 0)
+        ;
+    }
+
+    helper_reap(sock, &children);
+
+    if (fds[0].revents & POLLIN)
+      helper_spawn(sock, &children);
+    else if (fds[0].revents & (POLLHUP | POLLERR))
+      _exit(0);
+  }
+}
+
+}
+
+ProcessSpawner::~ProcessSpawner() {
+  close();
+}
+
+void
+ProcessSpawner::open() {
+  if (is_open())
+    throw torrent::internal_error("ProcessSpawner::open() already open.");
+
+  int sv[2];
+
+  // Failing here only means commands are forked from the client as
+  // before.
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) == -1)
+    return;
+
+  pid_t pid = fork();
+
+  if (pid == -1) {
+    ::close(sv[0]);
+    ::close(sv[1]);
+    return;
+  }
+
+  if (pid == 0) {
+    ::close(sv[0]);
+    helper_main(sv[1]);
+  }
+
+  ::close(sv[1]);
+
+  m_fileDesc  = sv[0];
+  m_helperPid = pid;
+
+  // Still single threaded, so briefly changing the umask is safe.
+  m_umask = ::umask(0);
+  ::umask(m_umask);
+}
+
+void
+ProcessSpawner::close() {
+  if (!is_open())
+    return;
+
+  ::close(m_fileDesc);
+  m_fileDesc = -1;
+
+  // Usually still running at this point, in which case it is left for
+  // init to reap once the client exits.
+  waitpid(m_helperPid, nullptr, WNOHANG);
+  m_helperPid = -1;
+
+  m_running.clear();
+  m_queue.clear();
+}
+
+void
+ProcessSpawner::activate() {
+  if (!is_open())
+    return;
+
+  torrent::main_thread()->poll()->open(this);
+  torrent::main_thread()->poll()->insert_read(this);
+  torrent::main_thread()->poll()->insert_error(this);
+}
+
+void
+ProcessSpawner::deactivate() {
+  if (!is_open())
+    return;
+
+  torrent::main_thread()->poll()->remove_read(this);
+  torrent::main_thread()->poll()->remove_error(this);
+  torrent::main_thread()->poll()->close(this);
+}
+
+void
+ProcessSpawner::set_max_running(uint32_t v) {
+  if (v == 0)
+    throw torrent::input_error("Must allow at least one running command.");
+
+  m_maxRunning = v;
+  start_queued();
+}
+
+uint64_t
+ProcessSpawner::send(char* const* argv, int captureFd, int replyFd) {
+  bool           background = replyFd == -1;
+  std::string    buffer(sizeof(request_header), '\0');
+  request_header header{
+    background ? ++m_lastId : 0, 0, 0, (uint32_t)m_umask, 0
+  };
+
+  if (background)
+    header.flags |= request_background;
+
+  char* cwd = getcwd(nullptr, 0);
+
+  if (cwd != nullptr) {
+    buffer.append(cwd);
+    std::free(cwd);
+  }
+
+  buffer.push_back('\0');
+
+  for (char* const* itr = argv; *itr != nullptr; itr++, header.argc++)
+    buffer.append(*itr, std::strlen(*itr) + 1);
+
+  if (buffer.size() > max_request_size)
+    throw torrent::input_error("Command line too long.");
+
+  int fds[request_max_fds];
+  int fdCount = 0;
+
+  // Background commands write to /dev/null rather than the log.
+  for (auto fd : { std::make_pair(request_capture, captureFd),
+                   std::make_pair(request_log, background ? -1 : m_logFd),
+                   std::make_pair(request_reply, replyFd) }) {
+    if (fd.second == -1)
+      continue;
+
+    header.flags |= fd.first;
+    fds[fdCount++] = fd.second;
+  }
+
+  std::memcpy(&buffer[0], &header, sizeof(header));
+
+  char   control[CMSG_SPACE(request_max_fds * sizeof(int))] = {};
+  iovec  iov{ &buffer[0], buffer.size() };
+  msghdr msg{};
+
+  msg.msg_iov    = &iov;
+  msg.msg_iovlen = 1;
+
+  if (fdCount != 0) {
+    msg.msg_control    = control;
+    msg.msg_controllen = CMSG_SPACE(fdCount * sizeof(int));
+
+    cmsghdr* cmsg    = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(fdCount * sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), fds, fdCount * sizeof(int));
+  }
+
+  ssize_t result;
+
+  do {
+    result = sendmsg(m_fileDesc, &msg, MSG_NOSIGNAL);
+  } while (result == -1 && errno == EINTR);
+
+  if (result != (ssize_t)buffer.size())
+    throw torrent::input_error("Could not pass command to process spawner.");
+
+  return header.id;
+}
+
+int
+ProcessSpawner::spawn(char* const* argv, int captureFd) {
+  int replyPipe[2];
+
+  if (pipe2(replyPipe, O_CLOEXEC) == -1)
+    throw torrent::input_error("ProcessSpawner::spawn(...) Pipe failed.");
+
+  try {
+    send(argv, captureFd, replyPipe[1]);
+  } catch (torrent::input_error&) {
+    ::close(replyPipe[0]);
+    ::close(replyPipe[1]);
+    throw;
+  }
+
+  ::close(replyPipe[1]);
+  return replyPipe[0];
+}
+
+bool
+ProcessSpawner::wait(int replyFd, int* status, uint64_t* elapsedUsec) {
+  reply_type reply;
+  size_t     received = 0;
+
+  while (received != sizeof(reply)) {
+    ssize_t result = read(replyFd,
+                          reinterpret_cast<char*>(&reply) + received,
+                          sizeof(reply) - received);
+
+    if (result == -1 && errno == EINTR)
+      continue;
+
+    if (result <= 0)
+      break;
+
+    received += result;
+  }
+
+  ::close(replyFd);
+
+  if (received != sizeof(reply))
+    return false;
+
+  *status      = reply.status;
+  *elapsedUsec = reply.elapsed_usec;
+  return true;
+}
+
+void
+ProcessSpawner::execute_async(argument_list args) {
+  if (args.empty())
+    throw torrent::input_error("Too few arguments.");
+
+  m_queue.push_back(std::move(args));
+  start_queued();
+}
+
+void
+ProcessSpawner::start_queued() {
+  while (is_open() && !m_queue.empty() && m_running.size() < m_maxRunning) {
+    argument_list      args = std::move(m_queue.front());
+    std::vector<char*> argv;
+
+    m_queue.pop_front();
+
+    for (auto& arg : args)
+      argv.push_back(&arg[0]);
+
+    argv.push_back(nullptr);
+
+    try {
+      m_running[send(argv.data(), -1, -1)] = args.front();
+
+    } catch (torrent::input_error& e) {
+      lt_log_print(torrent::LOG_ERROR,
+                   "Could not start command '%s': %s",
+                   args.front().c_str(),
+                   e.what());
+    }
+  }
+}
+
+void
+ProcessSpawner::record(const std::string& name,
+                       int                status,
+                       uint64_t           elapsedUsec) {
+  stats_type& stats = m_stats[name];
+
+  stats.count++;
+  stats.failed += status != 0;
+  stats.total_usec += elapsedUsec;
+  stats.max_usec = std::max(stats.max_usec, elapsedUsec);
+
+  utils::trace(utils::TRACE_EXECUTE, status, elapsedUsec);
+}
+
+void
+ProcessSpawner::event_read() {
+  reply_type reply;
+  ssize_t    result;
+
+  while ((result = recv(m_fileDesc, &reply, sizeof(reply), MSG_DONTWAIT)) ==
+         sizeof(reply)) {
+    auto itr = m_running.find(reply.id);
+
+    if (itr == m_running.end())
+      continue;
+
+    if (reply.status != 0)
+      lt_log_print(torrent::LOG_NOTICE,
+                   "Command '%s' exited with status %" PRIi64 ".",
+                   itr->second.c_str(),
+                   reply.status);
+
+    record(itr->second, reply.status, reply.elapsed_usec);
+    m_running.erase(itr);
+  }
+
+  if (result == 0 || (result == -1 && errno != EAGAIN && errno != EINTR)) {
+    lt_log_print(torrent::LOG_ERROR,
+                 "Process spawner exited, commands are now forked directly.");
+
+    deactivate();
+    close();
+    return;
+  }
+
+  start_queued();
+}
+
+void
+ProcessSpawner::event_write() {}
+
+void
+ProcessSpawner::event_error() {
+  event_read();
+}
+
+}
@@ -18,6 +18,7 @@
 #include <torrent/common.h>
 #include <torrent/hash_string.h>
 #include <torrent/torrent.h>
+#include <torrent/utils/timer.h>
 
 #include "rpc/command.h"
 #include "rpc/command_map.h"
@@ -239,13 +240,11 @@ jsonrpc_call_command(const std::string& method, const json& params) {
     throw JsonRpcException(-32601, "method not found: " + method);
   }
 
+  // Called from the main thread, see SCgi::receive_call.
   try {
     torrent::Object  object;
     rpc::target_type target = rpc::make_target();
 
-    torrent::thread_base::acquire_global_lock();
-    torrent::main_thread()->interrupt();
-
     if (itr->second.m_flags & CommandMap::flag_no_target) {
       json_to_object(params, command_base::target_generic, &target)
         .swap(object);
@@ -260,13 +259,10 @@ jsonrpc_call_command(const std::string& method, const json& params) {
 
     const auto& result = rpc::commands.call_command(itr, object, target);
 
-    torrent::thread_base::release_global_lock();
     return object_to_json(result);
   } catch (torrent::input_error& e) {
-    torrent::thread_base::release_global_lock();
     throw JsonRpcException(-32602, e.what());
   } catch (torrent::local_error& e) {
-    torrent::thread_base::release_global_lock();
     throw JsonRpcException(-32000, e.what());
   }
 }
@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
 
+#include <string>
 #include <sys/stat.h>
 #include <sys/un.h>
+#include <utility>
 
 #include <torrent/connection_manager.h>
 #include <torrent/exceptions.h>
@@ -10,10 +12,12 @@
 #include <torrent/torrent.h>
 #include <torrent/utils/error_number.h>
 #include <torrent/utils/socket_address.h>
+#include <torrent/utils/timer.h>
 
 #include "control.h"
 #include "globals.h"
 #include "rpc/parse_commands.h"
+#include "thread_queue.h"
 #include "utils/socket_fd.h"
 
 #include "rpc/scgi.h"
@@ -147,27 +151,68 @@ SCgi::event_error() {
   throw torrent::internal_error("SCGI listener port received an error event.");
 }
 
+// Called from the main thread's queue, the reply is handed back to the
+// worker thread as the task's socket belongs to its poll. The task
+// may have been closed, and even reopened by another connection,
+// while the request was queued.
+static void
+process_call(SCgiTask*             task,
+             uint64_t              generation,
+             SCgiTask::ContentType type,
+             const std::string&    request,
+             int64_t               queued) {
+  std::string reply;
+  int64_t     start = torrent::utils::timer::current_usec();
+
+  bool result = rpc.dispatch(type == SCgiTask::ContentType::JSON
+                               ? RpcManager::RPCType::JSON
+                               : RpcManager::RPCType::XML,
+                             request.c_str(),
+                             request.size(),
+                             [&reply](const char* buffer, uint32_t length) {
+                               reply.assign(buffer, length);
+                               return true;
+                             });
+
+  if (profiler.is_enabled()) {
+    int64_t done = torrent::utils::timer::current_usec();
+
+    profiler.insert_rpc_lock(start - queued, done - start);
+    profiler.insert_rpc_request(done - queued);
+  }
+
+  worker_thread->queue_item(
+    [task, generation, result, reply = std::move(reply)](ThreadBase*) {
+      if (!task->is_open() || task->generation() != generation)
+        return;
+
+      if (result)
+        task->receive_write(reply.c_str(), reply.size());
+      else
+        task->close();
+    });
+}
+
+// Requests are handed to the main thread through its queue rather than
+// taking the global lock here. There are at most 'max_tasks' requests
+// in flight, well below the size of the queue.
 bool
 SCgi::receive_call(SCgiTask* task, const char* buffer, uint32_t length) {
-  bool       result   = false;
-  const auto callback = [task](const char* buffer, uint32_t length) {
-    return task->receive_write(buffer, length);
-  };
-
-  switch (task->type()) {
-    case SCgiTask::ContentType::JSON:
-      result =
-        rpc.dispatch(RpcManager::RPCType::JSON, buffer, length, callback);
-      break;
-    case SCgiTask::ContentType::XML:
-    default:
-      torrent::thread_base::acquire_global_lock();
-      torrent::main_thread()->interrupt();
-      result = rpc.dispatch(RpcManager::RPCType::XML, buffer, length, callback);
-      torrent::thread_base::release_global_lock();
-  }
+  ThreadQueue* mainQueue = control->main_queue();
+
+  // Shutting down, drop the connection.
+  if (!mainQueue->is_attached())
+    return false;
+
+  mainQueue->push_back([task,
+                        generation = task->generation(),
+                        type       = task->type(),
+                        request    = std::string(buffer, length),
+                        queued     = torrent::utils::timer::current_usec()] {
+    process_call(task, generation, type, request, queued);
+  });
 
-  return result;
+  return true;
 }
 
 }
@@ -14,6 +14,7 @@
 #include "control.h"
 #include "globals.h"
 #include "utils/socket_fd.h"
+#include "utils/trace_ring.h"
 
 #include "rpc/scgi.h"
 
@@ -43,6 +44,7 @@ void
 SCgiTask::open(SCgi* parent, int fd) {
   m_parent   = parent;
   m_fileDesc = fd;
+  m_generation++;
   m_buffer   = torrent::utils::cacheline_allocator<char>::alloc_size(
     (m_bufferSize = default_buffer_size) + 1);
   m_position = m_buffer;
@@ -186,8 +188,13 @@ SCgiTask::event_read() {
   if ((unsigned int)std::distance(m_buffer, m_position) != m_bufferSize)
     return;
 
+  // Only wait for writing once the reply is ready, see receive_write.
   worker_thread->poll()->remove_read(this);
-  worker_thread->poll()->insert_write(this);
+
+  utils::trace(utils::TRACE_RPC_READ,
+               m_fileDesc,
+               m_bufferSize - std::distance(m_buffer, m_body),
+               (int64_t)m_type);
 
   if (m_parent->log_fd() >= 0) {
     ssize_t __attribute__((unused)) result;
@@ -278,6 +285,10 @@ SCgiTask::receive_write(const char* buffer, uint32_t length) {
   lt_log_print_dump(
     torrent::LOG_RPC_DUMP, m_buffer, m_bufferSize, "scgi", "RPC write.", 0);
 
+  utils::trace(utils::TRACE_RPC_WRITE, m_fileDesc, length);
+
+  worker_thread->poll()->insert_write(this);
+
   event_write();
   return true;
 }
@@ -3,6 +3,7 @@
 
 #include "thread_base.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
@@ -10,80 +11,13 @@
 #include <signal.h>
 #include <torrent/exceptions.h>
 #include <torrent/torrent.h>
-#include <torrent/utils/cacheline.h>
-#include <torrent/utils/error_number.h>
 #include <torrent/utils/log.h>
 #include <unistd.h>
 
 #include "control.h"
 #include "core/manager.h"
 #include "globals.h"
-
-class lt_cacheline_aligned thread_queue_hack {
-public:
-  using value_type = ThreadBase::thread_base_func;
-  using iterator   = ThreadBase::thread_base_func*;
-
-  static constexpr unsigned int max_size = 32;
-
-  thread_queue_hack() {
-    std::memset(this, 0, sizeof(thread_queue_hack));
-  }
-
-  void lock() {
-    while (!__sync_bool_compare_and_swap(&m_lock, 0, 1))
-      usleep(0);
-  }
-  void unlock() {
-    __sync_bool_compare_and_swap(&m_lock, 1, 0);
-  }
-
-  iterator begin() {
-    return m_queue;
-  }
-  iterator max_capacity() {
-    return m_queue + max_size;
-  }
-
-  iterator end_and_lock() {
-    lock();
-    return std::find(begin(), max_capacity(), (value_type) nullptr);
-  }
-
-  bool empty() const {
-    return m_queue[0] == nullptr;
-  }
-
-  void push_back(value_type v) {
-    iterator itr = end_and_lock();
-
-    if (itr == max_capacity())
-      throw torrent::internal_error("Overflowed thread_queue.");
-
-    __sync_bool_compare_and_swap(itr, nullptr, v);
-    unlock();
-  }
-
-  value_type* copy_and_clear(value_type* dest) {
-    iterator itr = begin();
-    lock();
-
-    while (*itr != nullptr)
-      *dest++ = *itr++;
-
-    clear_and_unlock();
-    return dest;
-  }
-
-  void clear_and_unlock() {
-    std::memset(this, 0, sizeof(thread_queue_hack));
-    __sync_synchronize();
-  }
-
-private:
-  int        m_lock;
-  value_type m_queue[max_size + 1];
-};
+#include "thread_queue.h"
 
 void
 throw_shutdown_exception() {
@@ -93,7 +27,7 @@ throw_shutdown_exception() {
 ThreadBase::ThreadBase() {
   m_taskShutdown.slot() = [] { return throw_shutdown_exception(); };
 
-  m_threadQueue = new thread_queue_hack;
+  m_threadQueue = new ThreadQueue;
 }
 
 ThreadBase::~ThreadBase() {
@@ -119,14 +53,13 @@ ThreadBase::next_timeout_usec() {
 }
 
 void
-ThreadBase::call_queued_items() {
-  thread_base_func  result[thread_queue_hack::max_size];
-  thread_base_func* first = result;
-  thread_base_func* last =
-    m_threadQueue->copy_and_clear((thread_base_func*)result);
+ThreadBase::attach_queue() {
+  m_threadQueue->attach(m_poll);
+}
 
-  while (first != last && *first)
-    (*first++)(this);
+void
+ThreadBase::call_queued_items() {
+  m_threadQueue->call_all();
 }
 
 void
@@ -140,9 +73,11 @@ ThreadBase::call_events() {
 
 void
 ThreadBase::queue_item(thread_base_func newFunc) {
-  m_threadQueue->push_back(newFunc);
+  m_threadQueue->push_back(
+    [this, func = std::move(newFunc)]() { func(this); });
 
-  // Make it also restart inactive threads?
-  if (m_state == STATE_ACTIVE)
+  // Threads without a poll of their own yet only get to the queue
+  // when otherwise woken up.
+  if (!m_threadQueue->is_attached() && m_state == STATE_ACTIVE)
     interrupt();
 }
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
+
+#include <fcntl.h>
+#include <string>
+#include <torrent/exceptions.h>
+#include <torrent/poll.h>
+#include <torrent/utils/error_number.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#include "thread_queue.h"
+
+ThreadQueue::ThreadQueue() {
+#ifdef __linux__
+  m_fileDesc = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  m_writeFd  = m_fileDesc;
+#else
+  int fds[2];
+
+  if (pipe(fds) == 0) {
+    for (int fd : fds) {
+      fcntl(fd, F_SETFL, O_NONBLOCK);
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    m_fileDesc = fds[0];
+    m_writeFd  = fds[1];
+  }
+#endif
+
+  if (m_fileDesc == -1)
+    throw torrent::internal_error(
+      "Could not create thread queue wakeup descriptor: " +
+      std::string(torrent::utils::error_number::current().c_str()));
+}
+
+ThreadQueue::~ThreadQueue() {
+  detach();
+
+  if (m_writeFd != m_fileDesc)
+    ::close(m_writeFd);
+
+  ::close(m_fileDesc);
+}
+
+void
+ThreadQueue::attach(torrent::Poll* poll) {
+  if (is_attached())
+    throw torrent::internal_error("ThreadQueue::attach() already attached.");
+
+  poll->open(this);
+  poll->insert_read(this);
+  poll->insert_error(this);
+
+  m_poll.store(poll, std::memory_order_release);
+}
+
+void
+ThreadQueue::detach() {
+  torrent::Poll* poll = m_poll.exchange(nullptr);
+
+  if (poll == nullptr)
+    return;
+
+  poll->remove_read(this);
+  poll->remove_error(this);
+  poll->close(this);
+}
+
+void
+ThreadQueue::push_back(value_type v) {
+  if (!m_queue.push(std::move(v)))
+    throw torrent::internal_error("Overflowed thread_queue.");
+
+  // Pairs with the fence in 'call_all', so either the consumer sees
+  // the new item or we see the cleared flag and signal it.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (m_signaled.exchange(true))
+    return;
+
+  uint64_t value  = 1;
+  ssize_t  result = ::write(m_writeFd, &value, sizeof(value));
+  (void)result;
+}
+
+void
+ThreadQueue::call_all() {
+  m_signaled.store(false);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  value_type func;
+
+  while (m_queue.pop(func))
+    func();
+}
+
+void
+ThreadQueue::clear_signal() {
+  uint64_t buffer[16];
+
+  while (::read(m_fileDesc, buffer, sizeof(buffer)) > 0)
+    ;
+}
+
+// The flag must be cleared whenever the descriptor is, else later
+// pushes would skip the wakeup.
+void
+ThreadQueue::event_read() {
+  clear_signal();
+  call_all();
+}
+
+void
+ThreadQueue::event_error() {
+  throw torrent::internal_error("ThreadQueue::event_error() called.");
+}
@@ -24,6 +24,8 @@ void
 ThreadWorker::init_thread() {
   m_poll  = core::create_poll();
   m_state = STATE_INITIALIZED;
+
+  attach_queue();
 }
 
 bool
@@ -36,7 +38,7 @@ ThreadWorker::set_scgi(rpc::SCgi* scgi) {
 
   change_rpc_log();
 
-  queue_item((thread_base_func)&start_scgi);
+  queue_item(&start_scgi);
   return true;
 }
 
@@ -44,7 +46,7 @@ void
 ThreadWorker::set_rpc_log(const std::string& filename) {
   m_rpcLog = filename;
 
-  queue_item((thread_base_func)&msg_change_rpc_log);
+  queue_item(&msg_change_rpc_log);
 }
 
 void
@@ -14,6 +14,7 @@
 #include "core/download.h"
 #include "core/download_list.h"
 #include "core/manager.h"
+#include "core/search_index.h"
 #include "core/view.h"
 #include "core/view_manager.h"
 #include "display/window_log.h"
@@ -358,18 +359,15 @@ DownloadList::receive_exit_input(Input type) {
           current_view()->filter();
           current_view()->sort();
         } else {
-          std::string pattern = input->str();
-          if (pattern.back() != '$')
-            pattern = pattern + ".*";
-          if (pattern.front() != '^')
-            pattern = ".*" + pattern;
-          std::transform(
-            pattern.begin(), pattern.end(), pattern.begin(), ::tolower);
-          std::string temp_filter = "match={d.name=," + pattern + "}";
+          // Plain substrings are answered by the name index, anything
+          // else is matched as a regex against every name.
+          std::string temp_filter =
+            core::SearchIndex::filter_command(input->str());
+
           if (rpc::call_command_value("view.filter.temp.log"))
             control->core()->push_log_std("Temporary filter on '" +
                                           current_view()->name() +
-                                          "' view: " + pattern);
+                                          "' view: " + input->str());
           current_view()->set_filter_temp(temp_filter);
           current_view()->filter();
         }
@@ -1,10 +1,10 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright (C) 2005-2011, Jari Sundell <jaris@ifi.uio.no>
 
+#include <algorithm>
 #include <torrent/data/file.h>
 #include <torrent/data/file_list.h>
 #include <torrent/exceptions.h>
-#include <torrent/utils/algorithm.h>
 
 #include "display/frame.h"
 #include "display/manager.h"
@@ -28,7 +28,8 @@ ElementFileList::ElementFileList(core::Download* d)
   , m_elementInfo(nullptr)
   ,
 
-  m_selected(iterator(d->download()->file_list()->begin()))
+  m_index(d->download()->file_list())
+  , m_selected(iterator(d->download()->file_list()->begin()))
   , m_collapsed(false) {
 
   m_bindings[KEY_LEFT] =
@@ -162,64 +163,53 @@ ElementFileList::activate_display(Display display) {
 
 void
 ElementFileList::receive_next() {
-  torrent::FileList* fl = m_download->download()->file_list();
-
-  if (is_collapsed())
-    m_selected.forward_current_depth();
-  else
-    m_selected++;
+  if (m_index.empty())
+    return;
 
-  if (m_selected == iterator(fl->end()))
-    m_selected = iterator(fl->begin());
+  uint32_t row = m_index.next(m_selectedRow, is_collapsed());
 
+  set_selected_row(row == m_index.size() ? 0 : row);
   update_itr();
 }
 
 void
 ElementFileList::receive_prev() {
-  torrent::FileList* fl = m_download->download()->file_list();
-
-  if (m_selected == iterator(fl->begin()))
-    m_selected = iterator(fl->end());
+  if (m_index.empty())
+    return;
 
-  if (is_collapsed())
-    m_selected.backward_current_depth();
-  else
-    m_selected--;
+  uint32_t row = m_selectedRow == 0 ? m_index.size() : m_selectedRow;
 
+  set_selected_row(m_index.prev(row, is_collapsed()));
   update_itr();
 }
 
 void
 ElementFileList::receive_pagenext() {
-  torrent::FileList* fl = m_download->download()->file_list();
-
-  if (m_selected == --iterator(fl->end())) {
-    m_selected = iterator(fl->begin());
+  if (m_index.empty())
+    return;
 
-  } else {
-    m_selected = torrent::utils::advance_forward(
-      m_selected, iterator(fl->end()), (m_window->height() - 1) / 2);
+  uint32_t last = m_index.size() - 1;
 
-    if (m_selected == iterator(fl->end()))
-      m_selected = --iterator(fl->end());
-  }
+  if (m_selectedRow == last)
+    set_selected_row(0);
+  else
+    set_selected_row(
+      std::min(m_selectedRow + (m_window->height() - 1) / 2, last));
 
   update_itr();
 }
 
 void
 ElementFileList::receive_pageprev() {
-  if (m_window == nullptr)
+  if (m_window == nullptr || m_index.empty())
     return;
 
-  torrent::FileList* fl = m_download->download()->file_list();
+  uint32_t distance = (m_window->height() - 1) / 2;
 
-  if (m_selected == iterator(fl->begin()))
-    m_selected = --iterator(fl->end());
+  if (m_selectedRow == 0)
+    set_selected_row(m_index.size() - 1);
   else
-    m_selected = torrent::utils::advance_backward(
-      m_selected, iterator(fl->begin()), (m_window->height() - 1) / 2);
+    set_selected_row(m_selectedRow - std::min(m_selectedRow, distance));
 
   update_itr();
 }
@@ -230,10 +220,9 @@ ElementFileList::receive_select() {
     return;
 
   if (is_collapsed() && !m_selected.is_file()) {
-    torrent::FileList* fl = m_download->download()->file_list();
-    m_selected++;
-    if (m_selected == iterator(fl->end()))
-      m_selected = iterator(fl->begin());
+    uint32_t row = m_selectedRow + 1;
+
+    set_selected_row(row == m_index.size() ? 0 : row);
     m_window->mark_dirty();
   } else {
     activate_display(DISPLAY_INFO);
@@ -242,22 +231,17 @@ ElementFileList::receive_select() {
 
 void
 ElementFileList::receive_priority() {
-  if (m_window == nullptr)
+  if (m_window == nullptr || m_index.empty())
     return;
 
   torrent::priority_t priority =
     torrent::priority_t((m_selected.file()->priority() + 2) % 3);
 
-  iterator first = m_selected;
-  iterator last  = m_selected;
-  last.forward_current_depth();
-
-  while (first != last) {
-    if (first.is_file())
-      first.file()->set_priority(priority);
-
-    first++;
-  }
+  for (uint32_t row = m_selectedRow, last = m_index.forward(m_selectedRow);
+       row != last;
+       row++)
+    if (m_index.at(row).is_file())
+      m_index.at(row).file()->set_priority(priority);
 
   m_download->download()->update_priorities();
   update_itr();
@@ -265,7 +249,7 @@ ElementFileList::receive_priority() {
 
 void
 ElementFileList::receive_change_all() {
-  if (m_window == nullptr)
+  if (m_window == nullptr || m_index.empty())
     return;
 
   torrent::FileList*  fl = m_download->download()->file_list();
@@ -290,6 +274,12 @@ ElementFileList::receive_collapse() {
   m_window->mark_dirty();
 }
 
+void
+ElementFileList::set_selected_row(uint32_t row) {
+  m_selectedRow = row;
+  m_selected    = m_index.at(row);
+}
+
 void
 ElementFileList::update_itr() {
   m_window->mark_dirty();
@@ -24,11 +24,8 @@ ElementPeerList::ElementPeerList(core::Download* d)
   : m_download(d)
   , m_state(DISPLAY_MAX_SIZE) {
 
-  m_listItr = m_list.end();
-
-  for (const auto& peer : *m_download->download()->connection_list()) {
-    m_list.push_back(peer);
-  }
+  for (const auto& peer : *m_download->download()->connection_list())
+    m_peers.insert(peer);
 
   torrent::ConnectionList* connection_list =
     m_download->download()->connection_list();
@@ -40,7 +37,8 @@ ElementPeerList::ElementPeerList(core::Download* d)
     connection_list->signal_disconnected().end(),
     [this](const auto& peer) { receive_peer_disconnected(peer); });
 
-  m_windowList  = new display::WindowPeerList(m_download, &m_list, &m_listItr);
+  m_windowList =
+    new display::WindowPeerList(m_download, m_peers.list(), m_peers.focus());
   m_elementInfo = create_info();
 
   m_elementInfo->slot_exit([this] { activate_display(DISPLAY_LIST); });
@@ -176,71 +174,57 @@ ElementPeerList::activate_display(Display display) {
 
 void
 ElementPeerList::receive_next() {
-  if (m_listItr != m_list.end())
-    ++m_listItr;
-  else
-    m_listItr = m_list.begin();
-
+  m_peers.next();
   update_itr();
 }
 
 void
 ElementPeerList::receive_prev() {
-  if (m_listItr != m_list.begin())
-    --m_listItr;
-  else
-    m_listItr = m_list.end();
-
+  m_peers.prev();
   update_itr();
 }
 
 void
 ElementPeerList::receive_disconnect_peer() {
-  if (m_listItr == m_list.end())
+  if (m_peers.focused() == nullptr)
     return;
 
-  m_download->connection_list()->erase(*m_listItr, 0);
+  m_download->connection_list()->erase(m_peers.focused(), 0);
 }
 
 void
 ElementPeerList::receive_peer_connected(torrent::Peer* p) {
-  m_list.push_back(p);
+  m_peers.insert(p);
 }
 
 void
 ElementPeerList::receive_peer_disconnected(torrent::Peer* p) {
-  PList::iterator itr = std::find(m_list.begin(), m_list.end(), p);
-
-  if (itr == m_list.end())
-    throw torrent::internal_error(
-      "ElementPeerList::receive_peer_disconnected(...) itr == m_list.end().");
-
-  if (itr == m_listItr)
-    m_listItr = m_list.erase(itr);
-  else
-    m_list.erase(itr);
-
+  m_peers.erase(p);
   update_itr();
 }
 
 void
 ElementPeerList::receive_snub_peer() {
-  if (m_listItr == m_list.end())
+  torrent::Peer* peer = m_peers.focused();
+
+  if (peer == nullptr)
     return;
 
-  (*m_listItr)->set_snubbed(!(*m_listItr)->is_snubbed());
+  peer->set_snubbed(!peer->is_snubbed());
 
   update_itr();
 }
 
 void
 ElementPeerList::receive_ban_peer() {
-  if (m_listItr == m_list.end())
+  torrent::Peer* peer = m_peers.focused();
+
+  if (peer == nullptr)
     return;
 
-  (*m_listItr)->set_banned(true);
+  peer->set_banned(true);
   m_download->download()->connection_list()->erase(
-    *m_listItr, torrent::ConnectionList::disconnect_quick);
+    peer, torrent::ConnectionList::disconnect_quick);
 
   update_itr();
 }
@@ -248,8 +232,8 @@ ElementPeerList::receive_ban_peer() {
 void
 ElementPeerList::update_itr() {
   m_windowList->mark_dirty();
-  m_elementInfo->set_target(m_listItr != m_list.end()
-                              ? rpc::make_target(*m_listItr)
+  m_elementInfo->set_target(m_peers.focused() != nullptr
+                              ? rpc::make_target(m_peers.focused())
                               : rpc::make_target());
 }
 
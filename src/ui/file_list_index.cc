@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <torrent/data/file_list.h>
+
+#include "ui/file_list_index.h"
+
+namespace ui {
+
+FileListIndex::FileListIndex(torrent::FileList* fileList)
+  : basic_file_list_index(iterator(fileList->begin()),
+                          iterator(fileList->end())) {}
+
+}
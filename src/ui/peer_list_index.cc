@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <torrent/exceptions.h>
+
+#include "ui/peer_list_index.h"
+
+namespace ui {
+
+void
+PeerListIndex::insert(torrent::Peer* peer) {
+  m_positions[peer] = m_list.insert(m_list.end(), peer);
+}
+
+void
+PeerListIndex::erase(torrent::Peer* peer) {
+  auto position = m_positions.find(peer);
+
+  if (position == m_positions.end())
+    throw torrent::internal_error(
+      "ui::PeerListIndex::erase(...) peer not found.");
+
+  iterator itr = position->second;
+  m_positions.erase(position);
+
+  if (itr == m_focus)
+    m_focus = m_list.erase(itr);
+  else
+    m_list.erase(itr);
+}
+
+void
+PeerListIndex::next() {
+  if (m_focus != m_list.end())
+    ++m_focus;
+  else
+    m_focus = m_list.begin();
+}
+
+void
+PeerListIndex::prev() {
+  if (m_focus != m_list.begin())
+    --m_focus;
+  else
+    m_focus = m_list.end();
+}
+
+}
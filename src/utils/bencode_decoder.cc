@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <limits>
+
+#include <torrent/exceptions.h>
+#include <torrent/object.h>
+
+#include "utils/bencode_decoder.h"
+
+namespace utils {
+
+// Don't trust the length prefix of strings further than this when
+// reserving memory.
+static constexpr uint64_t bencode_reserve_max = 1 << 24;
+
+BencodeDecoder::BencodeDecoder(uint64_t maxSize)
+  : m_maxSize(maxSize)
+  , m_root(new torrent::Object)
+  , m_target(m_root) {}
+
+BencodeDecoder::~BencodeDecoder() {
+  delete m_root;
+}
+
+torrent::Object*
+BencodeDecoder::release() {
+  if (!is_done())
+    throw torrent::internal_error(
+      "BencodeDecoder::release() called before decoding was done.");
+
+  torrent::Object* result = m_root;
+  m_root                  = nullptr;
+
+  return result;
+}
+
+bool
+BencodeDecoder::write(const char* data, size_t length) {
+  if (m_state == state_error)
+    return false;
+
+  if (m_state == state_done)
+    return true;
+
+  m_size += length;
+
+  if (m_maxSize != 0 && m_size > m_maxSize)
+    return set_error("Torrent data exceeds the size limit.");
+
+  const char* last = data + length;
+
+  while (data != last) {
+    bool success;
+
+    switch (m_state) {
+      case state_string:
+        data += read_string(data, last - data);
+        continue;
+      case state_key:
+        data += read_key(data, last - data);
+        continue;
+      case state_done:
+        return true;
+
+      case state_value:
+        success = begin_value(*data++);
+        break;
+      case state_integer:
+        success = read_integer(*data++);
+        break;
+      case state_key_length:
+        success = begin_key(*data++);
+        break;
+      case state_string_length:
+        success = read_length(*data++);
+        break;
+      case state_error:
+      default:
+        return false;
+    }
+
+    if (!success)
+      return false;
+  }
+
+  return true;
+}
+
+bool
+BencodeDecoder::set_error(const char* msg) {
+  m_state = state_error;
+  m_error = msg;
+  return false;
+}
+
+bool
+BencodeDecoder::begin_value(char c) {
+  // A null target means we're waiting for the next list element.
+  if (m_target == nullptr) {
+    if (c == 'e')
+      return end_container();
+
+    torrent::Object::list_type& list = m_stack.back().object->as_list();
+
+    list.push_back(torrent::Object());
+    m_target = &list.back();
+  }
+
+  switch (c) {
+    case 'i':
+      m_integer   = 0;
+      m_negative  = false;
+      m_hasDigits = false;
+      m_state     = state_integer;
+      return true;
+
+    case 'l':
+    case 'd':
+      if (m_stack.size() >= max_depth)
+        return set_error("Bencode data is nested too deeply.");
+
+      *m_target = c == 'l' ? torrent::Object::create_list()
+                           : torrent::Object::create_map();
+
+      m_stack.push_back(frame_type{ m_target, std::string() });
+      m_target = nullptr;
+
+      if (c == 'l') {
+        m_state = state_value;
+      } else {
+        m_length    = 0;
+        m_hasDigits = false;
+        m_state     = state_key_length;
+      }
+
+      return true;
+
+    default:
+      if (c < '0' || c > '9')
+        return set_error("Invalid bencode data.");
+
+      m_length    = c - '0';
+      m_hasDigits = true;
+      m_state     = state_string_length;
+      return true;
+  }
+}
+
+bool
+BencodeDecoder::begin_key(char c) {
+  if (c == 'e' && !m_hasDigits)
+    return end_container();
+
+  return read_length(c);
+}
+
+bool
+BencodeDecoder::end_container() {
+  m_stack.pop_back();
+  end_value();
+  return true;
+}
+
+void
+BencodeDecoder::end_value() {
+  m_target = nullptr;
+
+  if (m_stack.empty()) {
+    m_state = state_done;
+  } else if (m_stack.back().object->is_list()) {
+    m_state = state_value;
+  } else {
+    m_length    = 0;
+    m_hasDigits = false;
+    m_state     = state_key_length;
+  }
+}
+
+bool
+BencodeDecoder::read_length(char c) {
+  if (c >= '0' && c <= '9') {
+    m_length    = m_length * 10 + (c - '0');
+    m_hasDigits = true;
+
+    // Check the length up front so oversized strings are rejected
+    // before we receive them.
+    if (m_maxSize != 0 && m_length > m_maxSize)
+      return set_error("Torrent data exceeds the size limit.");
+
+    if (m_length > std::numeric_limits<uint32_t>::max())
+      return set_error("Bencode string is too long.");
+
+    return true;
+  }
+
+  if (c != ':' || !m_hasDigits)
+    return set_error("Invalid bencode string length.");
+
+  if (m_state == state_key_length) {
+    m_key.clear();
+    m_state = state_key;
+
+    if (m_length == 0)
+      read_key(nullptr, 0);
+
+  } else {
+    *m_target = torrent::Object(std::string());
+    m_target->as_string().reserve(std::min(m_length, bencode_reserve_max));
+    m_state = state_string;
+
+    if (m_length == 0)
+      end_value();
+  }
+
+  return true;
+}
+
+bool
+BencodeDecoder::read_integer(char c) {
+  if (c == '-' && !m_hasDigits && !m_negative) {
+    m_negative = true;
+    return true;
+  }
+
+  if (c >= '0' && c <= '9') {
+    if (m_integer > (std::numeric_limits<int64_t>::max() - (c - '0')) / 10)
+      return set_error("Bencode integer is out of range.");
+
+    m_integer   = m_integer * 10 + (c - '0');
+    m_hasDigits = true;
+    return true;
+  }
+
+  if (c != 'e' || !m_hasDigits)
+    return set_error("Invalid bencode integer.");
+
+  *m_target = torrent::Object(m_negative ? -m_integer : m_integer);
+  end_value();
+  return true;
+}
+
+size_t
+BencodeDecoder::read_string(const char* data, size_t length) {
+  size_t count = std::min<uint64_t>(length, m_length);
+
+  m_target->as_string().append(data, count);
+  m_length -= count;
+
+  if (m_length == 0)
+    end_value();
+
+  return count;
+}
+
+size_t
+BencodeDecoder::read_key(const char* data, size_t length) {
+  size_t count = std::min<uint64_t>(length, m_length);
+
+  m_key.append(data, count);
+  m_length -= count;
+
+  if (m_length != 0)
+    return count;
+
+  // Keep track of dictionaries with unordered keys the same way as
+  // the libtorrent stream reader, as the info hash depends on it.
+  frame_type& frame = m_stack.back();
+
+  if (!frame.object->as_map().empty() && m_key <= frame.last_key)
+    frame.object->set_internal_flags(torrent::Object::flag_unordered);
+
+  m_target = &frame.object->insert_key(m_key, torrent::Object());
+  m_state  = state_value;
+
+  frame.last_key.swap(m_key);
+  return count;
+}
+
+}
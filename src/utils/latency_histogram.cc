@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "utils/latency_histogram.h"
+
+namespace utils {
+
+uint32_t
+LatencyHistogram::bucket_index(uint64_t value) {
+  if (value < sub_count)
+    return value;
+
+  uint32_t exponent = 63 - __builtin_clzll(value);
+
+  if (exponent > max_exponent)
+    return size - 1;
+
+  uint32_t sub = (value >> (exponent - sub_bits)) & (sub_count - 1);
+
+  return (exponent - sub_bits + 1) * sub_count + sub;
+}
+
+uint64_t
+LatencyHistogram::bucket_upper(uint32_t index) {
+  if (index < sub_count)
+    return index;
+
+  uint32_t exponent = index / sub_count + sub_bits - 1;
+  uint64_t sub      = index % sub_count;
+  uint64_t width    = uint64_t(1) << (exponent - sub_bits);
+
+  return ((sub_count + sub) << (exponent - sub_bits)) + width - 1;
+}
+
+void
+LatencyHistogram::insert(uint64_t value) {
+  m_count++;
+  m_sum += value;
+  m_max = std::max(m_max, value);
+
+  m_buckets[bucket_index(value)]++;
+}
+
+void
+LatencyHistogram::clear() {
+  m_count = 0;
+  m_sum   = 0;
+  m_max   = 0;
+
+  std::memset(m_buckets, 0, sizeof(m_buckets));
+}
+
+uint64_t
+LatencyHistogram::percentile(double p) const {
+  if (m_count == 0)
+    return 0;
+
+  uint64_t rank = std::max<uint64_t>(1, std::ceil(p / 100.0 * m_count));
+  uint64_t seen = 0;
+
+  for (uint32_t index = 0; index != size; index++) {
+    seen += m_buckets[index];
+
+    if (seen >= rank)
+      return std::min(bucket_upper(index), m_max);
+  }
+
+  return m_max;
+}
+
+torrent::Object
+LatencyHistogram::to_object() const {
+  torrent::Object result = torrent::Object::create_map();
+
+  result.insert_key("count", (int64_t)m_count);
+  result.insert_key("sum", (int64_t)m_sum);
+  result.insert_key("mean", (int64_t)mean());
+  result.insert_key("max", (int64_t)m_max);
+  result.insert_key("p50", (int64_t)percentile(50));
+  result.insert_key("p90", (int64_t)percentile(90));
+  result.insert_key("p99", (int64_t)percentile(99));
+  result.insert_key("p999", (int64_t)percentile(99.9));
+
+  return result;
+}
+
+}
@@ -0,0 +1,845 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/pattern.h"
+
+namespace utils {
+
+PatternCache patternCache;
+
+namespace {
+
+// Thrown for syntax the NFA compiler doesn't handle, the pattern is
+// then left to std::regex which also reports actual errors.
+struct unsupported_pattern {};
+
+constexpr const char* pattern_meta = "\\^$.|?*+()[]{}";
+
+constexpr uint32_t repeat_limit = 1000;
+
+bool
+is_meta(char c) {
+  return c != '\0' && std::strchr(pattern_meta, c) != nullptr;
+}
+
+bool
+is_alnum(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+         (c >= 'A' && c <= 'Z');
+}
+
+bool
+is_line_terminator(char c) {
+  return c == '\n' || c == '\r';
+}
+
+bool
+has_line_terminator(const char* first, const char* last) {
+  return std::find_if(first, last, is_line_terminator) != last;
+}
+
+// Whether the character at 'pos' is preceded by an odd number of
+// backslashes.
+bool
+is_escaped(const std::string& str, size_t pos) {
+  size_t count = 0;
+
+  while (pos > count && str[pos - count - 1] == '\\')
+    count++;
+
+  return count % 2 == 1;
+}
+
+struct pattern_node {
+  enum kind_type {
+    NODE_EMPTY,
+    NODE_CHAR,
+    NODE_ANY,
+    NODE_CLASS,
+    NODE_LINE_BEGIN,
+    NODE_LINE_END,
+    NODE_CONCAT,
+    NODE_ALTERNATE,
+    NODE_REPEAT
+  };
+
+  kind_type kind{ NODE_EMPTY };
+  uint8_t   c{ 0 };
+  uint32_t  index{ 0 };
+  uint32_t  min{ 0 };
+  uint32_t  max{ 0 };
+  bool      unbounded{ false };
+
+  std::vector<pattern_node> children;
+};
+
+}
+
+class PatternCompiler {
+public:
+  using class_type  = Pattern::class_type;
+  using instruction = Pattern::instruction;
+
+  PatternCompiler(const std::string& pattern, Pattern* target)
+    : m_first(pattern.c_str())
+    , m_position(pattern.c_str())
+    , m_last(pattern.c_str() + pattern.size())
+    , m_target(target) {}
+
+  void compile();
+
+private:
+  bool at_end() const {
+    return m_position == m_last;
+  }
+  char peek() const {
+    return at_end() ? '\0' : *m_position;
+  }
+  char next() {
+    if (at_end())
+      throw unsupported_pattern();
+
+    return *m_position++;
+  }
+
+  pattern_node parse_alternate();
+  pattern_node parse_concat();
+  pattern_node parse_atom();
+  void         parse_quantifier(pattern_node* node);
+  uint32_t     parse_number();
+  pattern_node parse_class();
+  bool         parse_class_escape(class_type* cls);
+  uint8_t      parse_char_escape(char c);
+
+  uint32_t add_class(const class_type& cls);
+
+  uint32_t emit(Pattern::op_enum op, uint8_t c = 0, uint32_t x = 0);
+  void     emit_node(const pattern_node& node);
+
+  static class_type digit_class();
+  static class_type word_class();
+  static class_type space_class();
+
+  const char* m_first;
+  const char* m_position;
+  const char* m_last;
+  Pattern*    m_target;
+};
+
+PatternCompiler::class_type
+PatternCompiler::digit_class() {
+  class_type cls;
+
+  for (char c = '0'; c <= '9'; c++)
+    cls.set((uint8_t)c);
+
+  return cls;
+}
+
+PatternCompiler::class_type
+PatternCompiler::word_class() {
+  class_type cls = digit_class();
+
+  for (char c = 'a'; c <= 'z'; c++) {
+    cls.set((uint8_t)c);
+    cls.set((uint8_t)(c - 'a' + 'A'));
+  }
+
+  cls.set('_');
+  return cls;
+}
+
+PatternCompiler::class_type
+PatternCompiler::space_class() {
+  class_type cls;
+
+  for (char c : { ' ', '\t', '\n', '\v', '\f', '\r' })
+    cls.set((uint8_t)c);
+
+  return cls;
+}
+
+void
+PatternCompiler::compile() {
+  pattern_node root = parse_alternate();
+
+  // A stray ')' is the only way to stop early.
+  if (!at_end())
+    throw unsupported_pattern();
+
+  emit_node(root);
+  emit(Pattern::OP_MATCH);
+}
+
+pattern_node
+PatternCompiler::parse_alternate() {
+  pattern_node node = parse_concat();
+
+  if (peek() != '|')
+    return node;
+
+  pattern_node alternate;
+  alternate.kind = pattern_node::NODE_ALTERNATE;
+  alternate.children.push_back(std::move(node));
+
+  while (peek() == '|') {
+    m_position++;
+    alternate.children.push_back(parse_concat());
+  }
+
+  return alternate;
+}
+
+pattern_node
+PatternCompiler::parse_concat() {
+  pattern_node node;
+  node.kind = pattern_node::NODE_CONCAT;
+
+  while (!at_end() && peek() != '|' && peek() != ')') {
+    pattern_node atom = parse_atom();
+    parse_quantifier(&atom);
+
+    node.children.push_back(std::move(atom));
+  }
+
+  return node;
+}
+
+pattern_node
+PatternCompiler::parse_atom() {
+  pattern_node node;
+  char         c = next();
+
+  switch (c) {
+    case '.':
+      node.kind = pattern_node::NODE_ANY;
+      return node;
+
+    case '^':
+      node.kind = pattern_node::NODE_LINE_BEGIN;
+      return node;
+
+    case '$':
+      node.kind = pattern_node::NODE_LINE_END;
+      return node;
+
+    case '[':
+      return parse_class();
+
+    case '(':
+      if (peek() == '?') {
+        m_position++;
+
+        // Look-ahead assertions are left to std::regex.
+        if (next() != ':')
+          throw unsupported_pattern();
+      }
+
+      node = parse_alternate();
+
+      if (next() != ')')
+        throw unsupported_pattern();
+
+      return node;
+
+    case '\\': {
+      class_type cls;
+
+      if (parse_class_escape(&cls)) {
+        node.kind  = pattern_node::NODE_CLASS;
+        node.index = add_class(cls);
+        return node;
+      }
+
+      node.kind = pattern_node::NODE_CHAR;
+      node.c    = parse_char_escape(next());
+      return node;
+    }
+
+    default:
+      if (is_meta(c))
+        throw unsupported_pattern();
+
+      node.kind = pattern_node::NODE_CHAR;
+      node.c    = c;
+      return node;
+  }
+}
+
+void
+PatternCompiler::parse_quantifier(pattern_node* node) {
+  uint32_t min       = 0;
+  uint32_t max       = 0;
+  bool     unbounded = false;
+
+  switch (peek()) {
+    case '*':
+      unbounded = true;
+      break;
+    case '+':
+      min       = 1;
+      unbounded = true;
+      break;
+    case '?':
+      max = 1;
+      break;
+    case '{':
+      m_position++;
+      min = max = parse_number();
+
+      if (peek() == ',') {
+        m_position++;
+
+        if (peek() == '}')
+          unbounded = true;
+        else
+          max = parse_number();
+      }
+
+      if (peek() != '}' || (!unbounded && max < min))
+        throw unsupported_pattern();
+
+      break;
+    default:
+      return;
+  }
+
+  m_position++;
+
+  if (node->kind == pattern_node::NODE_LINE_BEGIN ||
+      node->kind == pattern_node::NODE_LINE_END)
+    throw unsupported_pattern();
+
+  // Lazy quantifiers match the same texts when the whole text must
+  // match.
+  if (peek() == '?')
+    m_position++;
+
+  // Nested quantifiers such as 'a**' are errors.
+  if (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')
+    throw unsupported_pattern();
+
+  pattern_node repeat;
+  repeat.kind      = pattern_node::NODE_REPEAT;
+  repeat.min       = min;
+  repeat.max       = max;
+  repeat.unbounded = unbounded;
+  repeat.children.push_back(std::move(*node));
+
+  *node = std::move(repeat);
+}
+
+uint32_t
+PatternCompiler::parse_number() {
+  uint32_t value = 0;
+
+  if (peek() < '0' || peek() > '9')
+    throw unsupported_pattern();
+
+  while (peek() >= '0' && peek() <= '9') {
+    value = value * 10 + (next() - '0');
+
+    if (value > repeat_limit)
+      throw unsupported_pattern();
+  }
+
+  return value;
+}
+
+pattern_node
+PatternCompiler::parse_class() {
+  class_type cls;
+  bool       negate = false;
+
+  if (peek() == '^') {
+    negate = true;
+    m_position++;
+  }
+
+  // Leave '[]', '[^]' and POSIX classes to std::regex.
+  if (peek() == ']' || (peek() == '[' && m_position + 1 != m_last &&
+                        m_position[1] == ':'))
+    throw unsupported_pattern();
+
+  while (peek() != ']') {
+    char c = next();
+    int  first;
+
+    if (c == '\\') {
+      class_type escaped;
+
+      if (parse_class_escape(&escaped)) {
+        if (peek() == '-' && m_position + 1 != m_last && m_position[1] != ']')
+          throw unsupported_pattern();
+
+        cls |= escaped;
+        continue;
+      }
+
+      char e = next();
+      first  = e == 'b' ? '\b' : parse_char_escape(e);
+
+    } else if (c == '[') {
+      throw unsupported_pattern();
+
+    } else {
+      first = (uint8_t)c;
+    }
+
+    if (peek() != '-' || m_position + 1 == m_last || m_position[1] == ']') {
+      cls.set(first);
+      continue;
+    }
+
+    m_position++;
+
+    char lastChar = next();
+    int  last;
+
+    if (lastChar == '\\') {
+      char e = next();
+
+      if (e == 'd' || e == 'D' || e == 'w' || e == 'W' || e == 's' ||
+          e == 'S')
+        throw unsupported_pattern();
+
+      last = e == 'b' ? '\b' : parse_char_escape(e);
+
+    } else if (lastChar == '[') {
+      throw unsupported_pattern();
+
+    } else {
+      last = (uint8_t)lastChar;
+    }
+
+    if (last < first)
+      throw unsupported_pattern();
+
+    for (int i = first; i <= last; i++)
+      cls.set(i);
+  }
+
+  m_position++;
+
+  if (negate)
+    cls.flip();
+
+  pattern_node node;
+  node.kind  = pattern_node::NODE_CLASS;
+  node.index = add_class(cls);
+  return node;
+}
+
+// Handles the escapes that stand for a set of characters, with the
+// backslash already consumed.
+bool
+PatternCompiler::parse_class_escape(class_type* cls) {
+  switch (peek()) {
+    case 'd':
+      *cls = digit_class();
+      break;
+    case 'D':
+      *cls = ~digit_class();
+      break;
+    case 'w':
+      *cls = word_class();
+      break;
+    case 'W':
+      *cls = ~word_class();
+      break;
+    case 's':
+      *cls = space_class();
+      break;
+    case 'S':
+      *cls = ~space_class();
+      break;
+    default:
+      return false;
+  }
+
+  m_position++;
+  return true;
+}
+
+uint8_t
+PatternCompiler::parse_char_escape(char c) {
+  switch (c) {
+    case 'n':
+      return '\n';
+    case 't':
+      return '\t';
+    case 'r':
+      return '\r';
+    case 'f':
+      return '\f';
+    case 'v':
+      return '\v';
+    case '0':
+      if (peek() >= '0' && peek() <= '9')
+        throw unsupported_pattern();
+
+      return '\0';
+    case 'x': {
+      int value = 0;
+
+      for (int i = 0; i != 2; i++) {
+        char h = next();
+
+        if (h >= '0' && h <= '9')
+          value = value * 16 + (h - '0');
+        else if (h >= 'a' && h <= 'f')
+          value = value * 16 + (h - 'a' + 10);
+        else if (h >= 'A' && h <= 'F')
+          value = value * 16 + (h - 'A' + 10);
+        else
+          throw unsupported_pattern();
+      }
+
+      return value;
+    }
+    default:
+      // Back-references, word boundaries, control and unicode escapes.
+      if (is_alnum(c))
+        throw unsupported_pattern();
+
+      return c;
+  }
+}
+
+uint32_t
+PatternCompiler::add_class(const class_type& cls) {
+  m_target->m_classes.push_back(cls);
+  return m_target->m_classes.size() - 1;
+}
+
+uint32_t
+PatternCompiler::emit(Pattern::op_enum op, uint8_t c, uint32_t x) {
+  if (m_target->m_program.size() >= Pattern::max_program_size)
+    throw unsupported_pattern();
+
+  m_target->m_program.push_back(instruction{ op, c, x, 0 });
+  return m_target->m_program.size() - 1;
+}
+
+void
+PatternCompiler::emit_node(const pattern_node& node) {
+  auto& program = m_target->m_program;
+
+  switch (node.kind) {
+    case pattern_node::NODE_EMPTY:
+      break;
+    case pattern_node::NODE_CHAR:
+      emit(Pattern::OP_CHAR, node.c);
+      break;
+    case pattern_node::NODE_ANY:
+      emit(Pattern::OP_ANY);
+      break;
+    case pattern_node::NODE_CLASS:
+      emit(Pattern::OP_CLASS, 0, node.index);
+      break;
+    case pattern_node::NODE_LINE_BEGIN:
+      emit(Pattern::OP_LINE_BEGIN);
+      break;
+    case pattern_node::NODE_LINE_END:
+      emit(Pattern::OP_LINE_END);
+      break;
+
+    case pattern_node::NODE_CONCAT:
+      for (const auto& child : node.children)
+        emit_node(child);
+      break;
+
+    case pattern_node::NODE_ALTERNATE: {
+      std::vector<uint32_t> jumps;
+
+      for (size_t i = 0; i + 1 < node.children.size(); i++) {
+        uint32_t split = emit(Pattern::OP_SPLIT, 0, program.size() + 1);
+
+        emit_node(node.children[i]);
+        jumps.push_back(emit(Pattern::OP_JUMP));
+
+        program[split].y = program.size();
+      }
+
+      emit_node(node.children.back());
+
+      for (uint32_t jump : jumps)
+        program[jump].x = program.size();
+
+      break;
+    }
+
+    case pattern_node::NODE_REPEAT: {
+      for (uint32_t i = 0; i != node.min; i++)
+        emit_node(node.children.front());
+
+      if (node.unbounded) {
+        uint32_t loop = emit(Pattern::OP_SPLIT, 0, program.size() + 1);
+
+        emit_node(node.children.front());
+        emit(Pattern::OP_JUMP, 0, loop);
+
+        program[loop].y = program.size();
+        break;
+      }
+
+      std::vector<uint32_t> splits;
+
+      for (uint32_t i = node.min; i != node.max; i++) {
+        splits.push_back(emit(Pattern::OP_SPLIT, 0, program.size() + 1));
+        emit_node(node.children.front());
+      }
+
+      for (uint32_t split : splits)
+        program[split].y = program.size();
+
+      break;
+    }
+  }
+}
+
+Pattern::Pattern(const std::string& pattern) {
+  if (compile_literal(pattern))
+    return;
+
+  try {
+    PatternCompiler(pattern, this).compile();
+    m_type = TYPE_NFA;
+    return;
+
+  } catch (unsupported_pattern&) {
+    m_program.clear();
+    m_classes.clear();
+  }
+
+  try {
+    m_regex = std::make_unique<std::regex>(pattern);
+    m_type  = TYPE_REGEX;
+
+  } catch (const std::regex_error& e) {
+    m_error = e.what();
+  }
+}
+
+// Recognizes a literal, optionally anchored and optionally preceded or
+// followed by '.*'.
+bool
+Pattern::compile_literal(const std::string& pattern) {
+  size_t first = 0;
+  size_t last  = pattern.size();
+
+  if (first != last && pattern[first] == '^')
+    first++;
+
+  if (last > first && pattern[last - 1] == '$' &&
+      !is_escaped(pattern, last - 1))
+    last--;
+
+  bool anyBefore = last - first >= 2 && pattern.compare(first, 2, ".*") == 0;
+
+  if (anyBefore)
+    first += 2;
+
+  bool anyAfter = last - first >= 2 &&
+                  pattern.compare(last - 2, 2, ".*") == 0 &&
+                  !is_escaped(pattern, last - 2);
+
+  if (anyAfter)
+    last -= 2;
+
+  std::string literal;
+
+  for (size_t i = first; i != last; i++) {
+    char c = pattern[i];
+
+    if (c == '\\') {
+      if (++i == last || is_alnum(pattern[i]))
+        return false;
+
+      c = pattern[i];
+
+    } else if (is_meta(c)) {
+      return false;
+    }
+
+    literal += c;
+  }
+
+  if (anyBefore && anyAfter)
+    m_type = TYPE_CONTAINS;
+  else if (anyBefore)
+    m_type = TYPE_SUFFIX;
+  else if (anyAfter)
+    m_type = TYPE_PREFIX;
+  else
+    m_type = TYPE_EXACT;
+
+  m_literal = std::move(literal);
+  return true;
+}
+
+bool
+Pattern::match(const std::string& text) const {
+  const char* first = text.c_str();
+  const char* last  = text.c_str() + text.size();
+  size_t      size  = m_literal.size();
+
+  // The '.*' parts can't cross line terminators.
+  switch (m_type) {
+    case TYPE_EXACT:
+      return text == m_literal;
+
+    case TYPE_PREFIX:
+      return text.size() >= size && text.compare(0, size, m_literal) == 0 &&
+             !has_line_terminator(first + size, last);
+
+    case TYPE_SUFFIX:
+      return text.size() >= size &&
+             text.compare(text.size() - size, size, m_literal) == 0 &&
+             !has_line_terminator(first, last - size);
+
+    case TYPE_CONTAINS: {
+      const char* terminator = std::find_if(first, last, is_line_terminator);
+
+      if (terminator == last)
+        return text.find(m_literal) != std::string::npos;
+
+      // Every terminator must then be inside the literal.
+      size_t firstTerminator = terminator - first;
+      size_t lastTerminator  = text.find_last_of("\n\r");
+
+      for (size_t pos = text.find(m_literal);
+           pos != std::string::npos && pos <= firstTerminator;
+           pos = text.find(m_literal, pos + 1))
+        if (pos + size > lastTerminator)
+          return true;
+
+      return false;
+    }
+
+    case TYPE_NFA:
+      return match_nfa(text);
+
+    case TYPE_REGEX:
+      return std::regex_match(text, *m_regex);
+
+    case TYPE_INVALID:
+    default:
+      return false;
+  }
+}
+
+// Pike VM without captures: all threads advance in lockstep over the
+// text, and a generation mark per instruction keeps each list free of
+// duplicates, bounding the work per character by the program size.
+bool
+Pattern::match_nfa(const std::string& text) const {
+  thread_local std::vector<uint32_t> current;
+  thread_local std::vector<uint32_t> upcoming;
+  thread_local std::vector<uint32_t> stack;
+  thread_local std::vector<uint32_t> marks;
+
+  uint32_t generation = 0;
+  size_t   size       = text.size();
+
+  marks.assign(m_program.size(), 0);
+  current.clear();
+
+  auto add_thread = [&](std::vector<uint32_t>& list, uint32_t pc, size_t pos) {
+    stack.clear();
+    stack.push_back(pc);
+
+    while (!stack.empty()) {
+      uint32_t p = stack.back();
+      stack.pop_back();
+
+      if (marks[p] == generation)
+        continue;
+
+      marks[p] = generation;
+
+      const instruction& inst = m_program[p];
+
+      switch (inst.op) {
+        case OP_JUMP:
+          stack.push_back(inst.x);
+          break;
+        case OP_SPLIT:
+          stack.push_back(inst.y);
+          stack.push_back(inst.x);
+          break;
+        case OP_LINE_BEGIN:
+          if (pos == 0)
+            stack.push_back(p + 1);
+          break;
+        case OP_LINE_END:
+          if (pos == size)
+            stack.push_back(p + 1);
+          break;
+        default:
+          list.push_back(p);
+          break;
+      }
+    }
+  };
+
+  generation++;
+  add_thread(current, 0, 0);
+
+  for (size_t pos = 0; pos != size && !current.empty(); pos++) {
+    uint8_t c = text[pos];
+
+    generation++;
+    upcoming.clear();
+
+    for (uint32_t p : current) {
+      const instruction& inst = m_program[p];
+      bool               step = false;
+
+      switch (inst.op) {
+        case OP_CHAR:
+          step = c == inst.c;
+          break;
+        case OP_ANY:
+          step = !is_line_terminator(c);
+          break;
+        case OP_CLASS:
+          step = m_classes[inst.x].test(c);
+          break;
+        default:
+          break;
+      }
+
+      if (step)
+        add_thread(upcoming, p + 1, pos + 1);
+    }
+
+    current.swap(upcoming);
+  }
+
+  return std::any_of(current.begin(), current.end(), [this](uint32_t p) {
+    return m_program[p].op == OP_MATCH;
+  });
+}
+
+const Pattern&
+PatternCache::find(const std::string& pattern, bool* compiled) {
+  auto itr = m_patterns.find(pattern);
+
+  if (compiled != nullptr)
+    *compiled = itr == m_patterns.end();
+
+  if (itr != m_patterns.end())
+    return *itr->second;
+
+  if (m_patterns.size() >= max_size)
+    m_patterns.clear();
+
+  return *m_patterns.emplace(pattern, std::make_unique<Pattern>(pattern))
+            .first->second;
+}
+
+}
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <cstring>
+
+#include <torrent/exceptions.h>
+#include <torrent/utils/timer.h>
+
+#include "utils/trace_ring.h"
+
+namespace utils {
+
+TraceRing traceRing;
+
+namespace {
+
+constexpr char trace_magic[8] = "RTTRACE";
+
+const char* trace_event_names[TRACE_EVENT_MAX] = {
+  "none",
+  "rpc_read",
+  "rpc_write",
+  "execute",
+  "download_resume",
+  "download_pause",
+  "download_hash",
+  "download_finished",
+  "stall",
+};
+
+std::atomic<uint32_t> trace_next_thread{ 0 };
+
+uint32_t
+trace_thread_id() {
+  thread_local uint32_t id = trace_next_thread.fetch_add(1);
+
+  return id;
+}
+
+struct dump_header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t max_args;
+  uint32_t event_count;
+  uint64_t record_count;
+  uint64_t position;
+};
+
+void
+dump_write(FILE* file, const void* data, size_t length) {
+  if (length != 0 && std::fwrite(data, length, 1, file) != 1)
+    throw torrent::input_error("Could not write trace dump.");
+}
+
+}
+
+const char*
+trace_event_name(uint32_t event) {
+  return event < TRACE_EVENT_MAX ? trace_event_names[event] : "unknown";
+}
+
+// Slots follow the seqlock pattern: the sequence is cleared while the
+// record is written and then set to its position plus one, so readers
+// can tell a complete record from a torn or recycled one.
+void
+TraceRing::push(uint32_t event,
+                int64_t  arg0,
+                int64_t  arg1,
+                int64_t  arg2,
+                int64_t  arg3,
+                int64_t  arg4) {
+  uint64_t   pos  = m_position.fetch_add(1, std::memory_order_relaxed);
+  slot_type& slot = m_slots[pos & (size - 1)];
+
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.record.time_usec = torrent::utils::timer::current().usec();
+  slot.record.event     = event;
+  slot.record.thread    = trace_thread_id();
+  slot.record.args[0]   = arg0;
+  slot.record.args[1]   = arg1;
+  slot.record.args[2]   = arg2;
+  slot.record.args[3]   = arg3;
+  slot.record.args[4]   = arg4;
+
+  slot.sequence.store(pos + 1, std::memory_order_release);
+}
+
+std::vector<TraceRing::record_type>
+TraceRing::snapshot() const {
+  std::vector<record_type> result;
+
+  uint64_t last  = position();
+  uint64_t first = last > size ? last - size : 0;
+
+  result.reserve(last - first);
+
+  for (uint64_t pos = first; pos != last; pos++) {
+    const slot_type& slot = m_slots[pos & (size - 1)];
+
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+      continue;
+
+    record_type record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (slot.sequence.load(std::memory_order_relaxed) != pos + 1)
+      continue;
+
+    result.push_back(record);
+  }
+
+  return result;
+}
+
+void
+TraceRing::dump(FILE* file) const {
+  std::vector<record_type> records = snapshot();
+
+  dump_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, trace_magic, sizeof(header.magic));
+
+  header.version      = version;
+  header.record_size  = sizeof(record_type);
+  header.max_args     = max_args;
+  header.event_count  = TRACE_EVENT_MAX;
+  header.record_count = records.size();
+  header.position     = position();
+
+  dump_write(file, &header, sizeof(header));
+
+  for (const char* name : trace_event_names)
+    dump_write(file, name, std::strlen(name) + 1);
+
+  dump_write(file, records.data(), records.size() * sizeof(record_type));
+}
+
+}
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright (C) 2026, Contributors to the rTorrent project
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+#include "utils/trigram_index.h"
+
+namespace utils {
+
+std::string
+TrigramIndex::lowercase(const std::string& text) {
+  std::string result(text);
+
+  std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+  return result;
+}
+
+std::vector<uint32_t>
+TrigramIndex::trigrams(const text_list& texts) {
+  std::vector<uint32_t> result;
+
+  for (const auto& text : texts)
+    for (size_t i = 0; i + 3 <= text.size(); i++)
+      result.push_back((uint32_t)(uint8_t)text[i] << 16 |
+                       (uint32_t)(uint8_t)text[i + 1] << 8 |
+                       (uint32_t)(uint8_t)text[i + 2]);
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+
+  return result;
+}
+
+TrigramIndex::id_type
+TrigramIndex::insert(const text_list& texts) {
+  id_type id;
+
+  if (m_free.empty()) {
+    id = m_documents.size();
+    m_documents.emplace_back();
+  } else {
+    id = m_free.back();
+    m_free.pop_back();
+  }
+
+  document_type& document = m_documents[id];
+  document.used           = true;
+
+  for (const auto& text : texts)
+    document.texts.push_back(lowercase(text));
+
+  for (uint32_t trigram : trigrams(document.texts)) {
+    posting_list& postings = m_postings[trigram];
+
+    if (postings.empty() || postings.back() < id)
+      postings.push_back(id);
+    else
+      postings.insert(std::lower_bound(postings.begin(), postings.end(), id),
+                      id);
+  }
+
+  return id;
+}
+
+void
+TrigramIndex::erase(id_type id) {
+  if (id >= m_documents.size() || !m_documents[id].used)
+    return;
+
+  document_type& document = m_documents[id];
+
+  for (uint32_t trigram : trigrams(document.texts)) {
+    auto itr = m_postings.find(trigram);
+
+    if (itr == m_postings.end())
+      continue;
+
+    posting_list& postings = itr->second;
+    postings.erase(std::lower_bound(postings.begin(), postings.end(), id));
+
+    if (postings.empty())
+      m_postings.erase(itr);
+  }
+
+  document = document_type();
+  m_free.push_back(id);
+}
+
+bool
+TrigramIndex::contains(const document_type& document,
+                       const std::string&   query) const {
+  return std::any_of(
+    document.texts.begin(), document.texts.end(), [&query](const auto& text) {
+      return text.find(query) != std::string::npos;
+    });
+}
+
+std::vector<TrigramIndex::id_type>
+TrigramIndex::search(const std::string& rawQuery) const {
+  std::string          query = lowercase(rawQuery);
+  std::vector<id_type> result;
+
+  if (query.size() < 3) {
+    for (id_type id = 0; id != m_documents.size(); id++)
+      if (m_documents[id].used && contains(m_documents[id], query))
+        result.push_back(id);
+
+    return result;
+  }
+
+  std::vector<const posting_list*> lists;
+
+  for (uint32_t trigram : trigrams(text_list{ query })) {
+    auto itr = m_postings.find(trigram);
+
+    if (itr == m_postings.end())
+      return result;
+
+    lists.push_back(&itr->second);
+  }
+
+  std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) {
+    return a->size() < b->size();
+  });
+
+  std::vector<id_type> candidates(*lists.front());
+  std::vector<id_type> intersection;
+
+  for (auto itr = lists.begin() + 1; itr != lists.end() && !candidates.empty();
+       itr++) {
+    intersection.clear();
+    std::set_intersection(candidates.begin(),
+                          candidates.end(),
+                          (*itr)->begin(),
+                          (*itr)->end(),
+                          std::back_inserter(intersection));
+    candidates.swap(intersection);
+  }
+
+  // A document with all the trigrams of the query need not contain
+  // them in sequence, or within the same text.
+  for (id_type id : candidates)
+    if (contains(m_documents[id], query))
+      result.push_back(id);
+
+  return result;
+}
+
+}
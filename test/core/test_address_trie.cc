@@ -0,0 +1,159 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+
+#include "test/core/address_trie_test.h"
+
+static core::AddressKey
+make_key(const char* str) {
+  uint8_t addr[16];
+
+  if (inet_pton(AF_INET, str, addr) == 1)
+    return core::AddressKey::from_ipv4(ntohl(*(uint32_t*)addr));
+
+  EXPECT_EQ(inet_pton(AF_INET6, str, addr), 1);
+  return core::AddressKey::from_ipv6(addr);
+}
+
+TEST_F(AddressTrieTest, test_longest_prefix) {
+  core::AddressTrie<int> trie;
+
+  trie.insert(make_key("10.0.0.0"), 96 + 8, 1);
+  trie.insert(make_key("10.1.0.0"), 96 + 16, 2);
+  trie.insert(make_key("10.1.2.3"), 128, 3);
+  trie.insert(make_key("2001:db8::"), 32, 4);
+
+  ASSERT_EQ(trie.size(), 4);
+  ASSERT_EQ(trie.get(make_key("10.2.0.1"), 0), 1);
+  ASSERT_EQ(trie.get(make_key("10.1.0.1"), 0), 2);
+  ASSERT_EQ(trie.get(make_key("10.1.2.3"), 0), 3);
+  ASSERT_EQ(trie.get(make_key("10.1.2.4"), 0), 2);
+  ASSERT_EQ(trie.get(make_key("11.0.0.0"), 0), 0);
+  ASSERT_EQ(trie.get(make_key("2001:db8:1::1"), 0), 4);
+  ASSERT_EQ(trie.get(make_key("2001:db9::1"), 0), 0);
+
+  // Inserting a shorter prefix doesn't override more specific ones.
+  trie.insert(make_key("0.0.0.0"), 96, 5);
+
+  ASSERT_EQ(trie.get(make_key("11.0.0.0"), 0), 5);
+  ASSERT_EQ(trie.get(make_key("10.1.2.3"), 0), 3);
+
+  trie.insert(make_key("10.0.0.0"), 96 + 8, 6);
+
+  ASSERT_EQ(trie.size(), 5);
+  ASSERT_EQ(trie.get(make_key("10.2.0.1"), 0), 6);
+}
+
+TEST_F(AddressTrieTest, test_range_to_prefixes) {
+  std::vector<std::pair<core::AddressKey, unsigned int>> prefixes;
+
+  core::address_range_to_prefixes(
+    make_key("10.0.0.1"),
+    make_key("10.0.1.0"),
+    [&prefixes](const core::AddressKey& prefix, unsigned int length) {
+      prefixes.emplace_back(prefix, length);
+    });
+
+  // 10.0.0.1/32, .2/31, .4/30, ... .128/25, 10.0.1.0/32
+  ASSERT_EQ(prefixes.size(), 9);
+  ASSERT_TRUE(prefixes.front().first == make_key("10.0.0.1"));
+  ASSERT_EQ(prefixes.front().second, 128);
+  ASSERT_TRUE(prefixes[7].first == make_key("10.0.0.128"));
+  ASSERT_EQ(prefixes[7].second, 96 + 25);
+  ASSERT_TRUE(prefixes.back().first == make_key("10.0.1.0"));
+  ASSERT_EQ(prefixes.back().second, 128);
+
+  prefixes.clear();
+  core::address_range_to_prefixes(
+    core::AddressKey(),
+    core::AddressKey{ ~uint64_t(), ~uint64_t() },
+    [&prefixes](const core::AddressKey& prefix, unsigned int length) {
+      prefixes.emplace_back(prefix, length);
+    });
+
+  ASSERT_EQ(prefixes.size(), 1);
+  ASSERT_EQ(prefixes.front().second, 0);
+}
+
+// Classifies a batch of random addresses against a large table, and
+// checks the result against a linear scan. The per-lookup time is
+// recorded as a test property.
+TEST_F(AddressTrieTest, test_batch_classification) {
+  std::mt19937_64 rng(42);
+
+  std::vector<std::pair<core::AddressKey, unsigned int>> prefixes;
+  core::AddressTrie<size_t>                              trie;
+
+  for (size_t i = 0; i < 4096; i++) {
+    core::AddressKey key;
+    unsigned int     length;
+
+    if (i % 2) {
+      key    = core::AddressKey::from_ipv4(rng());
+      length = 96 + 8 + rng() % 25;
+    } else {
+      key.high = rng();
+      key.low  = rng();
+      length   = 16 + rng() % 49;
+    }
+
+    key = key.masked(length);
+    trie.insert(key, length, prefixes.size());
+    prefixes.emplace_back(key, length);
+  }
+
+  std::vector<core::AddressKey> addresses;
+
+  for (size_t i = 0; i < 100000; i++) {
+    // Pick addresses inside random prefixes so that most lookups
+    // succeed.
+    const auto& prefix = prefixes[rng() % prefixes.size()];
+    core::AddressKey key{ rng(), rng() };
+    core::AddressKey mask = core::AddressKey().filled(prefix.second);
+
+    addresses.push_back(core::AddressKey{
+      prefix.first.high | (key.high & mask.high),
+      prefix.first.low | (key.low & mask.low) });
+  }
+
+  auto   start = std::chrono::steady_clock::now();
+  size_t found = 0;
+
+  for (const auto& addr : addresses)
+    found += trie.find(addr) != nullptr;
+
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  RecordProperty(
+    "ns_per_lookup",
+    std::to_string(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+      addresses.size()));
+
+  ASSERT_EQ(found, addresses.size());
+
+  for (size_t i = 0; i < 1000; i++) {
+    const core::AddressKey& addr   = addresses[i];
+    const size_t*           result = trie.find(addr);
+    unsigned int            best   = 0;
+    size_t                  value  = 0;
+    bool                    match  = false;
+
+    for (size_t j = 0; j < prefixes.size(); j++) {
+      if (addr.masked(prefixes[j].second) != prefixes[j].first ||
+          (match && prefixes[j].second < best))
+        continue;
+
+      // Later duplicates replace earlier ones.
+      best  = prefixes[j].second;
+      value = j;
+      match = true;
+    }
+
+    ASSERT_TRUE(result != nullptr);
+    ASSERT_EQ(*result, value);
+  }
+}
@@ -0,0 +1,208 @@
+#include <list>
+#include <string>
+
+#include <torrent/download/choke_group.h>
+#include <torrent/exceptions.h>
+
+#include "test/core/choke_group_manager_test.h"
+
+namespace {
+
+struct fake_download {
+  uint32_t group{ 0 };
+  uint64_t up_rate{ 0 };
+  bool     active{ false };
+};
+
+fake_download*
+as_fake(core::Download* d) {
+  return reinterpret_cast<fake_download*>(d);
+}
+
+// Drives a ChokeGroupManager with fake downloads holding their own
+// group index and rates.
+class fake_groups {
+public:
+  fake_groups() {
+    manager.set_slot_group([](core::Download* d) { return as_fake(d)->group; });
+    manager.set_slot_set_group(
+      [](core::Download* d, uint32_t index) { as_fake(d)->group = index; });
+    manager.set_slot_stats(
+      [](core::Download* d, core::ChokeGroupManager::group_stats& stats) {
+        stats.up_rate += as_fake(d)->up_rate;
+        stats.active += as_fake(d)->active;
+      });
+
+    for (const char* name : { "default", "a", "b", "c" })
+      manager.insert(name);
+  }
+
+  fake_groups(const fake_groups&) = delete;
+  void operator=(const fake_groups&) = delete;
+
+  // Inserted the way the download list does, into its current group.
+  core::Download* insert(uint32_t group, uint64_t up_rate = 0) {
+    downloads.push_back(fake_download{ group, up_rate });
+
+    auto d = reinterpret_cast<core::Download*>(&downloads.back());
+    manager.insert(d);
+    return d;
+  }
+
+  uint32_t group(core::Download* d) const {
+    return as_fake(d)->group;
+  }
+
+  bool is_member(uint32_t index, core::Download* d) const {
+    return manager.members(index).count(d) != 0;
+  }
+
+  // Every group is found at its own index.
+  bool is_indexed() {
+    for (uint32_t index = 0; index != manager.size(); index++)
+      if (manager.index_of(manager.at(index)->name()) != index)
+        return false;
+
+    return true;
+  }
+
+  core::ChokeGroupManager  manager;
+  std::list<fake_download> downloads;
+};
+
+}
+
+TEST_F(ChokeGroupManagerTest, test_insert) {
+  fake_groups groups;
+
+  ASSERT_EQ(groups.manager.size(), 4);
+  ASSERT_EQ(groups.manager.index_of("default"), 0);
+  ASSERT_EQ(groups.manager.index_of("b"), 2);
+  ASSERT_EQ(groups.manager.index_of("missing"), -1);
+  ASSERT_EQ(groups.manager.at(3)->name(), "c");
+  ASSERT_TRUE(groups.is_indexed());
+
+  ASSERT_THROW(groups.manager.insert("a"), torrent::input_error);
+  ASSERT_THROW(groups.manager.insert(""), torrent::input_error);
+  ASSERT_THROW(groups.manager.at(4), torrent::input_error);
+  ASSERT_THROW(groups.manager.members(4), torrent::input_error);
+  ASSERT_EQ(groups.manager.size(), 4);
+
+  groups.manager.insert("d");
+
+  ASSERT_EQ(groups.manager.index_of("d"), 4);
+  ASSERT_TRUE(groups.manager.members(4).empty());
+}
+
+TEST_F(ChokeGroupManagerTest, test_rename) {
+  fake_groups groups;
+
+  auto d = groups.insert(1);
+
+  groups.manager.rename_group(1, "e");
+
+  ASSERT_EQ(groups.manager.at(1)->name(), "e");
+  ASSERT_EQ(groups.manager.index_of("e"), 1);
+  ASSERT_EQ(groups.manager.index_of("a"), -1);
+  ASSERT_TRUE(groups.is_member(1, d));
+
+  // Renaming to its own name does nothing, while taken or empty names
+  // leave the group as it was.
+  groups.manager.rename_group(1, "e");
+
+  ASSERT_THROW(groups.manager.rename_group(1, "b"), torrent::input_error);
+  ASSERT_THROW(groups.manager.rename_group(1, ""), torrent::input_error);
+  ASSERT_THROW(groups.manager.rename_group(4, "f"), torrent::input_error);
+  ASSERT_EQ(groups.manager.index_of("e"), 1);
+  ASSERT_TRUE(groups.is_indexed());
+
+  // The old name is free again.
+  groups.manager.insert("a");
+
+  ASSERT_EQ(groups.manager.index_of("a"), 4);
+}
+
+TEST_F(ChokeGroupManagerTest, test_erase) {
+  fake_groups groups;
+
+  auto d0 = groups.insert(0);
+  auto d1 = groups.insert(1);
+  auto d2 = groups.insert(2);
+  auto d3 = groups.insert(3);
+
+  groups.manager.erase_group(1);
+
+  ASSERT_EQ(groups.manager.size(), 3);
+  ASSERT_EQ(groups.manager.index_of("a"), -1);
+  ASSERT_EQ(groups.manager.index_of("b"), 1);
+  ASSERT_EQ(groups.manager.index_of("c"), 2);
+  ASSERT_TRUE(groups.is_indexed());
+
+  // Members of the erased group move to the default group, and those
+  // of later groups follow their group's new index.
+  ASSERT_EQ(groups.group(d1), 0);
+  ASSERT_EQ(groups.group(d2), 1);
+  ASSERT_EQ(groups.group(d3), 2);
+  ASSERT_EQ(groups.manager.members(0).size(), 2);
+  ASSERT_TRUE(groups.is_member(0, d0));
+  ASSERT_TRUE(groups.is_member(0, d1));
+  ASSERT_TRUE(groups.is_member(1, d2));
+  ASSERT_TRUE(groups.is_member(2, d3));
+
+  ASSERT_THROW(groups.manager.erase_group(0), torrent::input_error);
+  ASSERT_THROW(groups.manager.erase_group(3), torrent::input_error);
+
+  // Erasing the last group leaves nothing to shift.
+  groups.manager.erase_group(2);
+
+  ASSERT_EQ(groups.group(d3), 0);
+  ASSERT_EQ(groups.manager.members(0).size(), 3);
+  ASSERT_TRUE(groups.is_indexed());
+
+  groups.manager.insert("a");
+
+  ASSERT_EQ(groups.manager.index_of("a"), 2);
+  ASSERT_TRUE(groups.manager.members(2).empty());
+}
+
+TEST_F(ChokeGroupManagerTest, test_set_group) {
+  fake_groups groups;
+
+  auto d = groups.insert(0);
+
+  groups.manager.set_group(d, 2);
+
+  ASSERT_EQ(groups.group(d), 2);
+  ASSERT_TRUE(groups.manager.members(0).empty());
+  ASSERT_TRUE(groups.is_member(2, d));
+
+  // A missing group leaves the download where it was.
+  ASSERT_THROW(groups.manager.set_group(d, 4), torrent::input_error);
+  ASSERT_EQ(groups.group(d), 2);
+  ASSERT_TRUE(groups.is_member(2, d));
+
+  groups.manager.set_group(d, 2);
+
+  ASSERT_EQ(groups.manager.members(2).size(), 1);
+
+  groups.manager.erase(d);
+
+  ASSERT_TRUE(groups.manager.members(2).empty());
+}
+
+TEST_F(ChokeGroupManagerTest, test_stats) {
+  fake_groups groups;
+
+  groups.insert(1, 100);
+  groups.insert(1, 20);
+  groups.insert(2, 3);
+  as_fake(groups.insert(1, 0))->active = true;
+
+  auto stats = groups.manager.stats(1);
+
+  ASSERT_EQ(stats.up_rate, 120);
+  ASSERT_EQ(stats.active, 1);
+  ASSERT_EQ(groups.manager.stats(2).up_rate, 3);
+  ASSERT_EQ(groups.manager.stats(3).up_rate, 0);
+  ASSERT_THROW(groups.manager.stats(4), torrent::input_error);
+}
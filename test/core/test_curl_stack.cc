@@ -0,0 +1,120 @@
+#include <set>
+#include <string>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "test/core/curl_stack_test.h"
+
+namespace {
+
+// Only the addresses of the requests are used.
+char storage[8];
+
+core::CurlGet*
+get(int n) {
+  return reinterpret_cast<core::CurlGet*>(storage + n);
+}
+
+// Pops the requests in the order the stack would start them, given
+// the hosts that are saturated.
+std::vector<core::CurlGet*>
+drain(core::CurlHostQueue*         queue,
+      const std::set<std::string>& saturated,
+      const std::string&           host_of) {
+  std::vector<core::CurlGet*> result;
+
+  auto available = [&](const std::string& host) {
+    return saturated.find(host) == saturated.end();
+  };
+
+  while (core::CurlGet* next = queue->front_available(available)) {
+    result.push_back(next);
+    queue->erase(
+      next, std::string(1, host_of[reinterpret_cast<char*>(next) - storage]));
+  }
+
+  return result;
+}
+
+}
+
+TEST_F(CurlStackTest, test_http2) {
+  core::CurlStack stack;
+
+  ASSERT_TRUE(stack.http2());
+
+  stack.set_http2(false);
+  ASSERT_FALSE(stack.http2());
+  ASSERT_EQ(stack.http_version(), CURL_HTTP_VERSION_1_1);
+
+  stack.set_http2(true);
+  ASSERT_TRUE(stack.http2());
+
+#if LIBCURL_VERSION_NUM >= 0x072f00
+  bool supported =
+    curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2;
+
+  ASSERT_EQ(stack.http_version(),
+            supported ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1);
+#else
+  ASSERT_EQ(stack.http_version(), CURL_HTTP_VERSION_1_1);
+#endif
+}
+
+TEST_F(CurlStackTest, test_host_queue) {
+  core::CurlHostQueue queue;
+
+  // Requests 0 to 5 on hosts a, a, b, a, c, b.
+  const std::string hosts = "aabacb";
+
+  for (int n = 0; n != 6; n++)
+    queue.push_back(get(n), std::string(1, hosts[n]));
+
+  ASSERT_EQ(queue.size(), 6);
+  ASSERT_EQ(queue.front_available([](const std::string&) { return true; }),
+            get(0));
+
+  // Requests to saturated hosts are stepped over, keeping the order
+  // of the others.
+  ASSERT_EQ(drain(&queue, { "a" }, hosts),
+            (std::vector<core::CurlGet*>{ get(2), get(4), get(5) }));
+  ASSERT_EQ(queue.size(), 3);
+  ASSERT_EQ(drain(&queue, { "a", "b", "c" }, hosts),
+            std::vector<core::CurlGet*>{});
+
+  ASSERT_EQ(drain(&queue, {}, hosts),
+            (std::vector<core::CurlGet*>{ get(0), get(1), get(3) }));
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST_F(CurlStackTest, test_host_queue_erase) {
+  core::CurlHostQueue queue;
+
+  const std::string hosts = "abab";
+
+  for (int n = 0; n != 4; n++)
+    queue.push_back(get(n), std::string(1, hosts[n]));
+
+  // Erasing the oldest request of a host moves the host back to its
+  // next request, behind the other host.
+  ASSERT_TRUE(queue.erase(get(0), "a"));
+  ASSERT_EQ(queue.front_available([](const std::string&) { return true; }),
+            get(1));
+
+  ASSERT_TRUE(queue.erase(get(3), "b"));
+  ASSERT_FALSE(queue.erase(get(3), "b"));
+  ASSERT_FALSE(queue.erase(get(2), "b"));
+  ASSERT_FALSE(queue.erase(get(5), "c"));
+  ASSERT_EQ(queue.size(), 2);
+
+  ASSERT_EQ(drain(&queue, {}, hosts),
+            (std::vector<core::CurlGet*>{ get(1), get(2) }));
+
+  // Emptied hosts are queued again at the back.
+  queue.push_back(get(4), "b");
+  queue.push_back(get(5), "a");
+
+  ASSERT_EQ(drain(&queue, {}, "....ba"),
+            (std::vector<core::CurlGet*>{ get(4), get(5) }));
+}
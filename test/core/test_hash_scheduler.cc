@@ -0,0 +1,152 @@
+#include <vector>
+
+#include "test/core/hash_scheduler_test.h"
+
+using candidate_type = core::HashScheduler::candidate_type;
+using candidate_list = core::HashScheduler::candidate_list;
+using device_map     = core::HashScheduler::device_map;
+
+// Candidates are told apart by their size.
+static candidate_type
+candidate(dev_t device, uint64_t size, bool partial = false) {
+  return candidate_type{ nullptr, device, partial, size };
+}
+
+static std::vector<uint64_t>
+sizes_of(const candidate_list& candidates) {
+  std::vector<uint64_t> result;
+
+  for (const auto& c : candidates)
+    result.push_back(c.size);
+
+  return result;
+}
+
+// Returns the sizes of the candidates started, in order, and puts
+// those left waiting in 'waiting'.
+static std::vector<uint64_t>
+start(candidate_list         candidates,
+      device_map*            active,
+      uint32_t               maxActive,
+      uint32_t               maxPerDevice,
+      std::vector<uint64_t>* waiting = nullptr,
+      uint64_t               failing = 0) {
+  std::vector<uint64_t> started;
+
+  auto left = core::HashScheduler::start_waiting(
+    candidates, active, maxActive, maxPerDevice, [&](const candidate_type& c) {
+      if (c.size == failing)
+        return false;
+
+      started.push_back(c.size);
+      return true;
+    });
+
+  if (waiting != nullptr)
+    *waiting = sizes_of(left);
+
+  return started;
+}
+
+TEST_F(HashSchedulerTest, test_priority) {
+  device_map            active;
+  std::vector<uint64_t> waiting;
+
+  // Partially completed first, then the smallest, keeping the order
+  // of equals.
+  auto started = start({ candidate(1, 30),
+                         candidate(1, 10),
+                         candidate(1, 40, true),
+                         candidate(1, 20, true),
+                         candidate(1, 11) },
+                       &active,
+                       1,
+                       0,
+                       &waiting);
+
+  ASSERT_EQ(started, (std::vector<uint64_t>{ 20 }));
+  ASSERT_EQ(waiting, (std::vector<uint64_t>{ 40, 10, 11, 30 }));
+  ASSERT_EQ(active, (device_map{ { 1, 1 } }));
+}
+
+TEST_F(HashSchedulerTest, test_one_per_device) {
+  device_map            active;
+  std::vector<uint64_t> waiting;
+
+  // Only the first of each device starts, even though the second on
+  // device 1 comes before any on device 3.
+  auto started = start({ candidate(1, 10),
+                         candidate(1, 20),
+                         candidate(2, 30),
+                         candidate(3, 40),
+                         candidate(2, 50) },
+                       &active,
+                       8,
+                       1,
+                       &waiting);
+
+  ASSERT_EQ(started, (std::vector<uint64_t>{ 10, 30, 40 }));
+  ASSERT_EQ(waiting, (std::vector<uint64_t>{ 20, 50 }));
+  ASSERT_EQ(active, (device_map{ { 1, 1 }, { 2, 1 }, { 3, 1 } }));
+
+  // Once device 1 is done its next download goes, while device 2 is
+  // still busy.
+  active.erase(1);
+
+  started = start({ candidate(1, 20), candidate(2, 50) },
+                  &active,
+                  8,
+                  1,
+                  &waiting);
+
+  ASSERT_EQ(started, (std::vector<uint64_t>{ 20 }));
+  ASSERT_EQ(waiting, (std::vector<uint64_t>{ 50 }));
+}
+
+TEST_F(HashSchedulerTest, test_limits) {
+  device_map            active{ { 1, 1 } };
+  std::vector<uint64_t> waiting;
+
+  // Checks already running count against both limits.
+  auto started = start({ candidate(1, 10),
+                         candidate(1, 20),
+                         candidate(2, 30),
+                         candidate(3, 40) },
+                       &active,
+                       3,
+                       2,
+                       &waiting);
+
+  ASSERT_EQ(started, (std::vector<uint64_t>{ 10, 30 }));
+  ASSERT_EQ(waiting, (std::vector<uint64_t>{ 20, 40 }));
+
+  // Without a per-device limit only the global one applies.
+  active.clear();
+
+  started = start({ candidate(1, 10), candidate(1, 20), candidate(1, 30) },
+                  &active,
+                  2,
+                  0,
+                  &waiting);
+
+  ASSERT_EQ(started, (std::vector<uint64_t>{ 10, 20 }));
+  ASSERT_EQ(waiting, (std::vector<uint64_t>{ 30 }));
+}
+
+TEST_F(HashSchedulerTest, test_failed_start) {
+  device_map            active;
+  std::vector<uint64_t> waiting;
+
+  // A check that fails to start is dropped and leaves its slot to the
+  // next one on the same device.
+  auto started = start({ candidate(1, 10), candidate(1, 20), candidate(1, 30) },
+                       &active,
+                       8,
+                       1,
+                       &waiting,
+                       10);
+
+  ASSERT_EQ(started, (std::vector<uint64_t>{ 20 }));
+  ASSERT_EQ(waiting, (std::vector<uint64_t>{ 30 }));
+  ASSERT_EQ(active, (device_map{ { 1, 1 } }));
+}
@@ -0,0 +1,359 @@
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "test/core/queue_manager_test.h"
+
+using entry_type = core::TrackerQueue::entry_type;
+
+using tracker_map = std::map<std::string, uint32_t>;
+
+// Entries are told apart by their sequence.
+static entry_type
+entry(uint64_t sequence, uint32_t priority = 1) {
+  return entry_type{ priority, sequence, nullptr };
+}
+
+static std::map<uint64_t, std::string> trackers;
+
+namespace {
+
+struct fake_download {
+  std::string name;
+  std::string tracker;
+  bool        done;
+  uint32_t    priority;
+  bool        active{ false };
+
+  // Waiting for the initial hash check after having been resumed.
+  bool hashing{ false };
+};
+
+fake_download*
+as_fake(core::Download* d) {
+  return reinterpret_cast<fake_download*>(d);
+}
+
+// Drives a QueueManager with fake downloads, recording the names of
+// those it resumes and pauses.
+class fake_queue {
+public:
+  fake_queue() {
+    manager.set_slot_state([](core::Download* d) {
+      fake_download* f = as_fake(d);
+
+      return core::QueueManager::state_type{
+        f->active || f->hashing, f->done, f->priority
+      };
+    });
+    manager.set_slot_tracker(
+      [](core::Download* d) { return as_fake(d)->tracker; });
+    manager.set_slot_resume([this](core::Download* d) {
+      as_fake(d)->active = true;
+      resumed.push_back(as_fake(d)->name);
+    });
+    manager.set_slot_pause([this](core::Download* d) {
+      as_fake(d)->active = false;
+      paused.push_back(as_fake(d)->name);
+    });
+  }
+
+  fake_queue(const fake_queue&) = delete;
+  void operator=(const fake_queue&) = delete;
+
+  core::Download* add(const std::string& name,
+                      const std::string& tracker  = "",
+                      bool               done     = false,
+                      uint32_t           priority = 2) {
+    downloads.push_back(fake_download{ name, tracker, done, priority });
+    return reinterpret_cast<core::Download*>(&downloads.back());
+  }
+
+  core::Download* insert(const std::string& name,
+                         const std::string& tracker  = "",
+                         bool               done     = false,
+                         uint32_t           priority = 2) {
+    core::Download* d = add(name, tracker, done, priority);
+
+    manager.insert(d);
+    return d;
+  }
+
+  // The caller pauses downloads leaving the 'started' view.
+  void erase(core::Download* d) {
+    as_fake(d)->active = false;
+    manager.erase(d);
+  }
+
+  core::QueueManager       manager{ nullptr };
+  std::list<fake_download> downloads;
+  std::vector<std::string> resumed;
+  std::vector<std::string> paused;
+};
+
+using names = std::vector<std::string>;
+
+}
+
+static void
+insert(core::TrackerQueue* queue, const std::string& tracker, entry_type e) {
+  trackers[e.sequence] = tracker;
+  queue->insert(tracker, e);
+}
+
+// Starts entries the way QueueManager::start_next does, with at most
+// 'perTracker' active on a tracker, and returns the sequences in the
+// order they were started.
+static std::vector<uint64_t>
+start_all(core::TrackerQueue* queue, uint32_t perTracker, tracker_map* active) {
+  std::vector<uint64_t> result;
+
+  while (true) {
+    const entry_type* next =
+      queue->front_available([&](const std::string& tracker) {
+        return tracker.empty() || (*active)[tracker] < perTracker;
+      });
+
+    if (next == nullptr)
+      return result;
+
+    entry_type  started = *next;
+    std::string tracker = trackers[started.sequence];
+
+    result.push_back(started.sequence);
+    (*active)[tracker]++;
+
+    queue->erase(tracker, started);
+  }
+}
+
+TEST_F(QueueManagerTest, test_order) {
+  core::TrackerQueue queue;
+
+  insert(&queue, "a", entry(1));
+  insert(&queue, "b", entry(2));
+  insert(&queue, "a", entry(3, 2));
+  insert(&queue, "", entry(4));
+
+  // Higher priority first, then in the order queued, across trackers.
+  ASSERT_EQ(queue.size(), 4);
+  ASSERT_EQ(queue.front().sequence, 3);
+  ASSERT_EQ(queue.position(entry(3, 2)), 0);
+  ASSERT_EQ(queue.position(entry(1)), 1);
+  ASSERT_EQ(queue.position(entry(2)), 2);
+  ASSERT_EQ(queue.position(entry(4)), 3);
+  ASSERT_EQ(queue.position(entry(5)), -1);
+
+  queue.erase("a", entry(3, 2));
+
+  ASSERT_EQ(queue.front().sequence, 1);
+  ASSERT_EQ(queue.position(entry(4)), 2);
+}
+
+TEST_F(QueueManagerTest, test_tracker_fairness) {
+  core::TrackerQueue queue;
+
+  // Tracker 'a' has most of the queue ahead of the others.
+  insert(&queue, "a", entry(1));
+  insert(&queue, "a", entry(2));
+  insert(&queue, "a", entry(3));
+  insert(&queue, "b", entry(4));
+  insert(&queue, "a", entry(5));
+  insert(&queue, "c", entry(6));
+  insert(&queue, "b", entry(7));
+  insert(&queue, "", entry(8));
+
+  tracker_map active;
+
+  // Once 'a' is full, the first download of each other tracker goes
+  // in queue order. Those without a tracker are never held back.
+  ASSERT_EQ(start_all(&queue, 1, &active),
+            (std::vector<uint64_t>{ 1, 4, 6, 8 }));
+  ASSERT_EQ(queue.size(), 4);
+  ASSERT_EQ(queue.front().sequence, 2);
+
+  // A slot freed on 'b' goes to the next 'b', not the head of the
+  // queue.
+  active["b"]--;
+
+  ASSERT_EQ(start_all(&queue, 1, &active),
+            (std::vector<uint64_t>{ 7 }));
+
+  active.clear();
+
+  ASSERT_EQ(start_all(&queue, 2, &active),
+            (std::vector<uint64_t>{ 2, 3 }));
+  ASSERT_EQ(queue.position(entry(5)), 0);
+}
+
+TEST_F(QueueManagerTest, test_nothing_available) {
+  core::TrackerQueue queue;
+
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.front_available([](const std::string&) { return true; }),
+            nullptr);
+
+  insert(&queue, "a", entry(1));
+  insert(&queue, "b", entry(2));
+
+  ASSERT_EQ(queue.front_available([](const std::string&) { return false; }),
+            nullptr);
+
+  // Buckets are dropped when emptied.
+  queue.erase("a", entry(1));
+  queue.erase("b", entry(2));
+
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.front_available([](const std::string&) { return true; }),
+            nullptr);
+}
+
+TEST_F(QueueManagerTest, test_fill) {
+  fake_queue queue;
+  queue.manager.set_max_active(2);
+
+  auto a = queue.insert("a");
+  queue.insert("b");
+  auto c = queue.insert("c");
+  auto d = queue.insert("d");
+
+  ASSERT_EQ(queue.resumed, (names{ "a", "b" }));
+  ASSERT_EQ(queue.manager.started(), 2);
+  ASSERT_EQ(queue.manager.active_downloading(), 2);
+  ASSERT_EQ(queue.manager.queued_downloading(), 2);
+  ASSERT_EQ(queue.manager.position(c), 0);
+  ASSERT_EQ(queue.manager.position(d), 1);
+  ASSERT_EQ(queue.manager.position(a), -1);
+  ASSERT_EQ(queue.manager.reason(a), core::QueueManager::reason_active);
+  ASSERT_EQ(queue.manager.reason(c), core::QueueManager::reason_slots);
+
+  // Higher priority goes ahead of those queued earlier.
+  auto e = queue.insert("e", "", false, 3);
+
+  ASSERT_EQ(queue.manager.position(e), 0);
+  ASSERT_EQ(queue.manager.position(c), 1);
+
+  queue.erase(a);
+
+  ASSERT_EQ(queue.resumed, (names{ "a", "b", "e" }));
+  ASSERT_EQ(queue.manager.position(c), 0);
+  ASSERT_EQ(queue.manager.reason(a), core::QueueManager::reason_not_queued);
+}
+
+TEST_F(QueueManagerTest, test_trim) {
+  fake_queue queue;
+
+  auto a = queue.insert("a");
+  queue.insert("b", "", false, 3);
+  auto c = queue.insert("c");
+
+  ASSERT_EQ(queue.resumed, (names{ "a", "b", "c" }));
+
+  // The last in queue order are paused first, and queued again in
+  // their old place.
+  queue.manager.set_max_active(1);
+
+  ASSERT_EQ(queue.paused, (names{ "c", "a" }));
+  ASSERT_EQ(queue.manager.paused(), 2);
+  ASSERT_EQ(queue.manager.active_downloading(), 1);
+  ASSERT_EQ(queue.manager.position(a), 0);
+  ASSERT_EQ(queue.manager.position(c), 1);
+
+  queue.manager.set_max_active(2);
+
+  ASSERT_EQ(queue.resumed, (names{ "a", "b", "c", "a" }));
+}
+
+TEST_F(QueueManagerTest, test_finished) {
+  fake_queue queue;
+  queue.manager.set_max_downloading(1);
+  queue.manager.set_max_seeding(1);
+
+  auto a = queue.insert("a");
+  auto b = queue.insert("b");
+  auto s = queue.insert("s", "", true);
+  auto t = queue.insert("t", "", true);
+
+  ASSERT_EQ(queue.resumed, (names{ "a", "s" }));
+  ASSERT_EQ(queue.manager.reason(b),
+            core::QueueManager::reason_slots_downloading);
+  ASSERT_EQ(queue.manager.reason(t), core::QueueManager::reason_slots_seeding);
+
+  // A finished download moves over to the seeding slots, pausing the
+  // seed queued after it and making room for the next download.
+  as_fake(a)->done = true;
+  queue.manager.update();
+
+  ASSERT_EQ(queue.paused, (names{ "s" }));
+  ASSERT_EQ(queue.resumed, (names{ "a", "s", "b" }));
+  ASSERT_EQ(queue.manager.active_downloading(), 1);
+  ASSERT_EQ(queue.manager.active_seeding(), 1);
+  ASSERT_EQ(queue.manager.queued_seeding(), 2);
+  ASSERT_EQ(queue.manager.position(s), 0);
+  ASSERT_EQ(queue.manager.position(t), 1);
+}
+
+TEST_F(QueueManagerTest, test_finished_queued) {
+  fake_queue queue;
+  queue.manager.set_max_downloading(0);
+
+  auto c = queue.insert("c");
+
+  ASSERT_TRUE(queue.resumed.empty());
+  ASSERT_EQ(queue.manager.queued_downloading(), 1);
+
+  // Hash checked as complete while queued, it now goes to the seeding
+  // queue which has free slots.
+  as_fake(c)->done = true;
+  queue.manager.update();
+
+  ASSERT_EQ(queue.resumed, (names{ "c" }));
+  ASSERT_EQ(queue.manager.queued_downloading(), 0);
+  ASSERT_EQ(queue.manager.active_seeding(), 1);
+}
+
+TEST_F(QueueManagerTest, test_hash_check) {
+  fake_queue queue;
+  queue.manager.set_max_active(1);
+
+  // Resumed before being inserted and waiting for its hash check, it
+  // keeps the slot without being resumed again.
+  auto h = queue.add("h");
+  as_fake(h)->hashing = true;
+  queue.manager.insert(h);
+
+  auto a = queue.insert("a");
+
+  ASSERT_TRUE(queue.resumed.empty());
+  ASSERT_EQ(queue.manager.reason(h), core::QueueManager::reason_active);
+  ASSERT_EQ(queue.manager.reason(a), core::QueueManager::reason_slots);
+
+  // Once checked and left closed, it is queued again ahead of those
+  // inserted after it.
+  as_fake(h)->hashing = false;
+  queue.manager.update();
+
+  ASSERT_EQ(queue.resumed, (names{ "h" }));
+  ASSERT_EQ(queue.manager.position(a), 0);
+}
+
+TEST_F(QueueManagerTest, test_per_tracker) {
+  fake_queue queue;
+  queue.manager.set_max_per_tracker(1);
+
+  auto a1 = queue.insert("a1", "a");
+  auto a2 = queue.insert("a2", "a");
+  queue.insert("b1", "b");
+  queue.insert("n1");
+  queue.insert("n2");
+
+  // Downloads without a tracker are not limited.
+  ASSERT_EQ(queue.resumed, (names{ "a1", "b1", "n1", "n2" }));
+  ASSERT_EQ(queue.manager.reason(a2),
+            core::QueueManager::reason_slots_tracker);
+
+  queue.erase(a1);
+
+  ASSERT_EQ(queue.resumed, (names{ "a1", "b1", "n1", "n2", "a2" }));
+}
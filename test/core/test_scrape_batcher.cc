@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <torrent/exceptions.h>
+#include <torrent/object.h>
+
+#include "test/core/scrape_batcher_test.h"
+
+namespace {
+
+// Hashes are told apart by the character they're filled with.
+torrent::HashString
+hash(char c) {
+  torrent::HashString result;
+  std::fill(result.begin(), result.end(), c);
+  return result;
+}
+
+core::ScrapeBatcher::hash_list
+hashes(const std::string& ids) {
+  core::ScrapeBatcher::hash_list result;
+
+  for (char c : ids)
+    result.push_back(hash(c));
+
+  return result;
+}
+
+// Bencoded "files" entry of a scrape response.
+std::string
+file_entry(char id, int64_t complete) {
+  return "20:" + std::string(20, id) + "d8:completei" +
+         std::to_string(complete) + "ee";
+}
+
+using batch_list = std::vector<std::pair<std::string, std::string>>;
+
+// Records the batches sent and the hashes scraped or falling back,
+// instead of talking to trackers and downloads.
+class fake_batcher {
+public:
+  fake_batcher() {
+    batcher.set_slot_send([this](const std::string&             url,
+                                 core::ScrapeBatcher::hash_list& list) {
+      std::string ids;
+
+      for (const auto& h : list)
+        ids += *h.begin();
+
+      sent.emplace_back(url, ids);
+    });
+    batcher.set_slot_scraped(
+      [this](const torrent::HashString& h, const torrent::Object& stats) {
+        scraped[*h.begin()] = stats.get_key_value("complete");
+      });
+    batcher.set_slot_fallback(
+      [this](const torrent::HashString& h) { fallbacks += *h.begin(); });
+  }
+
+  fake_batcher(const fake_batcher&) = delete;
+  void operator=(const fake_batcher&) = delete;
+
+  void insert(const std::string& url, const std::string& ids) {
+    for (char c : ids)
+      batcher.insert(url, hash(c));
+  }
+
+  core::ScrapeBatcher     batcher{ nullptr, nullptr };
+  batch_list              sent;
+  std::map<char, int64_t> scraped;
+  std::string             fallbacks;
+};
+
+}
+
+TEST_F(ScrapeBatcherTest, test_scrape_url) {
+  ASSERT_EQ(core::ScrapeBatcher::scrape_url("http://a/announce"),
+            "http://a/scrape");
+  ASSERT_EQ(core::ScrapeBatcher::scrape_url("http://a/x/announce.php?k=1"),
+            "http://a/x/scrape.php?k=1");
+  ASSERT_EQ(core::ScrapeBatcher::scrape_url("http://a/a?k=announce"), "");
+  ASSERT_EQ(core::ScrapeBatcher::scrape_url("http://a/tracker"), "");
+}
+
+TEST_F(ScrapeBatcherTest, test_request_url) {
+  std::string ab = "info_hash=";
+
+  for (int i = 0; i != 20; i++)
+    ab += "%AB";
+
+  ASSERT_EQ(core::ScrapeBatcher::request_url("http://a/scrape",
+                                             hashes("\xab\xab")),
+            "http://a/scrape?" + ab + "&" + ab);
+  ASSERT_EQ(core::ScrapeBatcher::request_url("http://a/scrape?k=1",
+                                             hashes("\xab")),
+            "http://a/scrape?k=1&" + ab);
+}
+
+TEST_F(ScrapeBatcherTest, test_group) {
+  fake_batcher fake;
+
+  fake.insert("http://b/scrape", "1");
+  fake.insert("http://a/scrape", "23");
+  fake.insert("http://b/scrape", "4");
+
+  // Already queued hashes are only sent once.
+  fake.insert("http://a/scrape", "2");
+
+  ASSERT_TRUE(fake.sent.empty());
+  ASSERT_EQ(fake.batcher.size_pending(), 4);
+
+  fake.batcher.flush();
+
+  ASSERT_EQ(fake.sent,
+            (batch_list{ { "http://a/scrape", "23" },
+                         { "http://b/scrape", "14" } }));
+  ASSERT_EQ(fake.batcher.requests(), 2);
+  ASSERT_EQ(fake.batcher.size_pending(), 0);
+
+  fake.batcher.flush();
+
+  ASSERT_EQ(fake.batcher.requests(), 2);
+}
+
+TEST_F(ScrapeBatcherTest, test_split) {
+  fake_batcher fake;
+  fake.batcher.set_batch_size(2);
+
+  ASSERT_THROW(fake.batcher.set_batch_size(0), torrent::input_error);
+
+  fake.insert("http://a/scrape", "1");
+
+  ASSERT_TRUE(fake.sent.empty());
+
+  // Full batches go out right away, without waiting for the others.
+  fake.insert("http://a/scrape", "2");
+  fake.insert("http://b/scrape", "3");
+  fake.insert("http://a/scrape", "456");
+
+  ASSERT_EQ(fake.sent,
+            (batch_list{ { "http://a/scrape", "12" },
+                         { "http://a/scrape", "45" } }));
+  ASSERT_EQ(fake.batcher.size_pending(), 2);
+
+  // A hash sent earlier can be queued again.
+  fake.insert("http://a/scrape", "1");
+  fake.batcher.flush();
+
+  ASSERT_EQ(fake.sent.size(), 4);
+  ASSERT_EQ(fake.sent[2], batch_list::value_type("http://a/scrape", "61"));
+  ASSERT_EQ(fake.sent[3], batch_list::value_type("http://b/scrape", "3"));
+  ASSERT_EQ(fake.batcher.requests(), 4);
+}
+
+TEST_F(ScrapeBatcherTest, test_fallback) {
+  fake_batcher fake;
+
+  // Trackers that can't be batched fall back right away.
+  fake.insert("", "1");
+
+  ASSERT_EQ(fake.fallbacks, "1");
+  ASSERT_EQ(fake.batcher.size_pending(), 0);
+
+  // Hashes missing from the response fall back.
+  fake.batcher.receive(hashes("234"),
+                       "d5:filesd" + file_entry('2', 5) + file_entry('4', 7) +
+                         "ee");
+
+  ASSERT_EQ(fake.scraped, (std::map<char, int64_t>{ { '2', 5 }, { '4', 7 } }));
+  ASSERT_EQ(fake.fallbacks, "13");
+
+  // As do all of them when the tracker rejects the request, answers
+  // with something else or doesn't answer.
+  fake.batcher.receive(hashes("56"), "d14:failure reason6:deniede");
+
+  ASSERT_EQ(fake.fallbacks, "1356");
+
+  fake.batcher.receive(hashes("7"), "d5:filesi1ee");
+  fake.batcher.receive(hashes("8"), "<html>");
+  fake.batcher.receive_failed(hashes("9"), "Timeout was reached");
+
+  ASSERT_EQ(fake.fallbacks, "1356789");
+  ASSERT_EQ(fake.scraped.size(), 2);
+  ASSERT_EQ(fake.batcher.scraped(), 2);
+  ASSERT_EQ(fake.batcher.fallbacks(), 7);
+}
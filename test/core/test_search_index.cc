@@ -0,0 +1,144 @@
+#include <string>
+
+#include "test/core/search_index_test.h"
+
+using download_list = core::SearchIndex::download_list;
+
+namespace {
+
+// Only the addresses of the downloads are used.
+char storage[4];
+
+core::Download*
+download(int n) {
+  return reinterpret_cast<core::Download*>(storage + n);
+}
+
+// Indexes the downloads 0 to 2.
+void
+insert_all(core::SearchIndex* index) {
+  index->insert(download(0),
+                "Ubuntu 24.04 Desktop",
+                { "ubuntu-24.04-desktop-amd64.iso" });
+  index->insert(download(1),
+                "Debian 12",
+                { "debian-12/amd64/disk1.iso", "debian-12/README.txt" });
+  index->insert(download(2), "Music", { "Music/Track 01.flac" });
+}
+
+}
+
+TEST_F(SearchIndexTest, test_search) {
+  core::SearchIndex index;
+  insert_all(&index);
+
+  ASSERT_EQ(index.size(), 3);
+
+  // As 'd.search' and 'd.search.files', ignoring case.
+  ASSERT_EQ(index.search_names("DEBIAN"), download_list{ download(1) });
+  ASSERT_EQ(index.search_names("24.04 desk"), download_list{ download(0) });
+  ASSERT_EQ(index.search_names("amd64"), download_list{});
+  ASSERT_EQ(index.search_files("AMD64"),
+            (download_list{ download(0), download(1) }));
+  ASSERT_EQ(index.search_files("readme"), download_list{ download(1) });
+  ASSERT_EQ(index.search_files("track 01"), download_list{ download(2) });
+  ASSERT_EQ(index.search_files("track 02"), download_list{});
+
+  // Inserting an indexed download again is ignored.
+  index.insert(download(2), "Other", {});
+
+  ASSERT_EQ(index.size(), 3);
+  ASSERT_EQ(index.search_names("music"), download_list{ download(2) });
+  ASSERT_EQ(index.search_names("other"), download_list{});
+}
+
+TEST_F(SearchIndexTest, test_name_contains) {
+  core::SearchIndex index;
+  insert_all(&index);
+
+  // As 'd.search.name', used by view filters.
+  ASSERT_TRUE(index.name_contains(download(0), "ubuntu"));
+  ASSERT_FALSE(index.name_contains(download(1), "ubuntu"));
+  ASSERT_FALSE(index.name_contains(download(3), "ubuntu"));
+  ASSERT_TRUE(index.name_contains(download(1), "Debian 1"));
+
+  // File paths are not part of the name.
+  ASSERT_FALSE(index.name_contains(download(1), "readme"));
+}
+
+TEST_F(SearchIndexTest, test_cache) {
+  core::SearchIndex index;
+  insert_all(&index);
+
+  // A filter pass over every download searches once.
+  for (int n = 0; n != 4; n++)
+    index.name_contains(download(n), "u");
+
+  ASSERT_EQ(index.cache_misses(), 1);
+
+  index.name_contains(download(0), "music");
+  index.name_contains(download(1), "music");
+
+  ASSERT_EQ(index.cache_misses(), 2);
+
+  // Going back to an earlier query searches again.
+  ASSERT_TRUE(index.name_contains(download(0), "u"));
+  ASSERT_EQ(index.cache_misses(), 3);
+}
+
+TEST_F(SearchIndexTest, test_invalidate) {
+  core::SearchIndex index;
+  insert_all(&index);
+
+  ASSERT_FALSE(index.name_contains(download(3), "linux"));
+
+  index.insert(download(3), "Linux Mint", {});
+
+  ASSERT_TRUE(index.name_contains(download(3), "linux"));
+  ASSERT_EQ(index.cache_misses(), 2);
+
+  index.erase(download(3));
+
+  ASSERT_FALSE(index.name_contains(download(3), "linux"));
+  ASSERT_EQ(index.cache_misses(), 3);
+  ASSERT_EQ(index.search_names("linux"), download_list{});
+
+  // Erasing a download that isn't indexed changes nothing.
+  index.erase(download(3));
+  index.name_contains(download(3), "linux");
+
+  ASSERT_EQ(index.cache_misses(), 3);
+  ASSERT_EQ(index.size(), 3);
+
+  // Ids of erased downloads are reused without mixing up results.
+  index.erase(download(0));
+  index.insert(download(3), "Fedora", { "Fedora/live.iso" });
+
+  ASSERT_EQ(index.search_names("fedora"), download_list{ download(3) });
+  ASSERT_EQ(index.search_files("live"), download_list{ download(3) });
+  ASSERT_EQ(index.search_names("ubuntu"), download_list{});
+  ASSERT_EQ(index.search_files("ubuntu"), download_list{});
+}
+
+TEST_F(SearchIndexTest, test_filter_command) {
+  ASSERT_TRUE(core::SearchIndex::is_plain("debian 12"));
+  ASSERT_EQ(core::SearchIndex::filter_command("Debian 12"),
+            "d.search.name=\"Debian 12\"");
+
+  // Regex syntax, and characters that would break out of the quoted
+  // command, go through 'match' instead of the index.
+  for (const char* pattern :
+       { "deb.an", "^ubuntu", "iso$", "a|b", "a*", "(a)", "[ab]", "a{2}",
+         "a\\d", "a+", "a?", "a\"b", "a,b", "a;b" }) {
+    ASSERT_FALSE(core::SearchIndex::is_plain(pattern)) << pattern;
+    ASSERT_EQ(core::SearchIndex::filter_command(pattern).rfind("match=", 0), 0)
+      << pattern;
+  }
+
+  ASSERT_EQ(core::SearchIndex::filter_command("Deb.an"),
+            "match={d.name=,.*deb.an.*}");
+  ASSERT_EQ(core::SearchIndex::filter_command("^Ubuntu"),
+            "match={d.name=,^ubuntu.*}");
+  ASSERT_EQ(core::SearchIndex::filter_command("ISO$"),
+            "match={d.name=,.*iso$}");
+}
@@ -0,0 +1,121 @@
+#include <vector>
+
+#include "test/core/throttle_shaper_test.h"
+
+using share_type = core::ThrottleShaper::share_type;
+
+static constexpr uint64_t unlimited = core::ThrottleShaper::unlimited;
+
+static std::vector<uint64_t>
+split(uint64_t                       capacity,
+      const std::vector<share_type>& shares,
+      uint64_t*                      remaining = nullptr) {
+  std::vector<uint64_t> allotted;
+  uint64_t left = core::ThrottleShaper::split(capacity, shares, &allotted);
+
+  if (remaining != nullptr)
+    *remaining = left;
+
+  return allotted;
+}
+
+TEST_F(ThrottleShaperTest, test_weights) {
+  auto allotted = split(100,
+                        { share_type{ 3, 0, unlimited, unlimited },
+                          share_type{ 1, 0, unlimited, unlimited } });
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 75, 25 }));
+}
+
+TEST_F(ThrottleShaperTest, test_guaranteed) {
+  auto allotted = split(100,
+                        { share_type{ 1, 30, unlimited, unlimited },
+                          share_type{ 3, 30, unlimited, unlimited } });
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 40, 60 }));
+
+  // A guarantee beyond demand is only held up to the demand.
+  allotted = split(100,
+                   { share_type{ 1, 50, 10, unlimited },
+                     share_type{ 1, 0, unlimited, unlimited } });
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 10, 90 }));
+
+  // Guarantees beyond the capacity are scaled down evenly.
+  allotted = split(200,
+                   { share_type{ 1, 100, unlimited, unlimited },
+                     share_type{ 1, 300, unlimited, unlimited } });
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 50, 150 }));
+}
+
+TEST_F(ThrottleShaperTest, test_borrow) {
+  // Idle classes lend what they don't need to busy ones.
+  auto allotted = split(100,
+                        { share_type{ 1, 0, 10, unlimited },
+                          share_type{ 1, 0, unlimited, unlimited },
+                          share_type{ 1, 0, 20, unlimited } });
+
+  ASSERT_EQ(allotted[0], 10);
+  ASSERT_EQ(allotted[2], 20);
+  ASSERT_EQ(allotted[1], 70);
+
+  // Without busy classes, the rest is shared up to the ceilings.
+  allotted = split(100,
+                   { share_type{ 1, 0, 10, unlimited },
+                     share_type{ 1, 0, 10, 30 } });
+
+  ASSERT_EQ(allotted[1], 30);
+  ASSERT_EQ(allotted[0], 70);
+}
+
+TEST_F(ThrottleShaperTest, test_ceiling) {
+  uint64_t remaining;
+  auto     allotted = split(100,
+                        { share_type{ 1, 0, unlimited, 20 },
+                          share_type{ 1, 0, unlimited, unlimited } },
+                        &remaining);
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 20, 80 }));
+  ASSERT_EQ(remaining, 0);
+
+  // What no one can take is returned.
+  allotted = split(100,
+                   { share_type{ 1, 0, unlimited, 10 },
+                     share_type{ 1, 50, unlimited, 20 } },
+                   &remaining);
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 10, 20 }));
+  ASSERT_EQ(remaining, 70);
+}
+
+TEST_F(ThrottleShaperTest, test_unlimited) {
+  uint64_t remaining;
+  auto     allotted = split(unlimited,
+                        { share_type{ 1, 0, 10, 30 },
+                          share_type{ 1, 0, unlimited, unlimited } },
+                        &remaining);
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 30, unlimited }));
+  ASSERT_EQ(remaining, unlimited);
+}
+
+TEST_F(ThrottleShaperTest, test_own_downloads) {
+  // Downloads attached to an interior class are split in with a
+  // ceiling at their demand, then get what remains.
+  uint64_t remaining;
+  auto     allotted = split(100,
+                        { share_type{ 1, 0, unlimited, unlimited },
+                          share_type{ 1, 0, 30, 30 } },
+                        &remaining);
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 70, 30 }));
+  ASSERT_EQ(remaining, 0);
+
+  allotted = split(100,
+                   { share_type{ 1, 0, 10, 40 }, share_type{ 1, 0, 0, 0 } },
+                   &remaining);
+
+  ASSERT_EQ(allotted, (std::vector<uint64_t>{ 40, 0 }));
+  ASSERT_EQ(remaining, 60);
+}
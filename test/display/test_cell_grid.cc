@@ -0,0 +1,137 @@
+#include <clocale>
+#include <cstdio>
+#include <string>
+
+#include "test/display/cell_grid_test.h"
+
+namespace {
+
+std::string
+line_text(const display::CellGrid& grid, unsigned int y) {
+  std::string text;
+
+  for (unsigned int x = 0; x < grid.width(); x++)
+    text.append(grid.cell(x, y).glyph, grid.cell(x, y).length);
+
+  return text;
+}
+
+void
+write(display::CellGrid& grid, const std::string& text) {
+  grid.write(text.data(), text.data() + text.size());
+}
+
+}
+
+TEST_F(CellGridTest, test_write) {
+  display::CellGrid grid;
+  grid.resize(8, 3);
+
+  write(grid, "abc\tde");
+  ASSERT_EQ(line_text(grid, 0), "abc     ");
+  ASSERT_EQ(line_text(grid, 1), "de      ");
+  ASSERT_EQ(grid.cursor_x(), 2);
+  ASSERT_EQ(grid.cursor_y(), 1);
+
+  grid.move(6, 1);
+  write(grid, "xyz\x01");
+  ASSERT_EQ(line_text(grid, 1), "de    xy");
+  ASSERT_EQ(line_text(grid, 2), "z^A     ");
+
+  // Nothing is written below the last line.
+  grid.move(7, 2);
+  write(grid, "12345");
+  ASSERT_EQ(line_text(grid, 2), "z^A    1");
+
+  grid.move(1, 0);
+  grid.clear_to_eol();
+  ASSERT_EQ(line_text(grid, 0), "a       ");
+
+  grid.erase();
+  ASSERT_EQ(line_text(grid, 1), "        ");
+  ASSERT_EQ(grid.cursor_x(), 0);
+  ASSERT_EQ(grid.cursor_y(), 0);
+}
+
+TEST_F(CellGridTest, test_attributes) {
+  display::CellGrid grid;
+  grid.resize(6, 1);
+
+  grid.set_attributes(A_BOLD, 2);
+  write(grid, "ab");
+  grid.set_attributes(A_NORMAL, 0);
+  write(grid, "cd");
+
+  ASSERT_EQ(grid.cell(1, 0).attr, A_BOLD);
+  ASSERT_EQ(grid.cell(1, 0).color, 2);
+  ASSERT_EQ(grid.cell(2, 0).attr, A_NORMAL);
+
+  grid.change_attributes(1, 0, -1, A_REVERSE, 3);
+  ASSERT_EQ(grid.cell(0, 0).attr, A_BOLD);
+  ASSERT_EQ(grid.cell(1, 0).attr, A_REVERSE);
+  ASSERT_EQ(grid.cell(5, 0).color, 3);
+  ASSERT_EQ(line_text(grid, 0), "abcd  ");
+}
+
+TEST_F(CellGridTest, test_wide_characters) {
+  if (std::setlocale(LC_CTYPE, "C.UTF-8") == nullptr)
+    GTEST_SKIP() << "No UTF-8 locale available.";
+
+  display::CellGrid grid;
+  grid.resize(4, 2);
+
+  // Two double width characters, the second one doesn't fit.
+  write(grid, "a\xe6\x97\xa5\xe6\x9c\xac");
+  ASSERT_EQ(grid.cell(2, 0).length, 0);
+  ASSERT_EQ(line_text(grid, 0), "a\xe6\x97\xa5 ");
+  ASSERT_EQ(line_text(grid, 1), "\xe6\x9c\xac  ");
+
+  // Overwriting the second half blanks the first.
+  grid.move(2, 0);
+  write(grid, "x");
+  ASSERT_EQ(line_text(grid, 0), "a x ");
+
+  // Combining characters stay with the cell before them, invalid
+  // sequences become '?'.
+  grid.move(0, 0);
+  write(grid, "e\xcc\x81\xff");
+  ASSERT_EQ(line_text(grid, 0), "e\xcc\x81?x ");
+
+  std::setlocale(LC_CTYPE, "C");
+}
+
+TEST_F(CellGridTest, test_flush) {
+  FILE*   output = std::fopen("/dev/null", "w");
+  SCREEN* screen = newterm("xterm", output, stdin);
+
+  if (screen == nullptr) {
+    std::fclose(output);
+    GTEST_SKIP() << "No terminal description for xterm.";
+  }
+
+  WINDOW* window = newwin(4, 10, 0, 0);
+
+  display::CellGrid grid;
+  grid.resize(10, 4);
+
+  write(grid, "hello");
+  ASSERT_EQ(grid.flush(window), 40);
+  ASSERT_EQ(grid.flush(window), 0);
+
+  // Only the changed cells are written.
+  grid.erase();
+  write(grid, "help");
+  ASSERT_EQ(grid.flush(window), 2);
+
+  char text[11];
+  mvwinnstr(window, 0, 0, text, 10);
+  ASSERT_STREQ(text, "help      ");
+
+  grid.invalidate();
+  ASSERT_EQ(grid.flush(window), 40);
+
+  delwin(window);
+  endwin();
+  delscreen(screen);
+  std::fclose(output);
+}
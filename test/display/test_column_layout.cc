@@ -0,0 +1,65 @@
+#include <cstring>
+#include <string>
+
+#include <torrent/exceptions.h>
+
+#include "test/display/column_layout_test.h"
+
+namespace {
+
+std::string
+header(const display::ColumnLayout& layout, size_t width = 512) {
+  char  buffer[512];
+  char* last = layout.print_header(buffer, buffer + width);
+
+  EXPECT_LE(last, buffer + width);
+  return std::string(buffer, std::strlen(buffer));
+}
+
+}
+
+TEST_F(ColumnLayoutTest, test_default) {
+  display::ColumnLayout layout(display::ColumnLayout::default_columns);
+
+  ASSERT_EQ(layout.size(), 11);
+  ASSERT_EQ(layout.spec(), display::ColumnLayout::default_columns);
+  ASSERT_EQ(display::ColumnLayout::column_names(),
+            display::ColumnLayout::default_columns);
+
+  // Every column is as wide as its header, so the rows line up.
+  ASSERT_EQ(header(layout).size(), 170);
+}
+
+TEST_F(ColumnLayoutTest, test_widths) {
+  ASSERT_EQ(header(display::ColumnLayout("name")).size(), 65);
+  ASSERT_EQ(header(display::ColumnLayout("status")), "| Status ");
+  ASSERT_EQ(header(display::ColumnLayout("done")), "| Done ");
+  ASSERT_EQ(header(display::ColumnLayout("ratio")), "| Ratio");
+
+  // Columns are laid out in the order given, repeats included.
+  ASSERT_EQ(header(display::ColumnLayout("ratio,done,ratio")),
+            "| Ratio| Done | Ratio");
+  ASSERT_EQ(header(display::ColumnLayout("up_rate,down_rate")),
+            "| Up Rate   | Down Rate ");
+}
+
+TEST_F(ColumnLayoutTest, test_truncate) {
+  display::ColumnLayout layout("status,done,ratio");
+
+  // Narrower than the layout, the header is cut off at the buffer.
+  ASSERT_EQ(header(layout, 13), "| Status | D");
+  ASSERT_EQ(header(layout, 1), "");
+
+  // The buffer needs room for the terminator.
+  ASSERT_EQ(header(layout, 23), "| Status | Done | Rati");
+  ASSERT_EQ(header(layout, 24), "| Status | Done | Ratio");
+}
+
+TEST_F(ColumnLayoutTest, test_invalid) {
+  ASSERT_THROW(display::ColumnLayout(""), torrent::input_error);
+  ASSERT_THROW(display::ColumnLayout("name,"), torrent::input_error);
+  ASSERT_THROW(display::ColumnLayout(",name"), torrent::input_error);
+  ASSERT_THROW(display::ColumnLayout("name,,done"), torrent::input_error);
+  ASSERT_THROW(display::ColumnLayout("name,unknown"), torrent::input_error);
+  ASSERT_THROW(display::ColumnLayout("Name"), torrent::input_error);
+}
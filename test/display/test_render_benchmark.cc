@@ -0,0 +1,228 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <torrent/object.h>
+#include <torrent/poll.h>
+#include <torrent/torrent.h>
+
+#include "control.h"
+#include "core/download_list.h"
+#include "core/manager.h"
+#include "core/poll_manager.h"
+#include "core/view.h"
+#include "display/canvas.h"
+#include "display/window_download_list.h"
+#include "display/window_file_list.h"
+#include "display/window_peer_list.h"
+#include "display/window_statusbar.h"
+#include "globals.h"
+#include "rpc/parse_commands.h"
+#include "ui/element_file_list.h"
+#include "utils/latency_histogram.h"
+
+#include "test/display/render_benchmark_test.h"
+
+void
+initialize_command_logic();
+void
+initialize_command_dynamic();
+
+// Counts every operator new, so frames can be checked for allocations.
+// This replaces the global operator, which is why the benchmark is
+// built as a binary of its own. Allocations made by ncurses itself
+// aren't seen.
+static std::atomic<uint64_t> allocations{ 0 };
+
+void*
+operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (void* ptr = std::malloc(size != 0 ? size : 1))
+    return ptr;
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+static constexpr int      screen_width   = 200;
+static constexpr int      screen_height  = 60;
+static constexpr uint32_t download_count = 5000;
+static constexpr uint32_t file_count     = 64;
+static constexpr uint32_t frame_count    = 1000;
+
+static FILE* output = nullptr;
+
+// A multi-file torrent of 3 MiB files spread over a few directories.
+static torrent::Object*
+make_torrent(uint32_t index) {
+  constexpr int64_t piece_length = 1 << 18;
+  constexpr int64_t file_length  = 3 << 20;
+
+  auto*            torrent = new torrent::Object(torrent::Object::create_map());
+  torrent::Object& info =
+    torrent->insert_key("info", torrent::Object::create_map());
+
+  info.insert_key("name", "benchmark.download." + std::to_string(index));
+  info.insert_key("piece length", piece_length);
+
+  torrent::Object& files =
+    info.insert_key("files", torrent::Object::create_list());
+
+  for (uint32_t i = 0; i < file_count; i++) {
+    files.as_list().push_back(torrent::Object::create_map());
+
+    torrent::Object& file = files.as_list().back();
+    file.insert_key("length", file_length);
+
+    torrent::Object& path =
+      file.insert_key("path", torrent::Object::create_list());
+    path.as_list().push_back("directory." + std::to_string(i % 8));
+    path.as_list().push_back("file." + std::to_string(i) + ".bin");
+  }
+
+  int64_t pieces = file_count * file_length / piece_length;
+  info.insert_key("pieces", std::string(20 * pieces, '\0'));
+
+  return torrent;
+}
+
+void
+RenderBenchmarkTest::SetUp() {
+  if (rpc::commands.empty()) {
+    setlocale(LC_ALL, "");
+    cachedTime = torrent::utils::timer::current();
+    control    = new Control;
+
+    initialize_command_logic();
+    initialize_command_dynamic();
+  }
+
+  static bool initialized = false;
+
+  if (!initialized) {
+    initialized = true;
+
+    torrent::Poll::slot_create_poll() = [] { return core::create_poll(); };
+    torrent::initialize();
+
+    // Frames are driven by the benchmark rather than the scheduler.
+    display::Window::slot_schedule(
+      [](display::Window*, torrent::utils::timer) {});
+    display::Window::slot_unschedule([](display::Window*) {});
+
+    core::DownloadList* downloads = control->core()->download_list();
+
+    for (uint32_t i = 0; i < download_count; i++)
+      downloads->insert(downloads->create(make_torrent(i)));
+  }
+
+  output = std::fopen("/dev/null", "w");
+  display::Canvas::initialize_headless(output, screen_width, screen_height);
+}
+
+void
+RenderBenchmarkTest::TearDown() {
+  display::Canvas::cleanup();
+  std::fclose(output);
+}
+
+// Redraws the window once per frame, refreshing the screen as the
+// display manager would, after calling 'step' to change what is shown.
+static void
+benchmark_window(const char*                  name,
+                 display::Window*             window,
+                 const std::function<void()>& step) {
+  utils::LatencyHistogram histogram;
+  uint64_t                totalNsec   = 0;
+  uint64_t                totalAllocs = 0;
+
+  for (uint32_t i = 0; i < frame_count; i++) {
+    step();
+    cachedTime = cachedTime + torrent::utils::timer::from_seconds(1);
+
+    uint64_t before = allocations.load(std::memory_order_relaxed);
+    auto     start  = std::chrono::steady_clock::now();
+
+    window->redraw();
+    window->refresh();
+    display::Canvas::do_update();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    totalAllocs += allocations.load(std::memory_order_relaxed) - before;
+    totalNsec +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    histogram.insert(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  }
+
+  std::cout << name << ": " << totalNsec / frame_count / 1000.0
+            << " us/frame, p99 " << histogram.percentile(99) << " us, "
+            << double(totalAllocs) / frame_count << " allocs/frame"
+            << std::endl;
+}
+
+// Run with --gtest_also_run_disabled_tests to print the cost of a
+// frame for each window, drawn to /dev/null.
+TEST_F(RenderBenchmarkTest, DISABLED_benchmark_windows) {
+  core::View view;
+  view.initialize("benchmark");
+
+  ASSERT_EQ(view.size(), download_count);
+
+  {
+    display::WindowDownloadList window;
+    window.resize(0, 0, screen_width, screen_height);
+    window.set_view(&view);
+
+    benchmark_window("download list, unchanged", &window, [] {});
+    benchmark_window("download list, scrolling", &window, [&view] {
+      view.next_focus();
+    });
+  }
+
+  {
+    display::WindowStatusbar window;
+    window.resize(0, 0, screen_width, 1);
+
+    benchmark_window("statusbar", &window, [] {});
+  }
+
+  core::Download* download = *view.begin_visible();
+
+  {
+    // Synthetic downloads have no peers to construct, so this only
+    // covers the fixed cost of the window.
+    display::WindowPeerList::PList           peers;
+    display::WindowPeerList::PList::iterator focus = peers.end();
+    display::WindowPeerList                  window(download, &peers, &focus);
+    window.resize(0, 0, screen_width, screen_height);
+
+    benchmark_window("peer list, empty", &window, [] {});
+  }
+
+  {
+    ui::ElementFileList     element(download);
+    display::WindowFileList window(&element);
+    window.resize(0, 0, screen_width, screen_height);
+
+    benchmark_window("file list", &window, [] {});
+
+    element.set_collapsed(true);
+    benchmark_window("file list, collapsed", &window, [] {});
+  }
+}
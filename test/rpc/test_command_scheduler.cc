@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <clocale>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "command_helpers.h"
+#include "control.h"
+#include "globals.h"
+#include "rpc/command_scheduler_item.h"
+#include "rpc/parse_commands.h"
+#include "test/rpc/command_scheduler_test.h"
+
+void
+initialize_command_logic();
+void
+initialize_command_dynamic();
+
+namespace {
+
+using fired_list = std::vector<std::pair<std::string, uint64_t>>;
+
+// Aligned to every level of the wheel and later than any real time.
+constexpr uint64_t base_time = uint64_t(128) << 24;
+
+constexpr uint64_t level_span[] = { 1, 64, 64 * 64, 64 * 64 * 64 };
+constexpr uint64_t wheel_span   = 64 * 64 * 64 * 64;
+
+fired_list fired;
+
+rpc::CommandSchedulerItem*
+schedule(rpc::CommandScheduler* scheduler,
+         const std::string&     key,
+         uint64_t               time,
+         uint32_t               interval = 0) {
+  rpc::CommandSchedulerItem* item = scheduler->insert(key)->second;
+
+  item->command() = "test_scheduler.fire=" + key;
+  item->set_interval(interval);
+
+  scheduler->enable(item, torrent::utils::timer::from_seconds(time));
+  return item;
+}
+
+// Wakes up for each task like the main loop does, until 'last'.
+void
+run_until(uint64_t last) {
+  torrent::utils::timer end = torrent::utils::timer::from_seconds(last);
+
+  while (!taskScheduler.empty() && taskScheduler.top()->time() <= end) {
+    cachedTime = std::max(cachedTime, taskScheduler.top()->time());
+    torrent::utils::priority_queue_perform(&taskScheduler, cachedTime);
+  }
+
+  cachedTime = end;
+}
+
+}
+
+void
+CommandSchedulerTest::SetUp() {
+  if (rpc::commands.empty()) {
+    setlocale(LC_ALL, "");
+    cachedTime = torrent::utils::timer::current();
+    control    = new Control;
+
+    initialize_command_logic();
+    initialize_command_dynamic();
+  }
+
+  if (rpc::commands.find("test_scheduler.fire") == rpc::commands.end())
+    CMD2_ANY_STRING_V("test_scheduler.fire",
+                      [](const auto&, const std::string& key) {
+                        fired.emplace_back(key, cachedTime.seconds());
+                      });
+
+  fired.clear();
+  cachedTime = torrent::utils::timer::from_seconds(base_time);
+}
+
+void
+CommandSchedulerTest::TearDown() {
+  cachedTime = torrent::utils::timer::current();
+}
+
+TEST_F(CommandSchedulerTest, test_cascade) {
+  rpc::CommandScheduler scheduler;
+  fired_list            expected;
+
+  // Start away from the level boundaries, then place items on either
+  // side of where each level begins.
+  uint64_t start = base_time + 37;
+  cachedTime     = torrent::utils::timer::from_seconds(start);
+
+  for (uint64_t span : level_span) {
+    for (uint64_t offset : { span - 1, span, span + 1 }) {
+      if (offset == 0)
+        continue;
+
+      std::string key = "item." + std::to_string(offset);
+
+      schedule(&scheduler, key, start + offset);
+      expected.emplace_back(key, start + offset);
+    }
+  }
+
+  // And the ones where the lower levels wrap around.
+  for (uint64_t span : level_span) {
+    std::string key = "wrap." + std::to_string(span);
+
+    schedule(&scheduler, key, base_time + span * 64);
+    expected.emplace_back(key, base_time + span * 64);
+  }
+
+  std::sort(expected.begin(), expected.end(), [](auto& a, auto& b) {
+    return a.second < b.second;
+  });
+
+  ASSERT_EQ(scheduler.size_queued(), expected.size());
+
+  run_until(base_time + wheel_span + 64);
+
+  ASSERT_EQ(fired, expected);
+  ASSERT_EQ(scheduler.size_queued(), 0);
+}
+
+TEST_F(CommandSchedulerTest, test_rearm) {
+  rpc::CommandScheduler      scheduler;
+  rpc::CommandSchedulerItem* early =
+    schedule(&scheduler, "early", base_time + 50);
+  rpc::CommandSchedulerItem* late =
+    schedule(&scheduler, "late", base_time + 50);
+
+  // Moving queued items, earlier and to a higher level of the wheel.
+  scheduler.enable(early, torrent::utils::timer::from_seconds(base_time + 5));
+  scheduler.enable(late,
+                   torrent::utils::timer::from_seconds(base_time + 5000));
+
+  ASSERT_EQ(scheduler.size_queued(), 2);
+
+  schedule(&scheduler, "disabled", base_time + 10);
+  scheduler.disable(scheduler.find("disabled")->second);
+
+  // Replacing a key drops the old item.
+  schedule(&scheduler, "replaced", base_time + 20);
+  schedule(&scheduler, "replaced", base_time + 30);
+
+  ASSERT_EQ(scheduler.size_queued(), 3);
+
+  run_until(base_time + 10000);
+
+  ASSERT_EQ(fired,
+            (fired_list{ { "early", base_time + 5 },
+                         { "replaced", base_time + 30 },
+                         { "late", base_time + 5000 } }));
+}
+
+TEST_F(CommandSchedulerTest, test_beyond_wheel) {
+  rpc::CommandScheduler scheduler;
+
+  // Further out than the top level covers, both for the first call
+  // and the interval.
+  uint64_t first    = base_time + wheel_span + 123;
+  uint32_t interval = wheel_span + 7;
+
+  rpc::CommandSchedulerItem* item =
+    schedule(&scheduler, "far", first, interval);
+
+  run_until(first - 1);
+  ASSERT_TRUE(fired.empty());
+
+  run_until(first + interval);
+
+  ASSERT_EQ(fired,
+            (fired_list{ { "far", first }, { "far", first + interval } }));
+  ASSERT_EQ(item->time_scheduled().seconds(), first + 2 * interval);
+}
+
+TEST_F(CommandSchedulerTest, test_same_tick) {
+  rpc::CommandScheduler scheduler;
+  uint64_t              due = base_time + 2 * 4096 + 100;
+
+  // Enabled far ahead, these are cascaded down through the levels...
+  schedule(&scheduler, "a", due);
+  schedule(&scheduler, "b", due);
+  schedule(&scheduler, "tick", due - 60);
+
+  // ...while this one goes straight to the lowest level before the
+  // others have been cascaded into it.
+  run_until(due - 60);
+  schedule(&scheduler, "c", due);
+
+  run_until(due - 3);
+  schedule(&scheduler, "d", due);
+  schedule(&scheduler, "e", due);
+
+  run_until(due);
+
+  ASSERT_EQ(fired,
+            (fired_list{ { "tick", due - 60 },
+                         { "a", due },
+                         { "b", due },
+                         { "c", due },
+                         { "d", due },
+                         { "e", due } }));
+}
+
+TEST_F(CommandSchedulerTest, test_next_time_scheduled) {
+  rpc::CommandScheduler      scheduler;
+  rpc::CommandSchedulerItem* item =
+    schedule(&scheduler, "interval", base_time + 10, 30);
+
+  uint64_t next = item->time_scheduled().seconds();
+
+  for (size_t i = 0; i != 5; i++) {
+    // What the item will be rescheduled to when called now.
+    cachedTime         = torrent::utils::timer::from_seconds(next);
+    uint64_t predicted = item->next_time_scheduled().seconds();
+
+    run_until(predicted - 1);
+
+    ASSERT_EQ(fired.size(), i + 1);
+    ASSERT_EQ(fired.back().second, next);
+    ASSERT_EQ(item->time_scheduled().seconds(), predicted);
+
+    next = predicted;
+  }
+
+  // Waking up late skips the missed intervals, and the item then
+  // fires when it said it would.
+  fired.clear();
+
+  uint64_t late      = next + 95;
+  cachedTime         = torrent::utils::timer::from_seconds(late);
+  uint64_t predicted = item->next_time_scheduled().seconds();
+
+  ASSERT_GT(predicted, late);
+  ASSERT_LE(predicted, late + 30);
+
+  torrent::utils::priority_queue_perform(&taskScheduler, cachedTime);
+
+  ASSERT_EQ(fired, (fired_list{ { "interval", late } }));
+  ASSERT_EQ(item->time_scheduled().seconds(), predicted);
+
+  run_until(predicted);
+
+  ASSERT_EQ(fired,
+            (fired_list{ { "interval", late }, { "interval", predicted } }));
+}
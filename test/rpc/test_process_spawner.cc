@@ -0,0 +1,142 @@
+#include <climits>
+#include <cstdlib>
+#include <poll.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "test/rpc/process_spawner_test.h"
+
+namespace {
+
+// Runs the command synchronously, returning its wait status and
+// putting its standard output in 'output'.
+int
+run(rpc::ProcessSpawner* spawner,
+    std::vector<std::string> args,
+    std::string*             output = nullptr) {
+  std::vector<char*> argv;
+
+  for (auto& arg : args)
+    argv.push_back(&arg[0]);
+
+  argv.push_back(nullptr);
+
+  int pipeFd[2];
+  EXPECT_EQ(pipe(pipeFd), 0);
+
+  int replyFd = spawner->spawn(argv.data(), pipeFd[1]);
+  ::close(pipeFd[1]);
+
+  char    buffer[256];
+  ssize_t length;
+
+  while ((length = read(pipeFd[0], buffer, sizeof(buffer))) > 0)
+    if (output != nullptr)
+      output->append(buffer, length);
+
+  ::close(pipeFd[0]);
+
+  int      status      = -1;
+  uint64_t elapsedUsec = 0;
+
+  EXPECT_TRUE(spawner->wait(replyFd, &status, &elapsedUsec));
+  return status;
+}
+
+// Handles replies to background commands until none are running.
+void
+wait_async(rpc::ProcessSpawner* spawner) {
+  while (spawner->size_running() != 0 || spawner->size_queued() != 0) {
+    pollfd fd{ spawner->file_descriptor(), POLLIN, 0 };
+
+    ASSERT_EQ(poll(&fd, 1, 5000), 1);
+    spawner->event_read();
+  }
+}
+
+}
+
+TEST_F(ProcessSpawnerTest, test_exit_status) {
+  rpc::ProcessSpawner spawner;
+  spawner.open();
+  ASSERT_TRUE(spawner.is_open());
+
+  int status = run(&spawner, { "sh", "-c", "exit 3" });
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 3);
+
+  status = run(&spawner, { "sh", "-c", "kill -TERM $$" });
+  ASSERT_TRUE(WIFSIGNALED(status));
+  ASSERT_EQ(WTERMSIG(status), SIGTERM);
+
+  status = run(&spawner, { "/nonexistent/command" });
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_NE(WEXITSTATUS(status), 0);
+
+  spawner.close();
+  ASSERT_FALSE(spawner.is_open());
+}
+
+TEST_F(ProcessSpawnerTest, test_capture) {
+  rpc::ProcessSpawner spawner;
+  spawner.open();
+
+  std::string output;
+  ASSERT_EQ(run(&spawner, { "echo", "a b", "", "c" }, &output), 0);
+  ASSERT_EQ(output, "a b  c\n");
+}
+
+TEST_F(ProcessSpawnerTest, test_cwd_and_umask) {
+  rpc::ProcessSpawner spawner;
+  spawner.open();
+
+  char saved[PATH_MAX];
+  ASSERT_NE(getcwd(saved, sizeof(saved)), nullptr);
+
+  // Changes made by the client after the helper was forked apply.
+  ASSERT_EQ(chdir("/"), 0);
+  spawner.set_umask(027);
+
+  std::string output;
+  int         status = run(&spawner, { "sh", "-c", "pwd; umask" }, &output);
+
+  ASSERT_EQ(chdir(saved), 0);
+  ASSERT_EQ(status, 0);
+  ASSERT_EQ(output, "/\n0027\n");
+}
+
+TEST_F(ProcessSpawnerTest, test_async) {
+  rpc::ProcessSpawner spawner;
+  spawner.open();
+  spawner.set_max_running(2);
+
+  for (int i = 0; i != 5; i++)
+    spawner.execute_async({ "sh", "-c", i == 4 ? "exit 1" : "exit 0" });
+
+  ASSERT_EQ(spawner.size_running(), 2);
+  ASSERT_EQ(spawner.size_queued(), 3);
+
+  wait_async(&spawner);
+
+  ASSERT_EQ(spawner.stats().at("sh").count, 5);
+  ASSERT_EQ(spawner.stats().at("sh").failed, 1);
+}
+
+TEST_F(ProcessSpawnerTest, test_async_session) {
+  if (access("/proc/self/stat", R_OK) != 0)
+    GTEST_SKIP() << "No /proc to read the session from.";
+
+  rpc::ProcessSpawner spawner;
+  spawner.open();
+
+  // Background commands lead a session of their own, the sixth field
+  // of /proc/<pid>/stat.
+  spawner.execute_async(
+    { "sh", "-c", "test \"$(cut -d' ' -f6 /proc/$$/stat)\" -eq $$" });
+  wait_async(&spawner);
+
+  ASSERT_EQ(spawner.stats().at("sh").failed, 0);
+}
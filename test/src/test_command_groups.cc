@@ -0,0 +1,164 @@
+#include <clocale>
+#include <string>
+
+#include <torrent/exceptions.h>
+
+#include "control.h"
+#include "core/choke_group_manager.h"
+#include "core/manager.h"
+#include "globals.h"
+#include "rpc/parse_commands.h"
+#include "test/src/command_groups_test.h"
+
+void
+initialize_command_logic();
+void
+initialize_command_dynamic();
+void
+initialize_command_groups();
+
+namespace {
+
+struct fake_download {
+  uint32_t group;
+  uint64_t up_rate;
+};
+
+torrent::Object
+call(const char* key, const torrent::Object& args) {
+  return rpc::commands.call_command(key, args);
+}
+
+int64_t
+index_of(const std::string& name) {
+  return call("choke_group.index_of", name).as_value();
+}
+
+}
+
+void
+CommandGroupsTest::SetUp() {
+  if (rpc::commands.empty()) {
+    setlocale(LC_ALL, "");
+    cachedTime = torrent::utils::timer::current();
+    control    = new Control;
+
+    initialize_command_logic();
+    initialize_command_dynamic();
+  }
+
+  if (!rpc::commands.has("choke_group.list"))
+    initialize_command_groups();
+}
+
+TEST_F(CommandGroupsTest, test_insert_erase) {
+  int64_t size = call("choke_group.size", torrent::Object()).as_value();
+
+  call("choke_group.insert", "test_erase.a");
+  call("choke_group.insert", "test_erase.b");
+
+  ASSERT_EQ(index_of("test_erase.a"), size);
+  ASSERT_EQ(index_of("test_erase.b"), size + 1);
+  ASSERT_EQ(
+    call("choke_group.list", torrent::Object()).as_list().back().as_string(),
+    "test_erase.b");
+
+  call("choke_group.erase", "test_erase.a");
+
+  ASSERT_EQ(index_of("test_erase.b"), size);
+  ASSERT_EQ(call("choke_group.size", torrent::Object()).as_value(), size + 1);
+  ASSERT_THROW(index_of("test_erase.a"), torrent::input_error);
+  ASSERT_THROW(call("choke_group.erase", "test_erase.a"),
+               torrent::input_error);
+
+  // The default group takes the members of erased groups.
+  ASSERT_THROW(call("choke_group.erase", "default"), torrent::input_error);
+  ASSERT_THROW(call("choke_group.erase", int64_t(0)), torrent::input_error);
+
+  call("choke_group.erase", int64_t(-1));
+
+  ASSERT_EQ(call("choke_group.size", torrent::Object()).as_value(), size);
+}
+
+TEST_F(CommandGroupsTest, test_rename) {
+  call("choke_group.insert", "test_rename.a");
+
+  int64_t index = index_of("test_rename.a");
+
+  call("choke_group.rename",
+       rpc::create_object_list("test_rename.a", "test_rename.b"));
+
+  ASSERT_EQ(index_of("test_rename.b"), index);
+  ASSERT_THROW(index_of("test_rename.a"), torrent::input_error);
+  ASSERT_EQ(call("choke_group.stats", index).get_key_string("name"),
+            "test_rename.b");
+
+  ASSERT_THROW(
+    call("choke_group.rename", rpc::create_object_list("test_rename.b", "5")),
+    torrent::input_error);
+  ASSERT_THROW(call("choke_group.rename",
+                    rpc::create_object_list("test_rename.b", "default")),
+               torrent::input_error);
+  ASSERT_THROW(call("choke_group.rename", "test_rename.b"),
+               torrent::input_error);
+  ASSERT_EQ(index_of("test_rename.b"), index);
+
+  call("choke_group.erase", "test_rename.b");
+}
+
+TEST_F(CommandGroupsTest, test_stats) {
+  core::ChokeGroupManager* manager = control->core()->choke_group_manager();
+
+  call("choke_group.insert", "test_stats.a");
+
+  int64_t index = index_of("test_stats.a");
+
+  ASSERT_TRUE(call("choke_group.members", "test_stats.a").as_list().empty());
+
+  torrent::Object stats = call("choke_group.stats", "test_stats.a");
+
+  ASSERT_EQ(stats.get_key_string("name"), "test_stats.a");
+  ASSERT_EQ(stats.get_key_value("members"), 0);
+  ASSERT_EQ(stats.get_key_value("up_rate"), 0);
+
+  // Members are tracked by the manager, so fake downloads show up in
+  // the aggregates without a libtorrent download behind them.
+  fake_download downloads[] = { { 0, 100 }, { 0, 20 } };
+
+  manager->set_slot_group([](core::Download* d) {
+    return reinterpret_cast<fake_download*>(d)->group;
+  });
+  manager->set_slot_set_group([](core::Download* d, uint32_t group) {
+    reinterpret_cast<fake_download*>(d)->group = group;
+  });
+  manager->set_slot_stats(
+    [](core::Download* d, core::ChokeGroupManager::group_stats& stats) {
+      stats.up_rate += reinterpret_cast<fake_download*>(d)->up_rate;
+    });
+
+  for (auto& download : downloads)
+    manager->set_group(reinterpret_cast<core::Download*>(&download), index);
+
+  stats = call("choke_group.stats", "test_stats.a");
+
+  ASSERT_EQ(stats.get_key_value("members"), 2);
+  ASSERT_EQ(stats.get_key_value("up_rate"), 120);
+  ASSERT_EQ(call("choke_group.up.rate", "test_stats.a").as_value(), 120);
+  ASSERT_EQ(call("choke_group.general.size", "test_stats.a").as_value(), 2);
+
+  torrent::Object::list_type all =
+    call("choke_group.stats.all", torrent::Object()).as_list();
+
+  ASSERT_EQ(all.size(), (size_t)index + 1);
+  ASSERT_EQ(all.back().get_key_value("members"), 2);
+
+  for (auto& download : downloads)
+    manager->erase(reinterpret_cast<core::Download*>(&download));
+
+  call("choke_group.erase", "test_stats.a");
+
+  ASSERT_THROW(call("choke_group.stats", "test_stats.a"),
+               torrent::input_error);
+  ASSERT_THROW(call("choke_group.members", int64_t(100)),
+               torrent::input_error);
+}
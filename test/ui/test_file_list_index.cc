@@ -0,0 +1,234 @@
+#include <string>
+#include <vector>
+
+#include "test/ui/file_list_index_test.h"
+
+namespace {
+
+// Rows of a file list as FileListIterator walks them, each an
+// entering, file or leaving row at a depth. Leaving rows are one
+// level deeper than the directory's entering row, like the files in
+// it.
+struct fake_row {
+  char     type;
+  uint32_t depth;
+};
+
+using fake_tree = std::vector<fake_row>;
+
+// Steps like FileListIterator over a fake tree.
+class fake_iterator {
+public:
+  fake_iterator(const fake_tree* tree, uint32_t position)
+    : m_tree(tree)
+    , m_position(position) {}
+
+  uint32_t position() const {
+    return m_position;
+  }
+
+  uint32_t depth() const {
+    return row().depth;
+  }
+  bool is_entering() const {
+    return row().type == 'e';
+  }
+  bool is_file() const {
+    return row().type == 'f';
+  }
+
+  bool operator!=(const fake_iterator& other) const {
+    return m_position != other.m_position;
+  }
+
+  fake_iterator& operator++() {
+    m_position++;
+    return *this;
+  }
+  fake_iterator& operator--() {
+    m_position--;
+    return *this;
+  }
+
+  fake_iterator& forward_current_depth() {
+    uint32_t base = depth();
+
+    if (!is_entering())
+      return ++*this;
+
+    do {
+      ++*this;
+    } while (m_position != m_tree->size() && depth() > base);
+
+    return *this;
+  }
+
+  fake_iterator& backward_current_depth() {
+    --*this;
+
+    if (is_entering() || is_file())
+      return *this;
+
+    uint32_t base = depth();
+
+    while (depth() >= base)
+      --*this;
+
+    return *this;
+  }
+
+private:
+  const fake_row& row() const {
+    return (*m_tree)[m_position];
+  }
+
+  const fake_tree* m_tree;
+  uint32_t         m_position;
+};
+
+using index_type = ui::basic_file_list_index<fake_iterator>;
+
+index_type
+make_index(const fake_tree& tree) {
+  return index_type(fake_iterator(&tree, 0), fake_iterator(&tree, tree.size()));
+}
+
+// The rows visited from the first, moving forward until the end or
+// backward from the end.
+std::vector<uint32_t>
+walk_forward(const index_type& index, bool collapsed) {
+  std::vector<uint32_t> result;
+
+  for (uint32_t row = 0; row != index.size(); row = index.next(row, collapsed))
+    result.push_back(row);
+
+  return result;
+}
+
+std::vector<uint32_t>
+walk_backward(const index_type& index, bool collapsed) {
+  std::vector<uint32_t> result;
+
+  for (uint32_t row = index.size(); row != 0;)
+    result.push_back(row = index.prev(row, collapsed));
+
+  return result;
+}
+
+// a/x, a/b/y, a/b/z, c/w and v.
+const fake_tree tree = {
+  { 'e', 0 }, //  0: enter a
+  { 'f', 1 }, //  1: a/x
+  { 'e', 1 }, //  2: enter a/b
+  { 'f', 2 }, //  3: a/b/y
+  { 'f', 2 }, //  4: a/b/z
+  { 'l', 2 }, //  5: leave a/b
+  { 'l', 1 }, //  6: leave a
+  { 'e', 0 }, //  7: enter c
+  { 'f', 1 }, //  8: c/w
+  { 'l', 1 }, //  9: leave c
+  { 'f', 0 }, // 10: v
+};
+
+}
+
+TEST_F(FileListIndexTest, test_empty) {
+  fake_tree  empty;
+  index_type index = make_index(empty);
+
+  ASSERT_TRUE(index.empty());
+  ASSERT_EQ(index.size(), 0);
+  ASSERT_EQ(index.forward(0), 0);
+  ASSERT_EQ(index.backward(0), 0);
+}
+
+TEST_F(FileListIndexTest, test_rows) {
+  index_type index = make_index(tree);
+
+  ASSERT_EQ(index.size(), tree.size());
+
+  for (uint32_t row = 0; row != index.size(); row++)
+    ASSERT_EQ(index.at(row).position(), row);
+
+  ASSERT_EQ(index.at(index.size()).position(), tree.size());
+}
+
+TEST_F(FileListIndexTest, test_collapsed) {
+  index_type index = make_index(tree);
+
+  // Entering rows skip over the directory to the row following it at
+  // the same depth, while other rows step to the next one.
+  ASSERT_EQ(index.forward(0), 7);
+  ASSERT_EQ(index.forward(2), 6);
+  ASSERT_EQ(index.forward(3), 4);
+  ASSERT_EQ(index.forward(5), 6);
+  ASSERT_EQ(index.forward(7), 10);
+
+  // Stepping back over a directory lands on its entering row.
+  ASSERT_EQ(index.backward(7), 0);
+  ASSERT_EQ(index.backward(6), 2);
+  ASSERT_EQ(index.backward(3), 2);
+  ASSERT_EQ(index.backward(10), 7);
+
+  ASSERT_EQ(walk_forward(index, true), (std::vector<uint32_t>{ 0, 7, 10 }));
+  ASSERT_EQ(walk_backward(index, true), (std::vector<uint32_t>{ 10, 7, 0 }));
+}
+
+TEST_F(FileListIndexTest, test_expanded) {
+  index_type index = make_index(tree);
+
+  std::vector<uint32_t> rows;
+
+  for (uint32_t row = 0; row != tree.size(); row++)
+    rows.push_back(row);
+
+  ASSERT_EQ(walk_forward(index, false), rows);
+  ASSERT_EQ(walk_backward(index, false),
+            std::vector<uint32_t>(rows.rbegin(), rows.rend()));
+}
+
+TEST_F(FileListIndexTest, test_first_last) {
+  index_type index = make_index(tree);
+  uint32_t   last  = index.size() - 1;
+
+  // The last row leads to the end in both modes, and the end back to
+  // the last row.
+  ASSERT_EQ(index.next(last, true), index.size());
+  ASSERT_EQ(index.next(last, false), index.size());
+  ASSERT_EQ(index.prev(index.size(), true), last);
+  ASSERT_EQ(index.prev(index.size(), false), last);
+  ASSERT_EQ(index.forward(index.size()), index.size());
+
+  // Nothing comes before the first row.
+  ASSERT_EQ(index.backward(0), 0);
+  ASSERT_EQ(index.backward(1), 0);
+
+  // A tree ending in a directory ends on its leaving row.
+  fake_tree  nested = { { 'e', 0 }, { 'f', 1 }, { 'l', 1 } };
+  index_type other  = make_index(nested);
+
+  ASSERT_EQ(other.forward(0), 3);
+  ASSERT_EQ(other.backward(3), 0);
+  ASSERT_EQ(walk_forward(other, true), (std::vector<uint32_t>{ 0 }));
+}
+
+TEST_F(FileListIndexTest, test_toggle) {
+  index_type index = make_index(tree);
+
+  // Collapsing is a flag on the steps, so toggling it midway needs no
+  // rebuild and a rebuilt index gives the same steps.
+  uint32_t step = index.next(1, false);
+
+  ASSERT_EQ(step, 2);
+  ASSERT_EQ(step = index.next(step, true), 6);
+  ASSERT_EQ(step = index.next(step, false), 7);
+  ASSERT_EQ(step = index.prev(step, true), 0);
+  ASSERT_EQ(step = index.next(step, false), 1);
+
+  index_type rebuilt = make_index(tree);
+
+  for (uint32_t row = 0; row <= index.size(); row++) {
+    ASSERT_EQ(rebuilt.forward(row), index.forward(row));
+    ASSERT_EQ(rebuilt.backward(row), index.backward(row));
+  }
+}
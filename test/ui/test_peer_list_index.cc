@@ -0,0 +1,84 @@
+#include <vector>
+
+#include <torrent/exceptions.h>
+
+#include "test/ui/peer_list_index_test.h"
+
+namespace {
+
+// Only the addresses of the peers are used.
+char storage[5];
+
+torrent::Peer*
+peer(int n) {
+  return reinterpret_cast<torrent::Peer*>(storage + n);
+}
+
+std::vector<torrent::Peer*>
+peers(ui::PeerListIndex& index) {
+  return std::vector<torrent::Peer*>(index.list()->begin(),
+                                     index.list()->end());
+}
+
+}
+
+TEST_F(PeerListIndexTest, test_insert_erase) {
+  ui::PeerListIndex index;
+
+  for (int n = 0; n != 5; n++)
+    index.insert(peer(n));
+
+  ASSERT_EQ(index.size(), 5);
+  ASSERT_EQ(index.focused(), nullptr);
+  ASSERT_TRUE(index.has(peer(2)));
+
+  index.erase(peer(2));
+  index.erase(peer(0));
+  index.erase(peer(4));
+
+  ASSERT_EQ(peers(index), (std::vector<torrent::Peer*>{ peer(1), peer(3) }));
+  ASSERT_FALSE(index.has(peer(2)));
+  ASSERT_TRUE(index.has(peer(3)));
+
+  // Erased peers are gone from the position map too.
+  ASSERT_THROW(index.erase(peer(2)), torrent::internal_error);
+
+  index.insert(peer(2));
+  index.erase(peer(3));
+
+  ASSERT_EQ(peers(index), (std::vector<torrent::Peer*>{ peer(1), peer(2) }));
+
+  index.erase(peer(1));
+  index.erase(peer(2));
+
+  ASSERT_EQ(index.size(), 0);
+  ASSERT_FALSE(index.has(peer(1)));
+}
+
+TEST_F(PeerListIndexTest, test_focus) {
+  ui::PeerListIndex index;
+
+  for (int n = 0; n != 3; n++)
+    index.insert(peer(n));
+
+  // The end of the list, meaning no focus, is part of the cycle.
+  index.next();
+  ASSERT_EQ(index.focused(), peer(0));
+  index.prev();
+  ASSERT_EQ(index.focused(), nullptr);
+  index.prev();
+  ASSERT_EQ(index.focused(), peer(2));
+
+  // Erasing the focused peer moves the focus to the next one, others
+  // leave it alone.
+  index.prev();
+  index.erase(peer(0));
+  ASSERT_EQ(index.focused(), peer(1));
+
+  index.erase(peer(1));
+  ASSERT_EQ(index.focused(), peer(2));
+
+  index.erase(peer(2));
+  ASSERT_EQ(index.focused(), nullptr);
+  ASSERT_EQ(*index.focus(), index.list()->end());
+}
@@ -0,0 +1,83 @@
+#include <cstring>
+#include <memory>
+
+#include <torrent/object.h>
+
+#include "test/utils/bencode_decoder_test.h"
+
+static const char* test_torrent =
+  "d8:announce14:http://foo/bar4:infod6:lengthi-42e4:name3:abc"
+  "6:piecesl0:1:xeee";
+
+static void
+check_test_torrent(const torrent::Object& obj) {
+  ASSERT_TRUE(obj.is_map());
+  ASSERT_TRUE(obj.get_key("announce").as_string() == "http://foo/bar");
+
+  const torrent::Object& info = obj.get_key("info");
+
+  ASSERT_TRUE(info.get_key("length").as_value() == -42);
+  ASSERT_TRUE(info.get_key("name").as_string() == "abc");
+  ASSERT_TRUE(info.get_key("pieces").as_list().size() == 2);
+  ASSERT_TRUE(info.get_key("pieces").as_list().back().as_string() == "x");
+}
+
+TEST_F(BencodeDecoderTest, test_single_write) {
+  utils::BencodeDecoder decoder;
+
+  ASSERT_TRUE(decoder.write(test_torrent, std::strlen(test_torrent)));
+  ASSERT_TRUE(decoder.is_done());
+
+  std::unique_ptr<torrent::Object> obj(decoder.release());
+  check_test_torrent(*obj);
+}
+
+TEST_F(BencodeDecoderTest, test_split_writes) {
+  size_t length = std::strlen(test_torrent);
+
+  for (size_t step = 1; step < length; step++) {
+    utils::BencodeDecoder decoder;
+
+    for (size_t i = 0; i < length; i += step)
+      ASSERT_TRUE(
+        decoder.write(test_torrent + i, std::min(step, length - i)));
+
+    ASSERT_TRUE(decoder.is_done());
+
+    std::unique_ptr<torrent::Object> obj(decoder.release());
+    check_test_torrent(*obj);
+  }
+}
+
+TEST_F(BencodeDecoderTest, test_incomplete) {
+  utils::BencodeDecoder decoder;
+
+  ASSERT_TRUE(decoder.write(test_torrent, 20));
+  ASSERT_FALSE(decoder.is_done());
+  ASSERT_FALSE(decoder.is_error());
+}
+
+TEST_F(BencodeDecoderTest, test_invalid) {
+  const char* invalid[] = { "x", "i-e", "ie", "i1", "d1:ae", "dx", "3x" };
+
+  for (auto input : invalid) {
+    utils::BencodeDecoder decoder;
+
+    decoder.write(input, std::strlen(input));
+    ASSERT_FALSE(decoder.is_done()) << input;
+  }
+}
+
+TEST_F(BencodeDecoderTest, test_size_limit) {
+  utils::BencodeDecoder decoder(16);
+
+  // The string length alone exceeds the limit.
+  ASSERT_FALSE(decoder.write("d4:name100:", 11));
+  ASSERT_TRUE(decoder.is_error());
+
+  utils::BencodeDecoder total(16);
+
+  ASSERT_TRUE(total.write("d4:name5:abcde", 14));
+  ASSERT_FALSE(total.write("4:test", 6));
+  ASSERT_TRUE(total.is_error());
+}
@@ -0,0 +1,45 @@
+#include "test/utils/latency_histogram_test.h"
+
+using utils::LatencyHistogram;
+
+TEST_F(LatencyHistogramTest, test_bucket_bounds) {
+  // Every value must land in a bucket whose upper bound is at least
+  // the value, and within 12.5% of it.
+  for (uint64_t value = 0; value != 1 << 20; value++) {
+    uint64_t upper = LatencyHistogram::bucket_upper(
+      LatencyHistogram::bucket_index(value));
+
+    ASSERT_GE(upper, value);
+    ASSERT_LE(upper - value, value / LatencyHistogram::sub_count);
+  }
+
+  for (uint32_t index = 1; index != LatencyHistogram::size; index++)
+    ASSERT_LT(LatencyHistogram::bucket_upper(index - 1),
+              LatencyHistogram::bucket_upper(index));
+
+  ASSERT_EQ(LatencyHistogram::bucket_index(~uint64_t()),
+            LatencyHistogram::size - 1);
+}
+
+TEST_F(LatencyHistogramTest, test_percentile) {
+  LatencyHistogram histogram;
+
+  ASSERT_EQ(histogram.percentile(50), 0);
+
+  for (uint64_t value = 1; value <= 1000; value++)
+    histogram.insert(value);
+
+  ASSERT_EQ(histogram.count(), 1000);
+  ASSERT_EQ(histogram.sum(), 500500);
+  ASSERT_EQ(histogram.max(), 1000);
+
+  ASSERT_GE(histogram.percentile(50), 500);
+  ASSERT_LE(histogram.percentile(50), 500 + 500 / 8);
+  ASSERT_GE(histogram.percentile(99), 990);
+  ASSERT_EQ(histogram.percentile(100), 1000);
+
+  histogram.clear();
+
+  ASSERT_EQ(histogram.count(), 0);
+  ASSERT_EQ(histogram.percentile(99), 0);
+}
@@ -0,0 +1,80 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "test/utils/mpsc_queue_test.h"
+
+TEST_F(MpscQueueTest, test_capacity) {
+  ASSERT_EQ(utils::MpscQueue<int>(1).capacity(), 2);
+  ASSERT_EQ(utils::MpscQueue<int>(32).capacity(), 32);
+  ASSERT_EQ(utils::MpscQueue<int>(33).capacity(), 64);
+}
+
+TEST_F(MpscQueueTest, test_fifo) {
+  utils::MpscQueue<int> queue(4);
+  int                   value;
+
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.pop(value));
+
+  for (int round = 0; round != 3; round++) {
+    for (int i = 0; i != 4; i++)
+      ASSERT_TRUE(queue.push(round * 10 + i));
+
+    ASSERT_FALSE(queue.push(-1));
+    ASSERT_FALSE(queue.empty());
+
+    for (int i = 0; i != 4; i++) {
+      ASSERT_TRUE(queue.pop(value));
+      ASSERT_EQ(value, round * 10 + i);
+    }
+
+    ASSERT_TRUE(queue.empty());
+  }
+}
+
+TEST_F(MpscQueueTest, test_move_only) {
+  utils::MpscQueue<std::unique_ptr<int>> queue(2);
+  std::unique_ptr<int>                   value;
+
+  ASSERT_TRUE(queue.push(std::make_unique<int>(7)));
+  ASSERT_TRUE(queue.pop(value));
+  ASSERT_EQ(*value, 7);
+}
+
+TEST_F(MpscQueueTest, test_concurrent_producers) {
+  constexpr int producers = 4;
+  constexpr int items     = 20000;
+
+  utils::MpscQueue<int>    queue(64);
+  std::vector<std::thread> threads;
+
+  for (int p = 0; p != producers; p++)
+    threads.emplace_back([&queue, p] {
+      for (int i = 0; i != items; i++)
+        while (!queue.push(p * items + i))
+          std::this_thread::yield();
+    });
+
+  // Items from each producer must arrive in the order pushed.
+  std::vector<int> next(producers, 0);
+  int              value;
+
+  for (int received = 0; received != producers * items;) {
+    if (!queue.pop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    int p = value / items;
+
+    ASSERT_EQ(value % items, next[p]);
+    next[p]++;
+    received++;
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  ASSERT_TRUE(queue.empty());
+}
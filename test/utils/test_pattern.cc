@@ -0,0 +1,165 @@
+#include "test/utils/pattern_test.h"
+
+#include <chrono>
+#include <iostream>
+
+using utils::Pattern;
+
+namespace {
+
+std::vector<std::string>
+make_corpus(size_t count) {
+  static const char* words[] = { "ubuntu", "debian", "Linux",  "iso",
+                                 "x86_64", "amd64",  "1080p",  "mkv",
+                                 "a",      "aaaa",   "b",      "2024",
+                                 "",       "\n",     "release" };
+
+  std::vector<std::string> corpus;
+  uint32_t                 seed = 1;
+
+  for (size_t i = 0; i != count; i++) {
+    std::string name;
+
+    for (int j = 0, words_count = 1 + i % 5; j != words_count; j++) {
+      seed = seed * 1103515245 + 12345;
+
+      if (j != 0)
+        name += ".-_ "[(seed >> 8) % 4];
+
+      name += words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+    }
+
+    corpus.push_back(name);
+  }
+
+  return corpus;
+}
+
+}
+
+TEST_F(PatternTest, test_types) {
+  ASSERT_EQ(Pattern("ubuntu").type(), Pattern::TYPE_EXACT);
+  ASSERT_EQ(Pattern("^ubuntu$").type(), Pattern::TYPE_EXACT);
+  ASSERT_EQ(Pattern("ubuntu.*").type(), Pattern::TYPE_PREFIX);
+  ASSERT_EQ(Pattern(".*ubuntu").type(), Pattern::TYPE_SUFFIX);
+  ASSERT_EQ(Pattern(".*ubuntu\\.iso.*").type(), Pattern::TYPE_CONTAINS);
+  ASSERT_EQ(Pattern(".*(ubuntu|debian).*").type(), Pattern::TYPE_NFA);
+  ASSERT_EQ(Pattern("(a)\\1").type(), Pattern::TYPE_REGEX);
+  ASSERT_EQ(Pattern("\\bx").type(), Pattern::TYPE_REGEX);
+
+  Pattern invalid("(ubuntu");
+
+  ASSERT_FALSE(invalid.is_valid());
+  ASSERT_FALSE(invalid.error().empty());
+  ASSERT_FALSE(invalid.match("ubuntu"));
+}
+
+TEST_F(PatternTest, test_same_as_regex) {
+  static const char* patterns[] = {
+    "",
+    ".*",
+    "ubuntu",
+    "^ubuntu.*$",
+    ".*iso",
+    ".*linux.*",
+    ".*\\.iso.*",
+    ".*\n.*",
+    ".*(ubuntu|debian).*",
+    "(a|aa)*",
+    "(a*)*b",
+    "a{2,3}.*",
+    ".*a{2}.*",
+    "a{2,}",
+    ".*[0-9]{4}.*",
+    "[^.]*\\..*",
+    ".*\\d+p.*",
+    "\\w+[-_ .]\\w+",
+    "\\S*\\s.*",
+    ".*[a-c\\d].*",
+    "(?:ubuntu|linux)[._ -](.*)",
+    "x?(a+?)",
+    "^$",
+    "a|^b.*|.*c$",
+    ".*\\x41.*",
+    "[\\]a]*",
+    ".*[-a].*",
+  };
+
+  auto corpus = make_corpus(2000);
+  corpus.push_back("ab\n");
+  corpus.push_back("\nlinux");
+  corpus.push_back("x\n\ny");
+
+  for (const char* source : patterns) {
+    Pattern    pattern(source);
+    std::regex regex(source);
+
+    ASSERT_TRUE(pattern.is_valid()) << source;
+
+    for (const auto& text : corpus)
+      ASSERT_EQ(pattern.match(text), std::regex_match(text, regex))
+        << "pattern '" << source << "' text '" << text << "'";
+  }
+}
+
+TEST_F(PatternTest, test_linear_time) {
+  // Exponential for a backtracking matcher.
+  Pattern     pattern("(a|a)*(a|a)*(a|a)*b");
+  std::string text(10000, 'a');
+
+  ASSERT_EQ(pattern.type(), Pattern::TYPE_NFA);
+  ASSERT_FALSE(pattern.match(text));
+  ASSERT_TRUE(pattern.match(text + "b"));
+}
+
+TEST_F(PatternTest, test_cache) {
+  utils::PatternCache cache;
+  bool                compiled = false;
+
+  const Pattern* first = &cache.find(".*iso.*", &compiled);
+  ASSERT_TRUE(compiled);
+  ASSERT_EQ(&cache.find(".*iso.*", &compiled), first);
+  ASSERT_FALSE(compiled);
+
+  for (size_t i = 0; i != utils::PatternCache::max_size; i++)
+    cache.find(std::to_string(i));
+
+  ASSERT_LE(cache.size(), utils::PatternCache::max_size);
+}
+
+// Run with --gtest_also_run_disabled_tests to compare against
+// compiling a std::regex per download, as 'match' used to do.
+TEST_F(PatternTest, DISABLED_benchmark_corpus) {
+  static const char* patterns[] = {
+    ".*ubuntu.*", ".*(1080p|2024).*", ".*\\d{4}.*", "linux.*iso"
+  };
+
+  auto corpus = make_corpus(100000);
+
+  for (const char* source : patterns) {
+    auto   start   = std::chrono::steady_clock::now();
+    size_t matches = 0;
+
+    for (const auto& text : corpus)
+      matches += utils::patternCache.find(source).match(text);
+
+    auto   middle       = std::chrono::steady_clock::now();
+    size_t regexMatches = 0;
+
+    for (const auto& text : corpus)
+      regexMatches += std::regex_match(text, std::regex(source));
+
+    auto end = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(matches, regexMatches);
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::cout << source << ": pattern "
+              << duration_cast<microseconds>(middle - start).count()
+              << " us, std::regex "
+              << duration_cast<microseconds>(end - middle).count() << " us"
+              << std::endl;
+  }
+}
@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "test/utils/trace_ring_test.h"
+
+TEST_F(TraceRingTest, test_push) {
+  auto ring = std::make_unique<utils::TraceRing>();
+
+  ASSERT_TRUE(ring->snapshot().empty());
+
+  ring->push(utils::TRACE_RPC_READ, 3, 100, 1);
+  ring->push(utils::TRACE_RPC_WRITE, 3, 200);
+
+  auto records = ring->snapshot();
+
+  ASSERT_EQ(records.size(), 2);
+  ASSERT_EQ(records[0].event, utils::TRACE_RPC_READ);
+  ASSERT_EQ(records[0].args[1], 100);
+  ASSERT_EQ(records[0].args[2], 1);
+  ASSERT_EQ(records[1].event, utils::TRACE_RPC_WRITE);
+  ASSERT_EQ(records[1].args[1], 200);
+  ASSERT_EQ(records[1].args[2], 0);
+}
+
+TEST_F(TraceRingTest, test_wrap_around) {
+  auto ring = std::make_unique<utils::TraceRing>();
+
+  for (int64_t i = 0; i != utils::TraceRing::size + 10; i++)
+    ring->push(utils::TRACE_EXECUTE, i);
+
+  auto records = ring->snapshot();
+
+  ASSERT_EQ(ring->position(), utils::TraceRing::size + 10);
+  ASSERT_EQ(records.size(), utils::TraceRing::size);
+  ASSERT_EQ(records.front().args[0], 10);
+  ASSERT_EQ(records.back().args[0], utils::TraceRing::size + 9);
+}
+
+TEST_F(TraceRingTest, test_dump) {
+  auto ring = std::make_unique<utils::TraceRing>();
+
+  ring->push(utils::TRACE_DOWNLOAD_HASH, 42, 1);
+
+  char*  buffer = nullptr;
+  size_t length = 0;
+  FILE*  file   = open_memstream(&buffer, &length);
+
+  ring->dump(file);
+  fclose(file);
+
+  // Header, event names and a single record.
+  ASSERT_EQ(std::memcmp(buffer, "RTTRACE", 8), 0);
+  ASSERT_EQ(std::memcmp(buffer + length - sizeof(utils::TraceRing::record_type),
+                        &ring->snapshot().front(),
+                        sizeof(utils::TraceRing::record_type)),
+            0);
+
+  free(buffer);
+}
+
+TEST_F(TraceRingTest, test_event_name) {
+  ASSERT_STREQ(utils::trace_event_name(utils::TRACE_RPC_READ), "rpc_read");
+  ASSERT_STREQ(utils::trace_event_name(utils::TRACE_EVENT_MAX), "unknown");
+}
@@ -0,0 +1,103 @@
+#include "test/utils/trigram_index_test.h"
+
+#include <algorithm>
+#include <map>
+
+using utils::TrigramIndex;
+
+namespace {
+
+using document_map = std::map<TrigramIndex::id_type, TrigramIndex::text_list>;
+
+std::vector<TrigramIndex::id_type>
+brute_force(const document_map& docs, std::string query) {
+  std::vector<TrigramIndex::id_type> result;
+
+  std::transform(query.begin(), query.end(), query.begin(), ::tolower);
+
+  for (const auto& [id, texts] : docs)
+    for (auto text : texts) {
+      std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+
+      if (text.find(query) != std::string::npos) {
+        result.push_back(id);
+        break;
+      }
+    }
+
+  return result;
+}
+
+}
+
+TEST_F(TrigramIndexTest, test_search) {
+  TrigramIndex index;
+
+  auto ubuntu = index.insert({ "Ubuntu-24.04-desktop-amd64.iso" });
+  auto debian = index.insert({ "debian-12", "debian-12/amd64/disk1.iso" });
+
+  ASSERT_EQ(index.size(), 2);
+  ASSERT_EQ(index.search("UBUNTU"),
+            std::vector<TrigramIndex::id_type>{ ubuntu });
+  ASSERT_EQ(index.search("amd64"),
+            (std::vector<TrigramIndex::id_type>{ ubuntu, debian }));
+  ASSERT_EQ(index.search(".iso"),
+            (std::vector<TrigramIndex::id_type>{ ubuntu, debian }));
+  ASSERT_EQ(index.search("12/"), std::vector<TrigramIndex::id_type>{ debian });
+  ASSERT_EQ(index.search("a"),
+            (std::vector<TrigramIndex::id_type>{ ubuntu, debian }));
+  ASSERT_EQ(index.search(""),
+            (std::vector<TrigramIndex::id_type>{ ubuntu, debian }));
+  ASSERT_TRUE(index.search("fedora").empty());
+
+  // All trigrams present, but not in sequence.
+  ASSERT_TRUE(index.search("deb12").empty());
+  ASSERT_TRUE(index.search("64.iso-12").empty());
+
+  index.erase(ubuntu);
+
+  ASSERT_EQ(index.size(), 1);
+  ASSERT_TRUE(index.search("ubuntu").empty());
+  ASSERT_EQ(index.insert({ "arch" }), ubuntu);
+  ASSERT_EQ(index.search("arc"), std::vector<TrigramIndex::id_type>{ ubuntu });
+}
+
+TEST_F(TrigramIndexTest, test_same_as_scan) {
+  static const char* words[] = { "linux", "ISO", "x86", "season", "s01e01",
+                                 "720p",  "aaa", "ab",  "/",      "." };
+
+  TrigramIndex index;
+  document_map docs;
+  uint32_t     seed = 7;
+
+  auto random = [&seed](uint32_t range) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % range;
+  };
+
+  for (int round = 0; round != 2000; round++) {
+    if (!docs.empty() && random(3) == 0) {
+      auto itr = std::next(docs.begin(), random(docs.size()));
+
+      index.erase(itr->first);
+      docs.erase(itr);
+      continue;
+    }
+
+    TrigramIndex::text_list texts(1 + random(3));
+
+    for (auto& text : texts)
+      for (uint32_t i = 0, count = 1 + random(4); i != count; i++)
+        text += words[random(sizeof(words) / sizeof(words[0]))];
+
+    auto id = index.insert(texts);
+
+    ASSERT_TRUE(docs.emplace(id, texts).second);
+  }
+
+  ASSERT_EQ(index.size(), docs.size());
+
+  for (const char* query :
+       { "linux", "iso", "ISOx8", "aaaa", "aab", "p/", "e01", "ab.", "x" })
+    ASSERT_EQ(index.search(query), brute_force(docs, query)) << query;
+}